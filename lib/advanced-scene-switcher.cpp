@@ -1,6 +1,7 @@
 #include "advanced-scene-switcher.hpp"
 #include "backup.hpp"
 #include "crash-handler.hpp"
+#include "environment-snapshot.hpp"
 #include "log-helper.hpp"
 #include "macro-helpers.hpp"
 #include "obs-module-helper.hpp"
@@ -24,6 +25,7 @@
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QTextStream>
+#include <algorithm>
 #include <regex>
 
 #ifdef _WIN32
@@ -217,6 +219,25 @@ static void SaveSceneSwitcher(obs_data_t *save_data, bool saving, void *)
 /******************************************************************************
  * Main switcher thread
  ******************************************************************************/
+// Macros using a custom condition check interval might be due to be checked
+// before the regular check interval has passed
+static std::chrono::milliseconds
+limitToNextScheduledMacroCheck(const std::chrono::milliseconds &duration)
+{
+	const auto nextCheck = GetNextScheduledMacroCheckTime();
+	if (!nextCheck) {
+		return duration;
+	}
+	const auto timeUntilNextCheck =
+		std::chrono::ceil<std::chrono::milliseconds>(
+			*nextCheck - std::chrono::high_resolution_clock::now());
+	// Due times in the past will be handled by the regular check
+	if (timeUntilNextCheck.count() <= 0) {
+		return duration;
+	}
+	return std::min(timeUntilNextCheck, duration);
+}
+
 void SwitcherData::Thread()
 {
 	blog(LOG_INFO, "started");
@@ -225,6 +246,8 @@ void SwitcherData::Thread()
 	std::chrono::milliseconds duration;
 	auto startTime = std::chrono::high_resolution_clock::now();
 	auto endTime = std::chrono::high_resolution_clock::now();
+	auto nextRegularCheckTime = std::chrono::high_resolution_clock::now();
+	bool partialCheckOnly = false;
 	switcher->firstIntervalAfterStop = true;
 
 	while (true) {
@@ -239,13 +262,20 @@ void SwitcherData::Thread()
 		bool setPrevSceneAfterLinger = false;
 		bool macroMatch = false;
 		endTime = std::chrono::high_resolution_clock::now();
-		auto runTime =
-			std::chrono::duration_cast<std::chrono::milliseconds>(
-				endTime - startTime);
 
-		if (sleep) {
+		if (partialCheckOnly) {
+			// Keep the regular check interval unaffected by the
+			// checks of macros using a custom check interval or
+			// with pending messages
+			duration = std::max(
+				std::chrono::ceil<std::chrono::milliseconds>(
+					nextRegularCheckTime - endTime),
+				std::chrono::milliseconds(0));
+		} else if (sleep) {
 			duration = std::chrono::milliseconds(sleep);
 		} else {
+			auto runTime = std::chrono::duration_cast<
+				std::chrono::milliseconds>(endTime - startTime);
 			duration = std::chrono::milliseconds(interval) +
 				   std::chrono::milliseconds(linger) - runTime;
 			if (duration.count() < 1) {
@@ -254,20 +284,45 @@ void SwitcherData::Thread()
 				duration = std::chrono::milliseconds(10);
 			}
 		}
+		if (!partialCheckOnly) {
+			nextRegularCheckTime = endTime + duration;
+		}
 
+		const auto waitDuration =
+			limitToNextScheduledMacroCheck(duration);
 		vblog(LOG_INFO, "try to sleep for %ld",
-		      (long int)duration.count());
+		      (long int)waitDuration.count());
 		SetWaitScene();
-		cv.wait_for(lock, duration);
-
-		startTime = std::chrono::high_resolution_clock::now();
-		sleep = 0;
-		linger = 0;
+		const bool wokenUp = WaitForNextCheck(lock, waitDuration);
+		// Wakeups due to new messages or macros using a custom check
+		// interval do not require all conditions to be checked
+		partialCheckOnly = (wokenUp || waitDuration < duration) &&
+				   !SceneChangedDuringWait();
 
 		Prune();
 		if (stop) {
 			break;
 		}
+
+		if (partialCheckOnly) {
+			// Only the macros which are due to be checked or have
+			// pending messages are checked instead of all macros
+			// and legacy switchers
+			if (checkPause()) {
+				ClearNextScheduledMacroCheckTime();
+				continue;
+			}
+			EnvironmentSnapshot::Get().Invalidate();
+			CheckAndRunScheduledMacros(wokenUp);
+			continue;
+		}
+
+		startTime = std::chrono::high_resolution_clock::now();
+		sleep = 0;
+		linger = 0;
+
+		// Will be set again if the macros are checked
+		ClearNextScheduledMacroCheckTime();
 		if (checkPause()) {
 			continue;
 		}
@@ -285,8 +340,11 @@ void SwitcherData::Thread()
 			vblog(LOG_INFO, "sleep for %ld before switching scene",
 			      (long int)duration.count());
 
+			// Wakeup requests must not cut the linger short
 			SetWaitScene();
-			cv.wait_for(lock, duration);
+			cv.wait_for(lock, duration, [this]() {
+				return stop || SceneChangedDuringWait();
+			});
 
 			if (stop) {
 				break;
@@ -322,11 +380,75 @@ void SwitcherData::Thread()
 	blog(LOG_INFO, "stopped");
 }
 
+// Can be called from any thread to request the conditions to be checked
+// before the regular interval has elapsed, e.g. when a new message arrived.
+// Only the first request per interval will notify the main loop.
+void SwitcherData::RequestWakeup()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeupMutex);
+		if (wakeupRequested) {
+			return;
+		}
+		wakeupRequested = true;
+	}
+	wakeupCv.notify_one();
+}
+
+// Ends any wait of the main loop early, e.g. when the plugin is stopped
+void SwitcherData::InterruptWait()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeupMutex);
+		waitInterrupted = true;
+	}
+	wakeupCv.notify_all();
+	cv.notify_all();
+}
+
+bool SwitcherData::WaitForNextCheck(std::unique_lock<std::mutex> &lock,
+				    const std::chrono::milliseconds &duration)
+{
+	bool wokenUp = false;
+	lock.unlock();
+	{
+		std::unique_lock<std::mutex> wakeupLock(wakeupMutex);
+		// Only interruptions during the wait itself are relevant
+		waitInterrupted = false;
+		wakeupCv.wait_for(wakeupLock, duration, [this]() {
+			return stop || wakeupRequested || waitInterrupted;
+		});
+		wokenUp = wakeupRequested;
+		wakeupRequested = false;
+	}
+	lock.lock();
+
+	if (!stop && wokenUp) {
+		// Rate limit the wakeups to avoid constantly checking all
+		// conditions when a large number of messages is received
+		const auto timeSinceLastCheck =
+			std::chrono::high_resolution_clock::now() -
+			lastCheckTime;
+		if (timeSinceLastCheck < min_wakeup_check_spacing) {
+			cv.wait_for(lock,
+				    min_wakeup_check_spacing -
+					    timeSinceLastCheck,
+				    [this]() { return stop; });
+		}
+	}
+
+	lastCheckTime = std::chrono::high_resolution_clock::now();
+	return wokenUp;
+}
+
 void SwitcherData::SetPreconditions()
 {
+	// Query the environment at most once per interval
+	EnvironmentSnapshot::Get().Invalidate();
+
 	// Window title
 	lastTitle = currentTitle;
-	auto title = GetCurrentWindowTitle();
+	auto title = EnvironmentSnapshot::Get().GetCurrentWindowTitle();
 	for (auto &window : ignoreWindowsSwitches) {
 		bool equals = (title == window);
 		bool matches = false;
@@ -346,7 +468,8 @@ void SwitcherData::SetPreconditions()
 	currentTitle = title;
 
 	// Process name
-	currentForegroundProcess = GetForegroundProcessName();
+	currentForegroundProcess =
+		EnvironmentSnapshot::Get().GetForegroundProcessName();
 
 	// Macro
 	InvalidateMacroTempVarValues();
@@ -457,7 +580,7 @@ void SwitcherData::Stop()
 {
 	if (th && th->isRunning()) {
 		stop = true;
-		cv.notify_all();
+		InterruptWait();
 		SetMacroAbortWait(true);
 		GetMacroWaitCV().notify_all();
 		GetMacroTransitionCV().notify_all();
@@ -524,7 +647,7 @@ static void handleSceneChange()
 {
 	// Stop waiting if scene was changed
 	if (switcher->SceneChangedDuringWait()) {
-		switcher->cv.notify_one();
+		switcher->InterruptWait();
 	}
 
 	// Set current and previous scene
@@ -296,7 +296,6 @@ signals:
 
 	/* --- End of legacy tab section --- */
 private:
-	void SetCheckIntervalTooLowVisibility() const;
 };
 
 void OpenSettingsWindow();
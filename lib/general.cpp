@@ -14,6 +14,7 @@
 #include "status-control.hpp"
 #include "switcher-data.hpp"
 #include "tab-helpers.hpp"
+#include "thread-pool.hpp"
 #include "ui-helpers.hpp"
 #include "variable.hpp"
 #include "version.h"
@@ -23,6 +24,7 @@
 #include <QFileDialog>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QSpinBox>
 
 namespace advss {
 
@@ -135,8 +137,6 @@ void AdvSceneSwitcher::on_checkInterval_valueChanged(int value)
 
 	std::lock_guard<std::mutex> lock(switcher->m);
 	switcher->interval = value;
-
-	SetCheckIntervalTooLowVisibility();
 }
 
 void AdvSceneSwitcher::closeEvent(QCloseEvent *)
@@ -636,6 +636,9 @@ void SwitcherData::SaveGeneralSettings(obs_data_t *obj)
 	SaveFunctionPriorities(obj, functionNamesByPriority);
 
 	obs_data_set_int(obj, "threadPriority", threadPriority);
+	obs_data_set_int(obj, "conditionCheckThreadCount",
+			 conditionCheckThreadCount);
+	obs_data_set_int(obj, "actionRunThreadCount", actionRunThreadCount);
 
 	obs_data_set_bool(obj, "transitionOverrideOverride",
 			  transitionOverrideOverride);
@@ -645,6 +648,23 @@ void SwitcherData::SaveGeneralSettings(obs_data_t *obj)
 	obs_data_set_string(obj, "lastImportPath", lastImportPath.c_str());
 }
 
+static void applyThreadCounts(void *)
+{
+	if (!switcher) {
+		return;
+	}
+
+	int conditionCheckThreadCount = 0;
+	int actionRunThreadCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(switcher->m);
+		conditionCheckThreadCount = switcher->conditionCheckThreadCount;
+		actionRunThreadCount = switcher->actionRunThreadCount;
+	}
+	GetConditionCheckThreadPool().SetThreadCount(conditionCheckThreadCount);
+	GetActionRunThreadPool().SetThreadCount(actionRunThreadCount);
+}
+
 void SwitcherData::LoadGeneralSettings(obs_data_t *obj)
 {
 	obs_data_set_default_int(obj, "interval", default_interval);
@@ -715,6 +735,12 @@ void SwitcherData::LoadGeneralSettings(obs_data_t *obj)
 	obs_data_set_default_int(obj, "threadPriority",
 				 QThread::NormalPriority);
 	threadPriority = obs_data_get_int(obj, "threadPriority");
+	conditionCheckThreadCount =
+		obs_data_get_int(obj, "conditionCheckThreadCount");
+	actionRunThreadCount = obs_data_get_int(obj, "actionRunThreadCount");
+	// Settings are loaded while holding the main lock, which tasks running
+	// on the thread pools might be waiting for
+	QueueUITask(applyThreadCounts, nullptr);
 
 	transitionOverrideOverride =
 		obs_data_get_bool(obj, "transitionOverrideOverride");
@@ -909,6 +935,82 @@ static void populateThreadPriorityList(QComboBox *list)
 	}
 }
 
+static QLayout *createThreadPoolControls(const std::string &localePrefix,
+					 ThreadPool &pool,
+					 int &threadCountSetting)
+{
+	auto threadCount = new QSpinBox();
+	threadCount->setMinimum(0);
+	threadCount->setMaximum(256);
+	threadCount->setSpecialValueText(obs_module_text(
+		"AdvSceneSwitcher.generalTab.priority.threadCount.auto"));
+	threadCount->setValue(threadCountSetting);
+	threadCount->setToolTip(
+		obs_module_text((localePrefix + ".tooltip").c_str()));
+
+	// Only resize the pool once the user stopped changing the value
+	auto applyTimer = new QTimer(threadCount);
+	applyTimer->setSingleShot(true);
+	applyTimer->setInterval(500);
+	QWidget::connect(threadCount,
+			 QOverload<int>::of(&QSpinBox::valueChanged),
+			 [applyTimer]() { applyTimer->start(); });
+	QWidget::connect(
+		applyTimer, &QTimer::timeout,
+		[threadCount, &pool, &threadCountSetting]() {
+			const int value = threadCount->value();
+			{
+				std::lock_guard<std::mutex> lock(switcher->m);
+				threadCountSetting = value;
+			}
+			// Tasks running on the pool might be waiting for the
+			// main lock
+			pool.SetThreadCount(value);
+		});
+
+	auto stats = new QLabel();
+	const auto updateStats = [stats, &pool]() {
+		const auto poolStats = pool.GetStats();
+		stats->setText(
+			QString(obs_module_text(
+					"AdvSceneSwitcher.generalTab.priority.threadCount.stats"))
+				.arg(poolStats.threadCount)
+				.arg(poolStats.queued)
+				.arg(poolStats.running)
+				.arg(poolStats.stolen)
+				.arg(poolStats.rejected));
+	};
+	updateStats();
+	auto timer = new QTimer(stats);
+	timer->setInterval(1000);
+	QObject::connect(timer, &QTimer::timeout, updateStats);
+	timer->start();
+
+	auto layout = new QHBoxLayout();
+	layout->addWidget(new QLabel(obs_module_text(localePrefix.c_str())));
+	layout->addWidget(threadCount);
+	layout->addWidget(stats);
+	layout->addStretch();
+	return layout;
+}
+
+static void setupThreadPoolControls(QBoxLayout *layout, QWidget *insertAfter)
+{
+	int idx = layout->indexOf(insertAfter) + 1;
+	layout->insertLayout(
+		idx++,
+		createThreadPoolControls(
+			"AdvSceneSwitcher.generalTab.priority.conditionCheckThreadCount",
+			GetConditionCheckThreadPool(),
+			switcher->conditionCheckThreadCount));
+	layout->insertLayout(
+		idx,
+		createThreadPoolControls(
+			"AdvSceneSwitcher.generalTab.priority.actionRunThreadCount",
+			GetActionRunThreadPool(),
+			switcher->actionRunThreadCount));
+}
+
 static bool isGeneralTab(const QString &name)
 {
 	return name == obs_module_text("AdvSceneSwitcher.generalTab.title");
@@ -944,28 +1046,6 @@ static void setupGeneralTabInactiveWarning(QTabWidget *tabs)
 	inactiveTimer->start();
 }
 
-void AdvSceneSwitcher::SetCheckIntervalTooLowVisibility() const
-{
-	auto macro = GetMacroWithInvalidConditionInterval();
-	if (!macro) {
-		ui->checkIntervalTooLowWarning->hide();
-		return;
-	}
-
-	const QString labelTextFormat(obs_module_text(
-		"AdvSceneSwitcher.generalTab.status.checkIntervalTooLow"));
-	const QString labelTooltipFormat(obs_module_text(
-		"AdvSceneSwitcher.generalTab.status.checkIntervalTooLow.tooltip"));
-	const QString name = QString::fromStdString(macro->Name());
-	const QString duration = QString::fromStdString(
-		macro->GetCustomConditionCheckInterval().ToString());
-
-	ui->checkIntervalTooLowWarning->setText(labelTextFormat.arg(name));
-	ui->checkIntervalTooLowWarning->setToolTip(
-		labelTooltipFormat.arg(name).arg(duration).arg(name));
-	ui->checkIntervalTooLowWarning->show();
-}
-
 void AdvSceneSwitcher::SetupGeneralTab()
 {
 	if (switcher->switchIfNotMatching == NoMatchBehavior::SWITCH) {
@@ -1001,7 +1081,6 @@ void AdvSceneSwitcher::SetupGeneralTab()
 			 SLOT(NoMatchDelayDurationChanged(const Duration &)));
 
 	ui->checkInterval->setValue(switcher->interval);
-	SetCheckIntervalTooLowVisibility();
 
 	ui->enableCooldown->setChecked(switcher->enableCooldown);
 	ui->cooldownTime->setEnabled(switcher->enableCooldown);
@@ -1031,6 +1110,7 @@ void AdvSceneSwitcher::SetupGeneralTab()
 
 	populatePriorityFunctionList(ui->priorityList);
 	populateThreadPriorityList(ui->threadPriority);
+	setupThreadPoolControls(ui->verticalLayout_16, ui->label_57);
 
 	populateStartupBehavior(ui->startupBehavior);
 	ui->startupBehavior->setCurrentIndex(
@@ -1,4 +1,5 @@
 #include "advanced-scene-switcher.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
 #include "selection-helpers.hpp"
@@ -96,7 +97,8 @@ bool SwitcherData::checkExeSwitch(OBSWeakSource &scene,
 	bool match = false;
 
 	// Check for match
-	const auto runningProcesses = GetProcessList();
+	const auto runningProcesses =
+		EnvironmentSnapshot::Get().GetProcessList();
 	for (ExecutableSwitch &s : executableSwitches) {
 		if (!s.initialized()) {
 			continue;
@@ -105,7 +107,8 @@ bool SwitcherData::checkExeSwitch(OBSWeakSource &scene,
 		bool equals = runningProcesses.contains(s.exe);
 		bool matches = (runningProcesses.indexOf(
 					QRegularExpression(s.exe)) != -1);
-		bool focus = (!s.inFocus || IsInFocus(s.exe));
+		bool focus = (!s.inFocus ||
+			      EnvironmentSnapshot::Get().IsInFocus(s.exe));
 
 		// True if current window is ignored AND switch equals OR matches last window
 		bool ignore =
@@ -1,5 +1,6 @@
 #include "advanced-scene-switcher.hpp"
 #include "curl-helper.hpp"
+#include "curl-request-engine.hpp"
 #include "layout-helpers.hpp"
 #include "source-helpers.hpp"
 #include "switcher-data.hpp"
@@ -13,7 +14,6 @@
 #include <QDateTime>
 #include <functional>
 #include <regex>
-#include <curl/curl.h>
 
 namespace advss {
 
@@ -175,30 +175,12 @@ bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
 	return match;
 }
 
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
-{
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
 static std::string getRemoteData(std::string &url)
 {
-	std::string readBuffer;
-
-	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &readBuffer);
-
-	// Set timeout to at least one second
-	int timeout = switcher->interval / 1000;
-	if (timeout == 0) {
-		timeout = 1;
-	}
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT, 1);
-	CurlHelper::Perform();
-
-	return readBuffer;
+	CurlRequest request;
+	request.url = url;
+	request.timeout = std::chrono::seconds(1);
+	return GetCurlRequestEngine().Perform(std::move(request)).body;
 }
 
 bool matchFileContent(QString &filedata, FileSwitch &s)
@@ -1,4 +1,5 @@
 #include "advanced-scene-switcher.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
 #include "selection-helpers.hpp"
@@ -44,7 +45,8 @@ bool SwitcherData::checkIdleSwitch(OBSWeakSource &scene,
 		}
 	}
 
-	if (!ignoreIdle && SecondsSinceLastInput() > idleData.time) {
+	if (!ignoreIdle && EnvironmentSnapshot::Get().SecondsSinceLastInput() >
+				   idleData.time) {
 		if (idleData.alreadySwitched) {
 			return false;
 		}
@@ -1,4 +1,5 @@
 #include "advanced-scene-switcher.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "selection-helpers.hpp"
 #include "source-helpers.hpp"
@@ -160,7 +161,8 @@ bool SwitcherData::checkScreenRegionSwitch(OBSWeakSource &scene,
 		return false;
 	}
 
-	std::pair<int, int> cursorPos = GetCursorPos();
+	std::pair<int, int> cursorPos =
+		EnvironmentSnapshot::Get().GetCursorPos();
 	int minRegionSize = 99999;
 	bool match = false;
 
@@ -1,4 +1,5 @@
 #include "advanced-scene-switcher.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
 #include "selection-helpers.hpp"
@@ -206,7 +207,7 @@ bool SwitcherData::checkWindowTitleSwitch(OBSWeakSource &scene,
 	options.focus = true;
 	options.fullscreen = true;
 	options.maximized = true;
-	const auto windows = GetWindows(options);
+	const auto windows = EnvironmentSnapshot::Get().GetWindows(options);
 
 	for (WindowSwitch &s : windowSwitches) {
 		if (!s.initialized()) {
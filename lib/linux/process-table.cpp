@@ -0,0 +1,205 @@
+#include "process-table.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace advss {
+
+// The start time is field 22 of /proc/<pid>/stat, so it is preceded by 19
+// fields after the process name, which is enclosed in parentheses and might
+// contain spaces
+constexpr int fieldsBeforeStartTime = 19;
+
+static bool parsePid(const char *name, long &pid)
+{
+	if (*name == '\0') {
+		return false;
+	}
+	for (const char *c = name; *c; c++) {
+		if (!isdigit(*c)) {
+			return false;
+		}
+	}
+	pid = std::strtol(name, nullptr, 10);
+	return true;
+}
+
+ProcessTable::ProcessTable(const std::string &procDir) : _procDir(procDir) {}
+
+bool ProcessTable::ReadStartTime(long pid, uint64_t &startTime) const
+{
+	std::ifstream file(_procDir + "/" + std::to_string(pid) + "/stat");
+	if (!file) {
+		return false;
+	}
+	std::string stat;
+	std::getline(file, stat);
+	const auto nameEnd = stat.rfind(')');
+	if (nameEnd == std::string::npos) {
+		return false;
+	}
+
+	std::istringstream fields(stat.substr(nameEnd + 1));
+	std::string field;
+	for (int i = 0; i < fieldsBeforeStartTime; i++) {
+		if (!(fields >> field)) {
+			return false;
+		}
+	}
+	return !!(fields >> startTime);
+}
+
+ProcessTable::Process ProcessTable::ReadProcess(long pid) const
+{
+	const std::string dir = _procDir + "/" + std::to_string(pid);
+	Process process;
+
+	std::ifstream commFile(dir + "/comm");
+	std::getline(commFile, process.name);
+
+	char buf[PATH_MAX];
+	const auto exePath = dir + "/exe";
+	ssize_t len = readlink(exePath.c_str(), buf, sizeof(buf) - 1);
+	if (len > 0) {
+		buf[len] = '\0';
+		process.path = buf;
+	}
+	return process;
+}
+
+void ProcessTable::AddToIndex(long pid, const std::string &name)
+{
+	if (name.empty()) {
+		return;
+	}
+	_pidsByName[name].push_back(pid);
+}
+
+void ProcessTable::RemoveFromIndex(long pid, const std::string &name)
+{
+	auto it = _pidsByName.find(name);
+	if (it == _pidsByName.end()) {
+		return;
+	}
+	auto &pids = it->second;
+	pids.erase(std::remove(pids.begin(), pids.end(), pid), pids.end());
+	if (pids.empty()) {
+		_pidsByName.erase(it);
+	}
+}
+
+void ProcessTable::Update()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	DIR *procDir = opendir(_procDir.c_str());
+	if (!procDir) {
+		return;
+	}
+
+	const auto generation = ++_generation;
+	struct dirent *entry;
+	while ((entry = readdir(procDir)) != nullptr) {
+		long pid;
+		if (!parsePid(entry->d_name, pid)) {
+			continue;
+		}
+
+		// The inode of a /proc/<pid> entry changes if the pid is
+		// reused, so nothing has to be read for known processes
+		auto it = _processes.find(pid);
+		const bool known = it != _processes.end();
+		if (known && it->second.inode == entry->d_ino) {
+			it->second.generation = generation;
+			continue;
+		}
+
+		uint64_t startTime;
+		if (!ReadStartTime(pid, startTime)) {
+			continue; // Process exited in the meantime
+		}
+		if (known && it->second.startTime == startTime) {
+			it->second.inode = entry->d_ino;
+			it->second.generation = generation;
+			continue;
+		}
+
+		auto process = ReadProcess(pid);
+		process.inode = entry->d_ino;
+		process.startTime = startTime;
+		process.generation = generation;
+		_readCount++;
+
+		if (known) {
+			RemoveFromIndex(pid, it->second.name);
+			it->second = std::move(process);
+		} else {
+			it = _processes.emplace(pid, std::move(process)).first;
+		}
+		AddToIndex(pid, it->second.name);
+	}
+	closedir(procDir);
+
+	for (auto it = _processes.begin(); it != _processes.end();) {
+		if (it->second.generation == generation) {
+			++it;
+			continue;
+		}
+		RemoveFromIndex(it->first, it->second.name);
+		it = _processes.erase(it);
+	}
+}
+
+std::vector<std::string> ProcessTable::GetNames() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<std::string> names;
+	names.reserve(_pidsByName.size());
+	for (const auto &[name, _] : _pidsByName) {
+		names.emplace_back(name);
+	}
+	return names;
+}
+
+std::vector<long> ProcessTable::GetPids(const std::string &name) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _pidsByName.find(name);
+	if (it == _pidsByName.end()) {
+		return {};
+	}
+	return it->second;
+}
+
+std::string ProcessTable::GetName(long pid) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _processes.find(pid);
+	if (it == _processes.end()) {
+		return {};
+	}
+	return it->second.name;
+}
+
+std::string ProcessTable::GetPath(long pid) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _processes.find(pid);
+	if (it == _processes.end()) {
+		return {};
+	}
+	return it->second.path;
+}
+
+uint64_t ProcessTable::GetReadCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _readCount;
+}
+
+} // namespace advss
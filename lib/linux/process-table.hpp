@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Keeps track of the processes listed in a /proc like directory.
+// Each call to Update() only reads the directory entries and compares them to
+// the previous scan, so the details of a process are read only once for each
+// (pid, start time) pair.
+class ProcessTable {
+public:
+	ProcessTable(const std::string &procDir = "/proc");
+
+	void Update();
+
+	std::vector<std::string> GetNames() const;
+	std::vector<long> GetPids(const std::string &name) const;
+	// Returns empty strings for unknown pids
+	std::string GetName(long pid) const;
+	std::string GetPath(long pid) const;
+	// Number of processes whose details had to be read so far
+	uint64_t GetReadCount() const;
+
+private:
+	struct Process {
+		uint64_t inode = 0;
+		uint64_t startTime = 0;
+		uint64_t generation = 0;
+		std::string name;
+		std::string path;
+	};
+
+	bool ReadStartTime(long pid, uint64_t &startTime) const;
+	Process ReadProcess(long pid) const;
+	void AddToIndex(long pid, const std::string &name);
+	void RemoveFromIndex(long pid, const std::string &name);
+
+	const std::string _procDir;
+	mutable std::mutex _mutex;
+	std::unordered_map<long, Process> _processes;
+	std::unordered_map<std::string, std::vector<long>> _pidsByName;
+	uint64_t _generation = 0;
+	uint64_t _readCount = 0;
+};
+
+} // namespace advss
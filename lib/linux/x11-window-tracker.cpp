@@ -0,0 +1,412 @@
+#include "x11-window-tracker.hpp"
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace advss {
+
+X11WindowTracker::X11WindowTracker(const char *displayName)
+	: _display(XOpenDisplay(displayName))
+{
+	if (!_display) {
+		return;
+	}
+
+	_netSupportingWmCheck =
+		XInternAtom(_display, "_NET_SUPPORTING_WM_CHECK", false);
+	_netClientList = XInternAtom(_display, "_NET_CLIENT_LIST", false);
+	_netActiveWindow = XInternAtom(_display, "_NET_ACTIVE_WINDOW", false);
+	_netWmName = XInternAtom(_display, "_NET_WM_NAME", false);
+	_netWmState = XInternAtom(_display, "_NET_WM_STATE", false);
+	_netWmStateFullscreen =
+		XInternAtom(_display, "_NET_WM_STATE_FULLSCREEN", false);
+	_netWmStateMaximizedVert =
+		XInternAtom(_display, "_NET_WM_STATE_MAXIMIZED_VERT", false);
+	_netWmStateMaximizedHorz =
+		XInternAtom(_display, "_NET_WM_STATE_MAXIMIZED_HORZ", false);
+
+	for (int i = 0; i < ScreenCount(_display); ++i) {
+		Window rootWindow = RootWindow(_display, i);
+		if (!rootWindow) {
+			continue;
+		}
+		XSelectInput(_display, rootWindow, PropertyChangeMask);
+		_rootWindows.emplace_back(rootWindow);
+	}
+	XFlush(_display);
+}
+
+X11WindowTracker::~X11WindowTracker()
+{
+	if (_display) {
+		XCloseDisplay(_display);
+	}
+}
+
+std::vector<WindowInfo>
+X11WindowTracker::GetWindows(const WindowQueryOptions &options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<WindowInfo> result;
+	if (!_display) {
+		return result;
+	}
+
+	Refresh();
+	result.reserve(_clients.size());
+	for (const auto window : _clients) {
+		auto &tracked = _windows[window];
+		if (tracked.title.empty()) {
+			continue;
+		}
+
+		WindowInfo info;
+		info.title = tracked.title;
+		if (options.fullscreen || options.maximized) {
+			UpdateState(window, tracked);
+			info.fullscreen =
+				options.fullscreen && tracked.fullscreen;
+			info.maximized =
+				options.maximized && tracked.maximized;
+		}
+		if (options.geometry) {
+			UpdateGeometry(window, tracked);
+			info.x = tracked.x;
+			info.y = tracked.y;
+			info.width = tracked.width;
+			info.height = tracked.height;
+		}
+		result.emplace_back(std::move(info));
+	}
+	return result;
+}
+
+unsigned long X11WindowTracker::GetActiveWindow()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_display) {
+		return 0;
+	}
+	Refresh();
+	return _activeWindow;
+}
+
+std::string X11WindowTracker::GetActiveWindowTitle()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_display) {
+		return {};
+	}
+	Refresh();
+	if (!_activeWindow) {
+		return {};
+	}
+	return _windows[_activeWindow].title;
+}
+
+unsigned long X11WindowTracker::GetRequestSerial()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_display) {
+		return 0;
+	}
+	return NextRequest(_display);
+}
+
+void X11WindowTracker::ProcessEvents()
+{
+	// XPending() does not block and only reads already received events
+	XEvent event;
+	while (XPending(_display) > 0) {
+		XNextEvent(_display, &event);
+		HandleEvent(event);
+	}
+}
+
+void X11WindowTracker::HandleEvent(const XEvent &event)
+{
+	switch (event.type) {
+	case PropertyNotify: {
+		const auto &property = event.xproperty;
+		if (std::find(_rootWindows.begin(), _rootWindows.end(),
+			      property.window) != _rootWindows.end()) {
+			if (property.atom == _netSupportingWmCheck) {
+				_ewmhChanged = true;
+			} else if (property.atom == _netClientList) {
+				_clientListChanged = true;
+			} else if (property.atom == _netActiveWindow) {
+				_activeWindowChanged = true;
+			}
+			return;
+		}
+
+		auto it = _windows.find(property.window);
+		if (it == _windows.end()) {
+			return;
+		}
+		if (property.atom == XA_WM_NAME ||
+		    property.atom == _netWmName) {
+			it->second.titleChanged = true;
+		} else if (property.atom == _netWmState) {
+			it->second.stateChanged = true;
+		}
+		return;
+	}
+	case ConfigureNotify: {
+		// Window managers send synthetic ConfigureNotify events when
+		// moving the frame of a reparented window
+		auto it = _windows.find(event.xconfigure.window);
+		if (it != _windows.end()) {
+			it->second.geometryChanged = true;
+		}
+		return;
+	}
+	case DestroyNotify: {
+		const auto window = event.xdestroywindow.window;
+		if (window == _ewmhWindow) {
+			_ewmhChanged = true;
+		}
+		if (_windows.erase(window) > 0) {
+			_clientListChanged = true;
+		}
+		if (window == _activeWindow) {
+			_activeWindowChanged = true;
+		}
+		return;
+	}
+	default:
+		return;
+	}
+}
+
+void X11WindowTracker::Refresh()
+{
+	ProcessEvents();
+	if (_ewmhChanged) {
+		RefreshEwmhSupport();
+	}
+	if (_clientListChanged) {
+		RefreshClientList();
+	}
+	if (_activeWindowChanged) {
+		RefreshActiveWindow();
+	}
+	for (const auto window : _clients) {
+		UpdateTitle(window, _windows[window]);
+	}
+	if (_activeWindow) {
+		UpdateTitle(_activeWindow, _windows[_activeWindow]);
+	}
+}
+
+static Window getWindowProperty(Display *display, Window window, Atom atom)
+{
+	Atom actualType;
+	int format = 0;
+	unsigned long num = 0, bytes = 0;
+	unsigned char *data = nullptr;
+	Window result = 0;
+
+	int status = XGetWindowProperty(display, window, atom, 0L, 1L, false,
+					XA_WINDOW, &actualType, &format, &num,
+					&bytes, &data);
+	if (status == Success && num > 0 && data) {
+		result = ((Window *)data)[0];
+	}
+	if (data) {
+		XFree(data);
+	}
+	return result;
+}
+
+void X11WindowTracker::RefreshEwmhSupport()
+{
+	_ewmhChanged = false;
+	_ewmhWindow = 0;
+	_ewmhSupported = false;
+	_clientListChanged = true;
+	_activeWindowChanged = true;
+	if (_rootWindows.empty()) {
+		return;
+	}
+
+	Window ewmhWindow = getWindowProperty(_display, _rootWindows[0],
+					      _netSupportingWmCheck);
+	if (!ewmhWindow) {
+		return;
+	}
+	// Get notified if the window manager exits
+	XSelectInput(_display, ewmhWindow, StructureNotifyMask);
+	if (getWindowProperty(_display, ewmhWindow, _netSupportingWmCheck) !=
+	    ewmhWindow) {
+		return;
+	}
+	_ewmhWindow = ewmhWindow;
+	_ewmhSupported = true;
+}
+
+void X11WindowTracker::RefreshClientList()
+{
+	_clientListChanged = false;
+	std::vector<unsigned long> clients;
+	if (_ewmhSupported) {
+		for (const auto rootWindow : _rootWindows) {
+			Atom actualType;
+			int format;
+			unsigned long num, bytes;
+			Window *data = nullptr;
+			int status = XGetWindowProperty(
+				_display, rootWindow, _netClientList, 0L, ~0L,
+				false, AnyPropertyType, &actualType, &format,
+				&num, &bytes, (unsigned char **)&data);
+			if (status != Success) {
+				continue;
+			}
+			clients.insert(clients.end(), data, data + num);
+			if (data) {
+				XFree(data);
+			}
+		}
+	}
+
+	for (auto &[_, window] : _windows) {
+		window.isClient = false;
+	}
+	for (const auto window : clients) {
+		Track(window).isClient = true;
+	}
+	for (auto it = _windows.begin(); it != _windows.end();) {
+		if (it->second.isClient || it->first == _activeWindow) {
+			++it;
+			continue;
+		}
+		XSelectInput(_display, it->first, NoEventMask);
+		it = _windows.erase(it);
+	}
+	_clients = std::move(clients);
+}
+
+void X11WindowTracker::RefreshActiveWindow()
+{
+	_activeWindowChanged = false;
+	const auto previous = _activeWindow;
+	_activeWindow = 0;
+	if (_ewmhSupported && !_rootWindows.empty()) {
+		_activeWindow = getWindowProperty(_display, _rootWindows[0],
+						  _netActiveWindow);
+	}
+	if (_activeWindow) {
+		Track(_activeWindow);
+	}
+
+	if (previous && previous != _activeWindow) {
+		auto it = _windows.find(previous);
+		if (it != _windows.end() && !it->second.isClient) {
+			XSelectInput(_display, previous, NoEventMask);
+			_windows.erase(it);
+		}
+	}
+}
+
+X11WindowTracker::TrackedWindow &X11WindowTracker::Track(unsigned long window)
+{
+	auto [it, inserted] = _windows.try_emplace(window);
+	if (inserted) {
+		// Select the events before querying any data, so no change
+		// can be missed
+		XSelectInput(_display, window,
+			     PropertyChangeMask | StructureNotifyMask);
+	}
+	return it->second;
+}
+
+void X11WindowTracker::UpdateTitle(unsigned long window, TrackedWindow &info)
+{
+	if (!info.titleChanged) {
+		return;
+	}
+	info.titleChanged = false;
+	info.title.clear();
+
+	char *name = nullptr;
+	int status = XFetchName(_display, window, &name);
+	if (status >= Success && name != nullptr) {
+		info.title = name;
+		XFree(name);
+		return;
+	}
+
+	XTextProperty textProperty;
+	if (XGetWMName(_display, window, &textProperty) != 0 &&
+	    textProperty.value != nullptr) {
+		info.title = (const char *)textProperty.value;
+		XFree(textProperty.value);
+	}
+}
+
+void X11WindowTracker::UpdateState(unsigned long window, TrackedWindow &info)
+{
+	if (!info.stateChanged) {
+		return;
+	}
+	info.stateChanged = false;
+	info.fullscreen = false;
+	info.maximized = false;
+
+	Atom type;
+	int format;
+	unsigned long num, bytes;
+	unsigned char *data = nullptr;
+	int status = XGetWindowProperty(_display, window, _netWmState, 0, ~0L,
+					false, AnyPropertyType, &type, &format,
+					&num, &bytes, &data);
+	if (status != Success) {
+		return;
+	}
+
+	bool maximizedVert = false;
+	bool maximizedHorz = false;
+	for (unsigned long i = 0; i < num; i++) {
+		const Atom state = ((Atom *)data)[i];
+		if (state == _netWmStateFullscreen) {
+			info.fullscreen = true;
+		} else if (state == _netWmStateMaximizedVert) {
+			maximizedVert = true;
+		} else if (state == _netWmStateMaximizedHorz) {
+			maximizedHorz = true;
+		}
+	}
+	info.maximized = maximizedVert && maximizedHorz;
+	if (data) {
+		XFree(data);
+	}
+}
+
+void X11WindowTracker::UpdateGeometry(unsigned long window,
+				      TrackedWindow &info)
+{
+	if (!info.geometryChanged) {
+		return;
+	}
+	info.geometryChanged = false;
+
+	XWindowAttributes attrs;
+	if (!XGetWindowAttributes(_display, window, &attrs)) {
+		return;
+	}
+	int x = 0;
+	int y = 0;
+	Window child;
+	XTranslateCoordinates(_display, window, attrs.root, 0, 0, &x, &y,
+			      &child);
+	info.x = x;
+	info.y = y;
+	info.width = attrs.width;
+	info.height = attrs.height;
+}
+
+} // namespace advss
@@ -0,0 +1,80 @@
+#pragma once
+#include "platform-funcs.hpp"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct _XDisplay;
+union _XEvent;
+
+namespace advss {
+
+// Keeps track of the top level windows and the active window using a
+// dedicated X11 connection.
+// Changes to the window list, window titles, states and geometry are picked
+// up via PropertyNotify and ConfigureNotify events, so the X server is only
+// queried for data which actually changed.
+class X11WindowTracker {
+public:
+	X11WindowTracker(const char *displayName = nullptr);
+	~X11WindowTracker();
+
+	bool IsValid() const { return _display != nullptr; }
+	std::vector<WindowInfo> GetWindows(const WindowQueryOptions &options);
+	unsigned long GetActiveWindow();
+	std::string GetActiveWindowTitle();
+	// Serial number of the next request sent to the X server
+	unsigned long GetRequestSerial();
+
+private:
+	struct TrackedWindow {
+		bool isClient = false;
+		bool titleChanged = true;
+		bool stateChanged = true;
+		bool geometryChanged = true;
+		std::string title;
+		bool fullscreen = false;
+		bool maximized = false;
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	void ProcessEvents();
+	void HandleEvent(const _XEvent &event);
+	void Refresh();
+	void RefreshEwmhSupport();
+	void RefreshClientList();
+	void RefreshActiveWindow();
+	TrackedWindow &Track(unsigned long window);
+	void UpdateTitle(unsigned long window, TrackedWindow &info);
+	void UpdateState(unsigned long window, TrackedWindow &info);
+	void UpdateGeometry(unsigned long window, TrackedWindow &info);
+
+	_XDisplay *_display = nullptr;
+	std::mutex _mutex;
+	std::vector<unsigned long> _rootWindows;
+
+	unsigned long _netSupportingWmCheck = 0;
+	unsigned long _netClientList = 0;
+	unsigned long _netActiveWindow = 0;
+	unsigned long _netWmName = 0;
+	unsigned long _netWmState = 0;
+	unsigned long _netWmStateFullscreen = 0;
+	unsigned long _netWmStateMaximizedVert = 0;
+	unsigned long _netWmStateMaximizedHorz = 0;
+
+	bool _ewmhChanged = true;
+	bool _ewmhSupported = false;
+	unsigned long _ewmhWindow = 0;
+	bool _clientListChanged = true;
+	std::vector<unsigned long> _clients;
+	bool _activeWindowChanged = true;
+	unsigned long _activeWindow = 0;
+	std::unordered_map<unsigned long, TrackedWindow> _windows;
+};
+
+} // namespace advss
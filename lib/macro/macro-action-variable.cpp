@@ -119,7 +119,7 @@ void MacroActionVariable::HandleFindAndReplace(Variable *var)
 
 void MacroActionVariable::HandleMathExpression(Variable *var)
 {
-	auto result = EvalMathExpression(_mathExpression);
+	auto result = EvalMathExpressionWithVariables(_mathExpression);
 	if (std::holds_alternative<std::string>(result)) {
 		blog(LOG_WARNING, "%s", std::get<std::string>(result).c_str());
 		return;
@@ -1438,7 +1438,8 @@ void MacroActionVariableEdit::MathExpressionChanged()
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_mathExpression = _mathExpression->text().toStdString();
 
-	// In case of invalid expression display an error
+	// In case of invalid expression display an error.
+	// The expression is not cached, as it changes with every keystroke.
 	auto result = EvalMathExpression(_entryData->_mathExpression);
 	auto hasError = std::holds_alternative<std::string>(result);
 	if (hasError) {
@@ -32,6 +32,11 @@ public:
 	void ResetDuration();
 	bool CheckDurationModifier(bool conditionValue);
 
+	// Conditions receiving messages, e.g. via a MessageBuffer, report new
+	// messages, so their macro can be checked when the main loop is woken
+	// up instead of waiting for the next regular check
+	virtual bool HasPendingMessages() const { return false; }
+
 	static std::string_view GetDefaultID();
 
 protected:
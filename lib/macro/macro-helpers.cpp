@@ -251,6 +251,15 @@ void AddMacroHelperThread(Macro *macro, std::thread &&newThread)
 	macro->AddHelperThread(std::move(newThread));
 }
 
+void AddMacroActionsDoneCallback(Macro *macro,
+				 std::function<void(bool)> callback)
+{
+	if (!macro) {
+		return;
+	}
+	macro->AddActionsDoneCallback(std::move(callback));
+}
+
 bool RunMacroActions(Macro *macro, bool forceParallel, bool ignorePause)
 {
 	return macro && macro->PerformActions(true, forceParallel, ignorePause);
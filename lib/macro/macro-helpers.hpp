@@ -7,6 +7,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <optional>
 #include <thread>
 
@@ -18,6 +19,7 @@ namespace advss {
 class Macro;
 class MacroAction;
 class MacroCondition;
+class ThreadPool;
 
 static const int macro_func = 10;
 
@@ -66,8 +68,25 @@ MacroWasPausedSince(const Macro *,
 EXPORT bool MacroWasCheckedSinceLastStart(const Macro *);
 
 EXPORT void AddMacroHelperThread(Macro *, std::thread &&);
+// Invoked once the macro has finished running its actions after the current
+// condition check or once it is clear that no actions will be run.
+// The argument tells whether any actions were run.
+EXPORT void AddMacroActionsDoneCallback(Macro *, std::function<void(bool)>);
 
 EXPORT bool CheckMacros();
+// Earliest point in time at which a macro using a custom condition check
+// interval is due to be checked again
+std::optional<std::chrono::high_resolution_clock::time_point>
+GetNextScheduledMacroCheckTime();
+// Checks and runs only the macros whose custom check interval has elapsed and,
+// if requested, the macros with pending messages
+void CheckAndRunScheduledMacros(bool checkPendingMessages = false);
+// Used if the regular macro check is skipped, e.g. while the plugin is paused
+void ClearNextScheduledMacroCheckTime();
+// Used for macros which check their conditions in parallel to the main loop
+ThreadPool &GetConditionCheckThreadPool();
+// Used for macros which run their actions in parallel to the main loop
+ThreadPool &GetActionRunThreadPool();
 EXPORT bool CheckMacroConditions(Macro *, bool ignorePause = false);
 
 EXPORT bool RunMacroActions(Macro *, bool forceParallel = false,
@@ -2,7 +2,6 @@
 #include "layout-helpers.hpp"
 #include "macro.hpp"
 #include "obs-module-helper.hpp"
-#include "plugin-state-helpers.hpp"
 
 #include <QDialogButtonBox>
 #include <QScrollArea>
@@ -84,8 +83,6 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 		  "AdvSceneSwitcher.macroTab.currentUseCustomConditionCheckInterval"))),
 	  _currentCustomConditionCheckInterval(
 		  new DurationSelection(this, true, 0.01)),
-	  _currentCustomConditionCheckIntervalWarning(new QLabel(obs_module_text(
-		  "AdvSceneSwitcher.macroTab.currentUseCustomConditionCheckIntervalWarning"))),
 	  _currentPauseSaveBehavior(new QComboBox(this)),
 	  _currentSkipOnStartup(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.macroTab.currentSkipExecutionOnStartup"))),
@@ -173,11 +170,7 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 	durationLayout->addWidget(_currentUseCustomConditionCheckInterval);
 	durationLayout->addWidget(_currentCustomConditionCheckInterval);
 	durationLayout->addStretch();
-	auto customConditionIntervalLayout = new QVBoxLayout();
-	customConditionIntervalLayout->addLayout(durationLayout);
-	customConditionIntervalLayout->addWidget(
-		_currentCustomConditionCheckIntervalWarning);
-	generalLayout->addLayout(customConditionIntervalLayout);
+	generalLayout->addLayout(durationLayout);
 
 	auto pauseStateSaveBehavorLayout = new QHBoxLayout();
 	pauseStateSaveBehavorLayout->addWidget(new QLabel(obs_module_text(
@@ -276,9 +269,6 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 		&QCheckBox::stateChanged, this, [this](int state) {
 			_currentCustomConditionCheckInterval->setEnabled(state);
 		});
-	connect(_currentCustomConditionCheckInterval,
-		&DurationSelection::DurationChanged, this,
-		[this]() { SetCustomConditionIntervalWarningVisibility(); });
 
 	auto scrollArea = new QScrollArea(this);
 	scrollArea->setWidgetResizable(true);
@@ -315,7 +305,7 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 		_currentStopActionsIfNotDone->hide();
 		_currentUseShortCircuitEvaluation->hide();
 		_currentCheckInParallel->hide();
-		SetLayoutVisible(customConditionIntervalLayout, false);
+		SetLayoutVisible(durationLayout, false);
 		SetLayoutVisible(pauseStateSaveBehavorLayout, false);
 
 		// Hotkey group
@@ -336,7 +326,6 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 		macro->GetCustomConditionCheckInterval());
 	_currentCustomConditionCheckInterval->setEnabled(
 		macro->CustomConditionCheckIntervalEnabled());
-	SetCustomConditionIntervalWarningVisibility();
 	_currentPauseSaveBehavior->setCurrentIndex(
 		_currentPauseSaveBehavior->findData(
 			static_cast<int>(macro->GetPauseStateSaveBehavior())));
@@ -429,15 +418,6 @@ void MacroSettingsDialog::Resize()
 	_dockOptions->updateGeometry();
 }
 
-void MacroSettingsDialog::SetCustomConditionIntervalWarningVisibility() const
-{
-	_currentCustomConditionCheckIntervalWarning->setVisible(
-		_currentUseCustomConditionCheckInterval->isChecked() &&
-		GetIntervalValue() >
-			_currentCustomConditionCheckInterval->GetDuration()
-				.Milliseconds());
-}
-
 bool MacroSettingsDialog::AskForSettings(QWidget *parent,
 					 GlobalMacroSettings &userInput,
 					 Macro *macro)
@@ -48,7 +48,6 @@ private slots:
 
 private:
 	void Resize();
-	void SetCustomConditionIntervalWarningVisibility() const;
 
 	// Global macro settings
 	QCheckBox *_highlightExecutedMacros;
@@ -64,7 +63,6 @@ private:
 	QCheckBox *_currentUseShortCircuitEvaluation;
 	QCheckBox *_currentUseCustomConditionCheckInterval;
 	DurationSelection *_currentCustomConditionCheckInterval;
-	QLabel *_currentCustomConditionCheckIntervalWarning;
 	QComboBox *_currentPauseSaveBehavior;
 	QCheckBox *_currentSkipOnStartup;
 	QCheckBox *_currentStopActionsIfNotDone;
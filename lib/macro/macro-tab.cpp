@@ -592,8 +592,6 @@ void AdvSceneSwitcher::on_macroSettings_clicked()
 	if (prop._highlightActions) {
 		ui->macroEdit->ResetActionHighlights();
 	}
-
-	SetCheckIntervalTooLowVisibility();
 }
 
 static bool shouldRestoreSplitter(const QList<int> &pos)
@@ -8,12 +8,14 @@
 #include "plugin-state-helpers.hpp"
 #include "splitter-helpers.hpp"
 #include "sync-helpers.hpp"
+#include "thread-pool.hpp"
 
 #include <obs-frontend-api.h>
 
 #include <QAction>
 #include <QMainWindow>
 
+#include <atomic>
 #include <chrono>
 #include <limits>
 #undef max
@@ -209,6 +211,19 @@ bool Macro::CheckConditionHelper(
 	return result;
 }
 
+// The snapshot is only recreated if the segment list was modified
+template<class T>
+static std::shared_ptr<const std::deque<std::shared_ptr<T>>>
+updateSnapshot(std::shared_ptr<const std::deque<std::shared_ptr<T>>> &snapshot,
+	       const std::deque<std::shared_ptr<T>> &segments)
+{
+	if (!snapshot || *snapshot != segments) {
+		snapshot = std::make_shared<
+			const std::deque<std::shared_ptr<T>>>(segments);
+	}
+	return snapshot;
+}
+
 bool Macro::CheckConditions(bool ignorePause)
 {
 	if (_isGroup) {
@@ -239,14 +254,17 @@ bool Macro::CheckConditions(bool ignorePause)
 		if (!_conditionCheckFuture.valid()) {
 			_stop = false;
 			_matched = false;
-			_conditionCheckFuture = std::async(
-				std::launch::async,
-				[this, checkConditionsTask]() {
-					// Copy to avoid settings modifications
-					// causing issues
-					const auto conditionsCopy = _conditions;
-					checkConditionsTask(conditionsCopy);
-				});
+			// Use a snapshot to avoid settings modifications
+			// causing issues
+			_conditionCheckFuture =
+				GetConditionCheckThreadPool().Submit(
+					[checkConditionsTask,
+					 conditions = updateSnapshot(
+						 _conditionsSnapshot,
+						 _conditions)]() {
+						checkConditionsTask(
+							*conditions);
+					});
 			return false;
 		}
 		if (_conditionCheckFuture.wait_for(std::chrono::seconds(0)) !=
@@ -303,6 +321,10 @@ bool Macro::CheckConditions(bool ignorePause)
 	return _matched;
 }
 
+// Number of parallel action runs started on separate threads, as all workers
+// of the action run thread pool were busy
+static std::atomic_size_t separateActionRunThreads = 0;
+
 bool Macro::PerformActions(bool match, bool forceParallel, bool ignorePause)
 {
 	if (_actionRunFuture.valid() &&
@@ -311,6 +333,7 @@ bool Macro::PerformActions(bool match, bool forceParallel, bool ignorePause)
 		vblog(LOG_INFO, "Macro %s already running", _name.c_str());
 
 		if (!_stopActionsIfNotDone) {
+			NotifyActionsSkipped();
 			return !forceParallel;
 		}
 
@@ -319,21 +342,61 @@ bool Macro::PerformActions(bool match, bool forceParallel, bool ignorePause)
 		      _name.c_str());
 	}
 
-	std::function<bool(bool)> runFunc =
-		match ? std::bind(&Macro::RunActions, this,
-				  std::placeholders::_1)
-		      : std::bind(&Macro::RunElseActions, this,
-				  std::placeholders::_1);
+	// Use a snapshot as elements might be removed, inserted, or reordered
+	// while actions are currently being executed
+	const auto actions =
+		match ? updateSnapshot(_actionsSnapshot, _actions)
+		      : updateSnapshot(_elseActionsSnapshot, _elseActions);
+	const auto callbacks = TakeActionsDoneCallbacks();
+	const auto runFunc = [this, match, actions,
+			      callbacks](bool ignorePause) {
+		const bool ret = match ? RunActions(*actions, ignorePause)
+				       : RunElseActions(*actions, ignorePause);
+		for (const auto &callback : callbacks) {
+			callback(true);
+		}
+		return ret;
+	};
 	_stop = false;
 	bool ret = true;
 	if (_runInParallel || forceParallel) {
 		if (_actionRunFuture.valid()) {
 			_actionRunFuture.get();
 		}
-		_actionRunFuture = std::async(std::launch::async,
-					      [this, runFunc, ignorePause] {
-						      runFunc(ignorePause);
-					      });
+		const auto task = [runFunc, ignorePause]() {
+			runFunc(ignorePause);
+		};
+		// The workers of the pool might be blocked by long running
+		// actions of other macros, e.g. wait actions, so a limited
+		// number of runs is started on separate threads instead of
+		// being queued
+		auto &pool = GetActionRunThreadPool();
+		const auto stats = pool.GetStats();
+		if (stats.running + stats.queued < stats.threadCount ||
+		    separateActionRunThreads >= stats.threadCount) {
+			_actionRunFuture = pool.Submit(task);
+		} else {
+			vblog(LOG_INFO,
+			      "no idle action run thread available - "
+			      "running actions of macro %s on separate thread",
+			      _name.c_str());
+			separateActionRunThreads++;
+			_actionRunFuture =
+				std::async(std::launch::async, [task]() {
+					task();
+					separateActionRunThreads--;
+				});
+		}
+		if (!_actionRunFuture.valid()) {
+			blog(LOG_WARNING,
+			     "action run queue is full - "
+			     "skipping actions of macro %s",
+			     _name.c_str());
+			for (const auto &callback : callbacks) {
+				callback(false);
+			}
+			return false;
+		}
 	} else {
 		ret = runFunc(ignorePause);
 	}
@@ -349,6 +412,32 @@ bool Macro::PerformActions(bool match, bool forceParallel, bool ignorePause)
 	return ret;
 }
 
+void Macro::AddActionsDoneCallback(std::function<void(bool)> callback)
+{
+	std::lock_guard<std::mutex> lock(_actionsDoneCallbackMutex);
+	_actionsDoneCallbacks.emplace_back(std::move(callback));
+}
+
+std::vector<std::function<void(bool)>> Macro::TakeActionsDoneCallbacks()
+{
+	std::vector<std::function<void(bool)>> callbacks;
+	std::lock_guard<std::mutex> lock(_actionsDoneCallbackMutex);
+	std::swap(callbacks, _actionsDoneCallbacks);
+	return callbacks;
+}
+
+void Macro::NotifyActionsSkipped()
+{
+	// Callbacks added by a condition check which is still running refer to
+	// the upcoming action run instead
+	if (CheckInParallel() && _conditionCheckFuture.valid()) {
+		return;
+	}
+	for (const auto &callback : TakeActionsDoneCallbacks()) {
+		callback(false);
+	}
+}
+
 bool Macro::WasExecutedSince(const TimePoint &time) const
 {
 	return _lastExecutionTime > time;
@@ -364,19 +453,37 @@ Macro::TimePoint Macro::GetLastExecutionTime() const
 	return _lastExecutionTime;
 }
 
-bool Macro::ConditionsShouldBeChecked() const
+// Small deviations of the main loop's wakeup time should not cause a macro
+// to be skipped until the next wakeup
+static constexpr auto checkTimeTolerance = std::chrono::milliseconds(5);
+
+bool Macro::ConditionsShouldBeChecked(const TimePoint &now) const
 {
 	if (!_useCustomConditionCheckInterval) {
 		return true;
 	}
+	return now + checkTimeTolerance >= _nextCheckTime;
+}
+
+void Macro::ScheduleNextConditionCheck(const TimePoint &now)
+{
+	if (!_useCustomConditionCheckInterval) {
+		_nextCheckTime = {};
+		return;
+	}
+	_nextCheckTime =
+		now + std::chrono::milliseconds(
+			      _customConditionCheckInterval.Milliseconds());
+}
 
-	const auto timePassed = std::chrono::high_resolution_clock::now() -
-				LastConditionCheckTime();
-	const auto timePassedMs =
-		std::chrono::duration_cast<std::chrono::milliseconds>(
-			timePassed);
-	return timePassedMs.count() >=
-	       _customConditionCheckInterval.Milliseconds();
+bool Macro::HasPendingMessages() const
+{
+	for (const auto &condition : _conditions) {
+		if (condition && condition->HasPendingMessages()) {
+			return true;
+		}
+	}
+	return false;
 }
 
 bool Macro::ShouldRunActions() const
@@ -420,6 +527,7 @@ void Macro::ResetTimers()
 		c->ResetDuration();
 	}
 	_lastCheckTime = {};
+	_nextCheckTime = {};
 	_lastExecutionTime = {};
 }
 
@@ -434,17 +542,13 @@ Macro::ActionTriggerMode Macro::GetActionTriggerMode() const
 }
 
 bool Macro::RunActionsHelper(
-	const std::deque<std::shared_ptr<MacroAction>> &actionsToRun,
+	const std::deque<std::shared_ptr<MacroAction>> &actions,
 	bool ignorePause)
 {
 	if (_paused && !ignorePause) {
 		return true;
 	}
 
-	// Create copy of action list as elements might be removed, inserted, or
-	// reordered while actions are currently being executed.
-	auto actions = actionsToRun;
-
 	bool actionsExecutedSuccessfully = true;
 	for (auto &action : actions) {
 		if (!action) {
@@ -474,16 +578,19 @@ bool Macro::RunActionsHelper(
 	return actionsExecutedSuccessfully;
 }
 
-bool Macro::RunActions(bool ignorePause)
+bool Macro::RunActions(const std::deque<std::shared_ptr<MacroAction>> &actions,
+			bool ignorePause)
 {
 	mblog(LOG_INFO, "running actions of %s", _name.c_str());
-	return RunActionsHelper(_actions, ignorePause);
+	return RunActionsHelper(actions, ignorePause);
 }
 
-bool Macro::RunElseActions(bool ignorePause)
+bool Macro::RunElseActions(
+	const std::deque<std::shared_ptr<MacroAction>> &actions,
+	bool ignorePause)
 {
 	mblog(LOG_INFO, "running else actions of %s", _name.c_str());
-	return RunActionsHelper(_elseActions, ignorePause);
+	return RunActionsHelper(actions, ignorePause);
 }
 
 bool Macro::WasPausedSince(const TimePoint &time) const
@@ -582,6 +689,9 @@ void Macro::Stop()
 void Macro::SetCheckInParallel(bool parallel)
 {
 	_checkInParallel = parallel;
+	if (_conditionCheckFuture.valid()) {
+		_conditionCheckFuture.wait();
+	}
 	_conditionCheckFuture = {};
 }
 
@@ -1258,18 +1368,42 @@ void LoadMacros(obs_data_t *obj)
 	}
 }
 
+using TimePoint = std::chrono::high_resolution_clock::time_point;
+static std::optional<TimePoint> nextScheduledMacroCheckTime;
+
+static void updateNextScheduledMacroCheckTime(const TimePoint &time)
+{
+	if (!nextScheduledMacroCheckTime ||
+	    time < *nextScheduledMacroCheckTime) {
+		nextScheduledMacroCheckTime = time;
+	}
+}
+
 bool CheckMacros()
 {
+	// All macros are checked against the same point in time so macros
+	// using the same custom check interval stay in sync
+	const auto now = std::chrono::high_resolution_clock::now();
+	nextScheduledMacroCheckTime.reset();
+
 	bool matchFound = false;
 	for (const auto &m : GetTopLevelMacros()) {
-		if (!m->ConditionsShouldBeChecked()) {
+		if (!m->ConditionsShouldBeChecked(now)) {
 			vblog(LOG_INFO,
 			      "skipping condition check for macro \"%s\" "
 			      "(custom check interval)",
 			      m->Name().c_str());
+			updateNextScheduledMacroCheckTime(
+				m->NextConditionCheckTime());
 			continue;
 		}
 
+		if (m->CustomConditionCheckIntervalEnabled() && !m->Paused()) {
+			m->ScheduleNextConditionCheck(now);
+			updateNextScheduledMacroCheckTime(
+				m->NextConditionCheckTime());
+		}
+
 		if (m->CheckConditions() || m->ElseActions().size() > 0) {
 			matchFound = true;
 			// This has to be performed here for now as actions are
@@ -1278,18 +1412,17 @@ bool CheckMacros()
 				SetMacroSwitchedScene(true);
 			}
 		}
+		// The actions are only run if any macro matched, so the
+		// skipped runs are reported right away
+		if (!m->ShouldRunActions()) {
+			m->NotifyActionsSkipped();
+		}
 	}
 	return matchFound;
 }
 
-bool RunMacros()
+static bool runMacros(std::deque<std::shared_ptr<Macro>> runPhaseMacros)
 {
-	// Create copy of macro list as elements might be removed, inserted, or
-	// reordered while macros are currently being executed.
-	// For example, this can happen if a macro is performing a wait action,
-	// as the main lock will be unlocked during this time.
-	auto runPhaseMacros = GetTopLevelMacros();
-
 	// Avoid deadlocks when opening settings window and calling frontend
 	// API functions at the same time.
 	//
@@ -1306,13 +1439,18 @@ bool RunMacros()
 	}
 
 	for (auto &m : runPhaseMacros) {
-		if (!m || !m->ShouldRunActions()) {
+		if (!m) {
+			continue;
+		}
+		if (!m->ShouldRunActions()) {
+			m->NotifyActionsSkipped();
 			continue;
 		}
 		if (IsFirstInterval() && m->SkipExecOnStart()) {
 			blog(LOG_INFO,
 			     "skip execution of macro \"%s\" at startup",
 			     m->Name().c_str());
+			m->NotifyActionsSkipped();
 			continue;
 		}
 		vblog(LOG_INFO, "running macro: %s", m->Name().c_str());
@@ -1326,6 +1464,63 @@ bool RunMacros()
 	return true;
 }
 
+// Only checks the conditions of the macros using a custom condition check
+// interval which are due to be checked and, if requested, of the macros with
+// pending messages and runs their actions.
+// All other macros keep waiting for the next regular check interval.
+void CheckAndRunScheduledMacros(bool checkPendingMessages)
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+	nextScheduledMacroCheckTime.reset();
+
+	std::deque<std::shared_ptr<Macro>> dueMacros;
+	bool matchFound = false;
+	for (const auto &m : GetTopLevelMacros()) {
+		if (m->Paused()) {
+			continue;
+		}
+		if (m->CustomConditionCheckIntervalEnabled()) {
+			if (!m->ConditionsShouldBeChecked(now)) {
+				updateNextScheduledMacroCheckTime(
+					m->NextConditionCheckTime());
+				continue;
+			}
+			m->ScheduleNextConditionCheck(now);
+			updateNextScheduledMacroCheckTime(
+				m->NextConditionCheckTime());
+		} else if (!checkPendingMessages ||
+			   !m->HasPendingMessages()) {
+			continue;
+		}
+
+		if (m->CheckConditions() || m->ElseActions().size() > 0) {
+			matchFound = true;
+		}
+		if (!m->ShouldRunActions()) {
+			m->NotifyActionsSkipped();
+		}
+		dueMacros.emplace_back(m);
+	}
+
+	if (matchFound) {
+		runMacros(std::move(dueMacros));
+	}
+}
+
+void ClearNextScheduledMacroCheckTime()
+{
+	nextScheduledMacroCheckTime.reset();
+}
+
+bool RunMacros()
+{
+	// Create copy of macro list as elements might be removed, inserted, or
+	// reordered while macros are currently being executed.
+	// For example, this can happen if a macro is performing a wait action,
+	// as the main lock will be unlocked during this time.
+	return runMacros(GetTopLevelMacros());
+}
+
 void SignalStopAllMacros()
 {
 	for (const auto &m : GetAllMacros()) {
@@ -1355,29 +1550,26 @@ void InvalidateMacroTempVarValues()
 	}
 }
 
-std::shared_ptr<Macro> GetMacroWithInvalidConditionInterval()
+ThreadPool &GetConditionCheckThreadPool()
 {
-	auto &macros = GetTopLevelMacros();
-
-	if (macros.empty()) {
-		return {};
-	}
-
-	for (const auto &macro : macros) {
-		if (!macro) {
-			continue;
-		}
-		if (!macro->CustomConditionCheckIntervalEnabled()) {
-			continue;
-		}
+	static ThreadPool pool("condition check");
+	return pool;
+}
 
-		if (macro->GetCustomConditionCheckInterval().Milliseconds() <
-		    GetIntervalValue()) {
-			return macro;
-		}
-	}
+ThreadPool &GetActionRunThreadPool()
+{
+	// Actions will often be waiting instead of keeping the CPU busy, so
+	// use more threads than there are cores available
+	static ThreadPool pool(
+		"action run",
+		std::max<size_t>(ThreadPool::GetDefaultThreadCount() * 2, 8),
+		256);
+	return pool;
+}
 
-	return {};
+std::optional<TimePoint> GetNextScheduledMacroCheckTime()
+{
+	return nextScheduledMacroCheckTime;
 }
 
 } // namespace advss
@@ -11,8 +11,10 @@
 #include <QList>
 
 #include <deque>
+#include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -46,11 +48,19 @@ public:
 	bool CheckConditions(bool ignorePause = false);
 	bool ConditionsMatched() const { return _matched; }
 	TimePoint LastConditionCheckTime() const { return _lastCheckTime; }
-	bool ConditionsShouldBeChecked() const;
+	bool ConditionsShouldBeChecked(const TimePoint &now) const;
+	void ScheduleNextConditionCheck(const TimePoint &now);
+	TimePoint NextConditionCheckTime() const { return _nextCheckTime; }
+	bool HasPendingMessages() const;
 
 	bool ShouldRunActions() const;
 	bool PerformActions(bool match, bool forceParallel = false,
 			    bool ignorePause = false);
+	// The callback is invoked once the next action run has completed or
+	// once no actions are going to be run for the current condition check,
+	// which is indicated by passing false
+	void AddActionsDoneCallback(std::function<void(bool)>);
+	void NotifyActionsSkipped();
 
 	void SetPaused(bool pause = true);
 	bool Paused() const { return _paused; }
@@ -169,22 +179,34 @@ private:
 	bool RunActionsHelper(
 		const std::deque<std::shared_ptr<MacroAction>> &actions,
 		bool ignorePause);
-	bool RunActions(bool ignorePause);
-	bool RunElseActions(bool ignorePause);
+	bool RunActions(const std::deque<std::shared_ptr<MacroAction>> &,
+			bool ignorePause);
+	bool RunElseActions(const std::deque<std::shared_ptr<MacroAction>> &,
+			    bool ignorePause);
+	std::vector<std::function<void(bool)>> TakeActionsDoneCallbacks();
 
 	std::string _name = "";
 	bool _die = false;
 	bool _stop = false;
 	std::future<void> _actionRunFuture;
 	TimePoint _lastCheckTime{};
+	TimePoint _nextCheckTime{};
 	TimePoint _lastUnpauseTime{};
 	TimePoint _lastExecutionTime{};
 	TimePoint _lastActionRunModePreventTime{};
 	std::vector<std::thread> _helperThreads;
+	std::mutex _actionsDoneCallbackMutex;
+	std::vector<std::function<void(bool)>> _actionsDoneCallbacks;
 
 	std::deque<std::shared_ptr<MacroCondition>> _conditions;
+	std::shared_ptr<const std::deque<std::shared_ptr<MacroCondition>>>
+		_conditionsSnapshot;
 	std::deque<std::shared_ptr<MacroAction>> _actions;
+	std::shared_ptr<const std::deque<std::shared_ptr<MacroAction>>>
+		_actionsSnapshot;
 	std::deque<std::shared_ptr<MacroAction>> _elseActions;
+	std::shared_ptr<const std::deque<std::shared_ptr<MacroAction>>>
+		_elseActionsSnapshot;
 
 	std::weak_ptr<Macro> _parent;
 	uint32_t _groupSize = 0;
@@ -225,6 +247,5 @@ private:
 };
 
 void WaitForAllMacros();
-std::shared_ptr<Macro> GetMacroWithInvalidConditionInterval();
 
 } // namespace advss
@@ -367,6 +367,11 @@ ActionQueueSelection::ActionQueueSelection(QWidget *parent)
 ActionQueueSignalManager::ActionQueueSignalManager(QObject *parent)
 	: QObject(parent)
 {
+	// Keep the name index used for lookups up to date
+	const auto invalidateIndex = []() { InvalidateItemNameIndex(queues); };
+	connect(this, &ActionQueueSignalManager::Add, this, invalidateIndex);
+	connect(this, &ActionQueueSignalManager::Rename, this, invalidateIndex);
+	connect(this, &ActionQueueSignalManager::Remove, this, invalidateIndex);
 	QWidget::connect(this, SIGNAL(Add(const QString &)), this,
 			 SLOT(StartNewQueue(const QString &)));
 }
@@ -454,14 +459,8 @@ void ImportQueues(obs_data_t *data)
 
 std::weak_ptr<ActionQueue> GetWeakActionQueueByName(const std::string &name)
 {
-	for (const auto &queue : queues) {
-		if (queue->Name() == name) {
-			std::weak_ptr<ActionQueue> wp =
-				std::dynamic_pointer_cast<ActionQueue>(queue);
-			return wp;
-		}
-	}
-	return std::weak_ptr<ActionQueue>();
+	return std::dynamic_pointer_cast<ActionQueue>(
+		GetItemByName(queues, name));
 }
 
 std::weak_ptr<ActionQueue> GetWeakActionQueueByQString(const QString &name)
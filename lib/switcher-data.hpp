@@ -21,6 +21,7 @@
 #include "scene-selection.hpp"
 #include "variable-string.hpp"
 
+#include <atomic>
 #include <condition_variable>
 #include <vector>
 #include <deque>
@@ -32,6 +33,7 @@
 namespace advss {
 
 constexpr auto default_interval = 300;
+constexpr auto min_wakeup_check_spacing = std::chrono::milliseconds(10);
 
 typedef const char *(*translateFunc)(const char *);
 
@@ -54,6 +56,12 @@ public:
 	const char *Translate(const char *);
 	obs_module_t *GetModule();
 
+	void RequestWakeup();
+	void InterruptWait();
+	// Returns true if the wait was cut short by RequestWakeup()
+	bool WaitForNextCheck(std::unique_lock<std::mutex> &lock,
+			      const std::chrono::milliseconds &duration);
+
 	void SetWaitScene();
 	bool SceneChangedDuringWait();
 	bool AnySceneTransitionStarted();
@@ -93,6 +101,13 @@ public:
 	std::unique_lock<std::mutex> *mainLoopLock = nullptr;
 	bool stop = false;
 	std::condition_variable cv;
+	// Wakeups are requested from threads which must not lock the main
+	// mutex, so a separate mutex protects the request flag
+	std::mutex wakeupMutex;
+	std::condition_variable wakeupCv;
+	bool wakeupRequested = false;
+	bool waitInterrupted = false;
+	std::chrono::high_resolution_clock::time_point lastCheckTime{};
 
 	bool transitionActive = false;
 	bool sceneCollectionStop = false;
@@ -140,6 +155,9 @@ public:
 		GetDefaultFunctionPriorityList();
 	const std::vector<ThreadPrio> threadPriorities = GetThreadPrioMapping();
 	uint32_t threadPriority = QThread::NormalPriority;
+	// 0 will use the default thread count of the respective thread pool
+	int conditionCheckThreadCount = 0;
+	int actionRunThreadCount = 0;
 
 	/* --- Start of hotkey section --- */
 
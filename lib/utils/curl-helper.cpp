@@ -18,7 +18,9 @@ constexpr auto curl_library_name = "libcurl.so.4";
 CurlHelper::CurlHelper()
 {
 	if (LoadLib()) {
-		_curl = _init();
+		// Handles are created on multiple threads, so the implicit
+		// initialization done by curl_easy_init() cannot be relied on
+		_globalInit(CURL_GLOBAL_DEFAULT);
 		_initialized = true;
 	}
 }
@@ -26,9 +28,6 @@ CurlHelper::CurlHelper()
 CurlHelper::~CurlHelper()
 {
 	if (_lib) {
-		if (_cleanup) {
-			_cleanup(_curl);
-		}
 		delete _lib;
 		_lib = nullptr;
 	}
@@ -45,29 +44,11 @@ bool CurlHelper::Initialized()
 	return GetInstance()._initialized;
 }
 
-curl_slist *CurlHelper::SlistAppend(curl_slist *list, const char *string)
-{
-	auto &curl = GetInstance();
-	if (!curl._initialized) {
-		return nullptr;
-	}
-	return curl._slistAppend(list, string);
-}
-
-CURLcode CurlHelper::Perform()
-{
-	auto &curl = GetInstance();
-	if (!curl._initialized) {
-		return CURLE_FAILED_INIT;
-	}
-	return curl._perform(curl._curl);
-}
-
-char *CurlHelper::GetError(CURLcode code)
+const char *CurlHelper::GetError(CURLcode code)
 {
 	auto &curl = GetInstance();
 	if (!curl._initialized) {
-		return (char *)"CURL initialization failed";
+		return "CURL initialization failed";
 	}
 
 	return curl._error(code);
@@ -117,15 +98,35 @@ bool CurlHelper::LoadLib()
 
 bool CurlHelper::Resolve()
 {
+	_globalInit = (globalInitFunction)_lib->resolve("curl_global_init");
 	_init = (initFunction)_lib->resolve("curl_easy_init");
 	_setopt = (setOptFunction)_lib->resolve("curl_easy_setopt");
-	_slistAppend = (slistAppendFunction)_lib->resolve("curl_slist_append");
-	_perform = (performFunction)_lib->resolve("curl_easy_perform");
+	_getinfo = (getInfoFunction)_lib->resolve("curl_easy_getinfo");
+	_reset = (resetFunction)_lib->resolve("curl_easy_reset");
 	_cleanup = (cleanupFunction)_lib->resolve("curl_easy_cleanup");
 	_error = (errorFunction)_lib->resolve("curl_easy_strerror");
-
-	if (_init && _setopt && _slistAppend && _perform && _cleanup &&
-	    _error) {
+	_slistAppend = (slistAppendFunction)_lib->resolve("curl_slist_append");
+	_slistFreeAll =
+		(slistFreeAllFunction)_lib->resolve("curl_slist_free_all");
+	_multiInit = (multiInitFunction)_lib->resolve("curl_multi_init");
+	_multiAddHandle =
+		(multiHandleFunction)_lib->resolve("curl_multi_add_handle");
+	_multiRemoveHandle =
+		(multiHandleFunction)_lib->resolve("curl_multi_remove_handle");
+	_multiPerform =
+		(multiPerformFunction)_lib->resolve("curl_multi_perform");
+	_multiWait = (multiWaitFunction)_lib->resolve("curl_multi_wait");
+	_multiInfoRead =
+		(multiInfoReadFunction)_lib->resolve("curl_multi_info_read");
+	_multiCleanup =
+		(multiCleanupFunction)_lib->resolve("curl_multi_cleanup");
+	_multiPoll = (multiWaitFunction)_lib->resolve("curl_multi_poll");
+	_multiWakeup = (multiWakeupFunction)_lib->resolve("curl_multi_wakeup");
+
+	if (_globalInit && _init && _setopt && _getinfo && _reset &&
+	    _cleanup && _error && _slistAppend && _slistFreeAll &&
+	    _multiInit && _multiAddHandle && _multiRemoveHandle &&
+	    _multiPerform && _multiWait && _multiInfoRead && _multiCleanup) {
 		blog(LOG_INFO, "curl loaded successfully");
 		return true;
 	}
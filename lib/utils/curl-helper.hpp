@@ -7,14 +7,14 @@
 
 namespace advss {
 
+class CurlRequestEngine;
+
+// Loads the curl library at runtime, as it is not available on all systems.
+// Requests are performed via the CurlRequestEngine.
 class CurlHelper {
 public:
 	EXPORT static bool Initialized();
-	template<typename... Args> static CURLcode SetOpt(CURLoption, Args...);
-	EXPORT static struct curl_slist *SlistAppend(struct curl_slist *list,
-						     const char *string);
-	EXPORT static CURLcode Perform();
-	EXPORT static char *GetError(CURLcode code);
+	EXPORT static const char *GetError(CURLcode code);
 
 private:
 	CurlHelper();
@@ -22,38 +22,53 @@ private:
 	CurlHelper &operator=(const CurlHelper &) = delete;
 	~CurlHelper();
 
+	typedef CURLcode (*globalInitFunction)(long);
 	typedef CURL *(*initFunction)(void);
 	typedef CURLcode (*setOptFunction)(CURL *, CURLoption, ...);
+	typedef CURLcode (*getInfoFunction)(CURL *, CURLINFO, ...);
+	typedef void (*resetFunction)(CURL *);
+	typedef void (*cleanupFunction)(CURL *);
+	typedef const char *(*errorFunction)(CURLcode);
 	typedef struct curl_slist *(*slistAppendFunction)(
 		struct curl_slist *list, const char *string);
-	typedef CURLcode (*performFunction)(CURL *);
-	typedef void (*cleanupFunction)(CURL *);
-	typedef char *(*errorFunction)(CURLcode);
+	typedef void (*slistFreeAllFunction)(struct curl_slist *);
+	typedef CURLM *(*multiInitFunction)(void);
+	typedef CURLMcode (*multiHandleFunction)(CURLM *, CURL *);
+	typedef CURLMcode (*multiPerformFunction)(CURLM *, int *);
+	typedef CURLMcode (*multiWaitFunction)(CURLM *, struct curl_waitfd *,
+					       unsigned int, int, int *);
+	typedef CURLMcode (*multiWakeupFunction)(CURLM *);
+	typedef CURLMsg *(*multiInfoReadFunction)(CURLM *, int *);
+	typedef CURLMcode (*multiCleanupFunction)(CURLM *);
 
 	EXPORT static CurlHelper &GetInstance();
 
 	bool LoadLib();
 	bool Resolve();
 
+	globalInitFunction _globalInit = nullptr;
 	initFunction _init = nullptr;
 	setOptFunction _setopt = nullptr;
-	slistAppendFunction _slistAppend = nullptr;
-	performFunction _perform = nullptr;
+	getInfoFunction _getinfo = nullptr;
+	resetFunction _reset = nullptr;
 	cleanupFunction _cleanup = nullptr;
 	errorFunction _error = nullptr;
-	CURL *_curl = nullptr;
+	slistAppendFunction _slistAppend = nullptr;
+	slistFreeAllFunction _slistFreeAll = nullptr;
+	multiInitFunction _multiInit = nullptr;
+	multiHandleFunction _multiAddHandle = nullptr;
+	multiHandleFunction _multiRemoveHandle = nullptr;
+	multiPerformFunction _multiPerform = nullptr;
+	multiWaitFunction _multiWait = nullptr;
+	multiInfoReadFunction _multiInfoRead = nullptr;
+	multiCleanupFunction _multiCleanup = nullptr;
+	// Only available in newer curl versions, so these might be nullptr
+	multiWaitFunction _multiPoll = nullptr;
+	multiWakeupFunction _multiWakeup = nullptr;
 	QLibrary *_lib;
 	std::atomic_bool _initialized = {false};
-};
 
-template<typename... Args>
-inline CURLcode CurlHelper::SetOpt(CURLoption option, Args... args)
-{
-	auto &curl = GetInstance();
-	if (!curl._initialized) {
-		return CURLE_FAILED_INIT;
-	}
-	return curl._setopt(curl._curl, option, args...);
-}
+	friend CurlRequestEngine;
+};
 
 } // namespace advss
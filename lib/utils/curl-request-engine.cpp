@@ -0,0 +1,313 @@
+#include "curl-request-engine.hpp"
+#include "curl-helper.hpp"
+
+#include <algorithm>
+#include <future>
+
+namespace advss {
+
+struct CurlRequestEngine::Transfer {
+	CurlRequest request;
+	Callback callback;
+	CurlResponse response;
+	CURL *handle = nullptr;
+	struct curl_slist *headers = nullptr;
+	char errorBuffer[CURL_ERROR_SIZE] = {};
+};
+
+static size_t writeCallback(char *data, size_t size, size_t nmemb,
+			    void *userData)
+{
+	static_cast<CurlResponse *>(userData)->body.append(data, size * nmemb);
+	return size * nmemb;
+}
+
+static size_t dropCallback(char *, size_t size, size_t nmemb, void *)
+{
+	return size * nmemb;
+}
+
+CurlRequestEngine::CurlRequestEngine(size_t maxParallelTransfers,
+				     size_t maxQueuedRequests)
+	: _maxParallelTransfers(std::max<size_t>(maxParallelTransfers, 1)),
+	  _maxQueuedRequests(maxQueuedRequests)
+{
+}
+
+CurlRequestEngine::~CurlRequestEngine()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+		// The worker cleans up the multi handle once it noticed the
+		// stop request, so it must only be used while holding the lock
+		auto &curl = CurlHelper::GetInstance();
+		if (_multi && curl._multiWakeup) {
+			curl._multiWakeup(_multi);
+		}
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+bool CurlRequestEngine::Submit(CurlRequest request, Callback callback)
+{
+	if (!CurlHelper::Initialized()) {
+		return false;
+	}
+
+	auto transfer = std::make_unique<Transfer>();
+	transfer->request = std::move(request);
+	transfer->callback = std::move(callback);
+
+	auto &curl = CurlHelper::GetInstance();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stop || (_maxQueuedRequests != 0 &&
+			      _queue.size() >= _maxQueuedRequests)) {
+			return false;
+		}
+		// Only start the worker once it is actually needed
+		if (!_multi) {
+			_multi = curl._multiInit();
+			if (!_multi) {
+				return false;
+			}
+			_thread = std::thread(&CurlRequestEngine::Run, this);
+		}
+		_queue.emplace_back(std::move(transfer));
+		// The worker might either be idle or waiting for ongoing
+		// transfers
+		if (curl._multiWakeup) {
+			curl._multiWakeup(_multi);
+		}
+	}
+	_cv.notify_one();
+	return true;
+}
+
+CurlResponse CurlRequestEngine::Perform(CurlRequest request)
+{
+	std::promise<CurlResponse> promise;
+	auto future = promise.get_future();
+	const bool submitted = Submit(
+		std::move(request), [&promise](const CurlResponse &response) {
+			promise.set_value(response);
+		});
+	if (!submitted) {
+		CurlResponse response;
+		response.error = CurlHelper::GetError(CURLE_FAILED_INIT);
+		if (CurlHelper::Initialized()) {
+			response.error = "request queue is full";
+		}
+		return response;
+	}
+	return future.get();
+}
+
+void CurlRequestEngine::Run()
+{
+	auto &curl = CurlHelper::GetInstance();
+	std::deque<std::unique_ptr<Transfer>> newTransfers;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() {
+				return _stop || !_queue.empty() ||
+				       !_active.empty();
+			});
+			if (_stop) {
+				newTransfers.swap(_queue);
+				break;
+			}
+			while (!_queue.empty() &&
+			       _active.size() + newTransfers.size() <
+				       _maxParallelTransfers) {
+				newTransfers.emplace_back(
+					std::move(_queue.front()));
+				_queue.pop_front();
+			}
+		}
+
+		StartTransfers(newTransfers);
+		int running = 0;
+		curl._multiPerform(_multi, &running);
+		FinishTransfers();
+		if (!_active.empty()) {
+			Wait();
+		}
+	}
+
+	for (auto &[handle, transfer] : _active) {
+		curl._multiRemoveHandle(_multi, handle);
+		Finish(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	_active.clear();
+	for (auto &transfer : newTransfers) {
+		Finish(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+	}
+	for (auto handle : _idleHandles) {
+		curl._cleanup(handle);
+	}
+	_idleHandles.clear();
+	_idleHandleCount = 0;
+	curl._multiCleanup(_multi);
+}
+
+void CurlRequestEngine::StartTransfers(
+	std::deque<std::unique_ptr<Transfer>> &transfers)
+{
+	auto &curl = CurlHelper::GetInstance();
+	for (auto &transfer : transfers) {
+		auto handle = GetHandle();
+		if (!handle) {
+			Finish(std::move(transfer), CURLE_FAILED_INIT);
+			continue;
+		}
+		transfer->handle = handle;
+
+		const auto &request = transfer->request;
+		curl._setopt(handle, CURLOPT_URL, request.url.c_str());
+		curl._setopt(handle, CURLOPT_NOSIGNAL, 1L);
+		curl._setopt(handle, CURLOPT_ERRORBUFFER,
+			     transfer->errorBuffer);
+		if (request.timeout.count() > 0) {
+			curl._setopt(handle, CURLOPT_TIMEOUT_MS,
+				     (long)request.timeout.count());
+		}
+		if (request.discardResponseBody) {
+			curl._setopt(handle, CURLOPT_WRITEFUNCTION,
+				     dropCallback);
+		} else {
+			curl._setopt(handle, CURLOPT_WRITEFUNCTION,
+				     writeCallback);
+			curl._setopt(handle, CURLOPT_WRITEDATA,
+				     &transfer->response);
+		}
+		for (const auto &header : request.headers) {
+			transfer->headers = curl._slistAppend(
+				transfer->headers, header.c_str());
+		}
+		if (transfer->headers) {
+			curl._setopt(handle, CURLOPT_HTTPHEADER,
+				     transfer->headers);
+		}
+		if (request.method == "GET") {
+			curl._setopt(handle, CURLOPT_HTTPGET, 1L);
+		} else {
+			if (request.method != "POST") {
+				curl._setopt(handle, CURLOPT_CUSTOMREQUEST,
+					     request.method.c_str());
+			}
+			if (request.method == "POST" || !request.body.empty()) {
+				curl._setopt(handle, CURLOPT_POSTFIELDSIZE,
+					     (long)request.body.size());
+				curl._setopt(handle, CURLOPT_POSTFIELDS,
+					     request.body.c_str());
+			}
+		}
+
+		if (curl._multiAddHandle(_multi, handle) != CURLM_OK) {
+			Finish(std::move(transfer), CURLE_FAILED_INIT);
+			continue;
+		}
+		_active.emplace(handle, std::move(transfer));
+	}
+	transfers.clear();
+}
+
+void CurlRequestEngine::FinishTransfers()
+{
+	auto &curl = CurlHelper::GetInstance();
+	int remaining = 0;
+	while (auto message = curl._multiInfoRead(_multi, &remaining)) {
+		if (message->msg != CURLMSG_DONE) {
+			continue;
+		}
+		// The message is invalidated once the handle is removed
+		auto handle = message->easy_handle;
+		const auto result = message->data.result;
+		auto it = _active.find(handle);
+		if (it == _active.end()) {
+			continue;
+		}
+		auto transfer = std::move(it->second);
+		_active.erase(it);
+		curl._multiRemoveHandle(_multi, handle);
+		Finish(std::move(transfer), result);
+	}
+}
+
+void CurlRequestEngine::Finish(std::unique_ptr<Transfer> transfer,
+			       CURLcode code)
+{
+	auto &curl = CurlHelper::GetInstance();
+	auto &response = transfer->response;
+	response.code = code;
+	if (code != CURLE_OK) {
+		response.error = transfer->errorBuffer[0] != '\0'
+					 ? transfer->errorBuffer
+					 : curl._error(code);
+	}
+	if (transfer->handle) {
+		curl._getinfo(transfer->handle, CURLINFO_RESPONSE_CODE,
+			      &response.status);
+		ReturnHandle(transfer->handle);
+	}
+	if (transfer->headers) {
+		curl._slistFreeAll(transfer->headers);
+	}
+	if (transfer->callback) {
+		transfer->callback(response);
+	}
+}
+
+void CurlRequestEngine::Wait()
+{
+	auto &curl = CurlHelper::GetInstance();
+	// Without curl_multi_poll() new requests cannot interrupt the wait, so
+	// only wait for a short time
+	if (curl._multiPoll && curl._multiWakeup) {
+		curl._multiPoll(_multi, nullptr, 0, 1000, nullptr);
+	} else {
+		curl._multiWait(_multi, nullptr, 0, 10, nullptr);
+	}
+}
+
+CURL *CurlRequestEngine::GetHandle()
+{
+	if (_idleHandles.empty()) {
+		return CurlHelper::GetInstance()._init();
+	}
+	auto handle = _idleHandles.back();
+	_idleHandles.pop_back();
+	_idleHandleCount = _idleHandles.size();
+	return handle;
+}
+
+void CurlRequestEngine::ReturnHandle(CURL *handle)
+{
+	auto &curl = CurlHelper::GetInstance();
+	if (_idleHandles.size() >= _maxParallelTransfers) {
+		curl._cleanup(handle);
+		return;
+	}
+	// Options refer to the data of the finished transfer, so reset them
+	curl._reset(handle);
+	_idleHandles.emplace_back(handle);
+	_idleHandleCount = _idleHandles.size();
+}
+
+CurlRequestEngine &GetCurlRequestEngine()
+{
+	// Make sure the curl library is unloaded only after the engine
+	// was destroyed
+	CurlHelper::Initialized();
+	static CurlRequestEngine engine;
+	return engine;
+}
+
+} // namespace advss
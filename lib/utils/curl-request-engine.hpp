@@ -0,0 +1,106 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+struct CurlRequest {
+	std::string url;
+	// "GET" and "POST" are handled natively, anything else is sent as a
+	// custom request method
+	std::string method = "GET";
+	std::string body;
+	// Complete header lines like "Content-Type: application/json"
+	std::vector<std::string> headers;
+	// A timeout of zero will use curl's default timeout
+	std::chrono::milliseconds timeout{0};
+	bool discardResponseBody = false;
+};
+
+struct CurlResponse {
+	CURLcode code = CURLE_FAILED_INIT;
+	long status = 0;
+	std::string body;
+	// Empty if the request succeeded
+	std::string error;
+};
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Performs requests in parallel on a single worker thread using the curl multi
+// interface.
+// Each request uses its own easy handle, which is taken from a pool of
+// previously used handles, so requests cannot affect each other's options.
+// DNS lookups and open connections are cached by the multi handle and shared
+// by all requests.
+class EXPORT CurlRequestEngine {
+public:
+	using Callback = std::function<void(const CurlResponse &)>;
+
+	CurlRequestEngine(size_t maxParallelTransfers = 16,
+			  size_t maxQueuedRequests = 256);
+	~CurlRequestEngine();
+	CurlRequestEngine(const CurlRequestEngine &) = delete;
+	CurlRequestEngine &operator=(const CurlRequestEngine &) = delete;
+
+	// The callback is invoked on the worker thread once the request is
+	// done, so it should return quickly.
+	// Returns false without invoking the callback if the request was
+	// rejected, as curl is not available or the queue is full.
+	bool Submit(CurlRequest, Callback = {});
+	// Blocks until the request is done
+	CurlResponse Perform(CurlRequest);
+
+	size_t GetIdleHandleCount() const { return _idleHandleCount; }
+
+private:
+	struct Transfer;
+
+	void Run();
+	void StartTransfers(std::deque<std::unique_ptr<Transfer>> &);
+	void FinishTransfers();
+	void Finish(std::unique_ptr<Transfer>, CURLcode);
+	void Wait();
+	CURL *GetHandle();
+	void ReturnHandle(CURL *);
+
+	const size_t _maxParallelTransfers;
+	const size_t _maxQueuedRequests;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<std::unique_ptr<Transfer>> _queue;
+	bool _stop = false;
+	std::thread _thread;
+	// Created along with the worker thread, which also cleans it up
+	CURLM *_multi = nullptr;
+
+	// Only accessed by the worker thread
+	std::unordered_map<CURL *, std::unique_ptr<Transfer>> _active;
+	std::vector<CURL *> _idleHandles;
+	std::atomic_size_t _idleHandleCount = 0;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+EXPORT CurlRequestEngine &GetCurlRequestEngine();
+
+} // namespace advss
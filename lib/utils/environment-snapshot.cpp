@@ -0,0 +1,145 @@
+#include "environment-snapshot.hpp"
+#include "utility.hpp"
+
+namespace advss {
+
+EnvironmentSnapshot &EnvironmentSnapshot::Get()
+{
+	static EnvironmentSnapshot snapshot;
+	return snapshot;
+}
+
+void EnvironmentSnapshot::Invalidate()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_windowQueryOptions.reset();
+	_windows.clear();
+	_currentWindowTitle.reset();
+	_processList.reset();
+	_foregroundProcessName.reset();
+	_foregroundProcessPath.reset();
+	_processPathsFromName.clear();
+	_isInFocus.clear();
+	_cursorPos.reset();
+	_secondsSinceLastInput.reset();
+}
+
+static bool isSubset(const WindowQueryOptions &options,
+		     const WindowQueryOptions &cached)
+{
+	return (!options.geometry || cached.geometry) &&
+	       (!options.focus || cached.focus) &&
+	       (!options.fullscreen || cached.fullscreen) &&
+	       (!options.maximized || cached.maximized) &&
+	       (!options.windowClass || cached.windowClass) &&
+	       (!options.text || cached.text);
+}
+
+static WindowQueryOptions merge(const WindowQueryOptions &a,
+				const WindowQueryOptions &b)
+{
+	WindowQueryOptions result;
+	result.geometry = a.geometry || b.geometry;
+	result.focus = a.focus || b.focus;
+	result.fullscreen = a.fullscreen || b.fullscreen;
+	result.maximized = a.maximized || b.maximized;
+	result.windowClass = a.windowClass || b.windowClass;
+	result.text = a.text || b.text;
+	return result;
+}
+
+std::vector<WindowInfo>
+EnvironmentSnapshot::GetWindows(const WindowQueryOptions &options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_windowQueryOptions && isSubset(options, *_windowQueryOptions)) {
+		return _windows;
+	}
+
+	// Query the attributes which were already requested during this
+	// interval as well to avoid alternating between different queries
+	const auto newOptions = _windowQueryOptions
+					? merge(options, *_windowQueryOptions)
+					: options;
+	_windows = advss::GetWindows(newOptions);
+	_windowQueryOptions = newOptions;
+	return _windows;
+}
+
+std::string EnvironmentSnapshot::GetCurrentWindowTitle()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_currentWindowTitle) {
+		_currentWindowTitle = advss::GetCurrentWindowTitle();
+	}
+	return *_currentWindowTitle;
+}
+
+QStringList EnvironmentSnapshot::GetProcessList()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_processList) {
+		_processList = advss::GetProcessList();
+	}
+	return *_processList;
+}
+
+std::string EnvironmentSnapshot::GetForegroundProcessName()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_foregroundProcessName) {
+		_foregroundProcessName = advss::GetForegroundProcessName();
+	}
+	return *_foregroundProcessName;
+}
+
+std::string EnvironmentSnapshot::GetForegroundProcessPath()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_foregroundProcessPath) {
+		_foregroundProcessPath = advss::GetForegroundProcessPath();
+	}
+	return *_foregroundProcessPath;
+}
+
+QStringList EnvironmentSnapshot::GetProcessPathsFromName(const QString &name)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _processPathsFromName.find(name);
+	if (it == _processPathsFromName.end()) {
+		const auto paths = advss::GetProcessPathsFromName(name);
+		it = _processPathsFromName.emplace(name, paths).first;
+	}
+	return it->second;
+}
+
+bool EnvironmentSnapshot::IsInFocus(const QString &executable)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _isInFocus.find(executable);
+	if (it == _isInFocus.end()) {
+		const bool inFocus = advss::IsInFocus(executable);
+		it = _isInFocus.emplace(executable, inFocus).first;
+	}
+	return it->second;
+}
+
+std::pair<int, int> EnvironmentSnapshot::GetCursorPos()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_cursorPos) {
+		_cursorPos = advss::GetCursorPos();
+	}
+	return *_cursorPos;
+}
+
+int EnvironmentSnapshot::SecondsSinceLastInput()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_secondsSinceLastInput) {
+		_secondsSinceLastInput = advss::SecondsSinceLastInput();
+	}
+	return *_secondsSinceLastInput;
+}
+
+} // namespace advss
@@ -0,0 +1,58 @@
+#pragma once
+#include "platform-funcs.hpp"
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace advss {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Caches the results of the potentially expensive platform queries, like
+// enumerating all running processes or windows, so they are performed at most
+// once per interval of the main loop, no matter how many conditions rely on
+// them.
+// The data is only queried on first access after the snapshot was invalidated.
+class EXPORT EnvironmentSnapshot {
+public:
+	static EnvironmentSnapshot &Get();
+
+	// Called at the start of each interval of the main loop
+	void Invalidate();
+
+	std::vector<WindowInfo> GetWindows(const WindowQueryOptions &options);
+	std::string GetCurrentWindowTitle();
+	QStringList GetProcessList();
+	std::string GetForegroundProcessName();
+	std::string GetForegroundProcessPath();
+	QStringList GetProcessPathsFromName(const QString &name);
+	bool IsInFocus(const QString &executable);
+	std::pair<int, int> GetCursorPos();
+	int SecondsSinceLastInput();
+
+private:
+	EnvironmentSnapshot() = default;
+
+	std::mutex _mutex;
+	std::optional<WindowQueryOptions> _windowQueryOptions;
+	std::vector<WindowInfo> _windows;
+	std::optional<std::string> _currentWindowTitle;
+	std::optional<QStringList> _processList;
+	std::optional<std::string> _foregroundProcessName;
+	std::optional<std::string> _foregroundProcessPath;
+	std::map<QString, QStringList> _processPathsFromName;
+	std::map<QString, bool> _isInFocus;
+	std::optional<std::pair<int, int>> _cursorPos;
+	std::optional<int> _secondsSinceLastInput;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace advss
@@ -0,0 +1,506 @@
+#include "frame-provider.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+
+namespace advss {
+
+// Areas which were not requested for this long are no longer captured
+constexpr auto interestTimeout = std::chrono::seconds(10);
+// Limits the number of render targets kept around for reuse
+constexpr size_t maxIdleTargets = 8;
+
+static bool setup();
+static bool setupDone = setup();
+
+bool setup()
+{
+	AddPluginCleanupStep([]() { GetFrameProvider().Clear(); });
+	return true;
+}
+
+static QRect getSourceBounds(obs_source_t *source)
+{
+	if (source) {
+		return QRect(0, 0, obs_source_get_base_width(source),
+			     obs_source_get_base_height(source));
+	}
+	obs_video_info ovi;
+	if (!obs_get_video_info(&ovi)) {
+		return QRect();
+	}
+	return QRect(0, 0, ovi.base_width, ovi.base_height);
+}
+
+static QRect getCaptureArea(const QRect &area, const QRect &bounds)
+{
+	if (area.isEmpty()) {
+		return bounds;
+	}
+	return area & bounds;
+}
+
+static void render(obs_source_t *source, const QRect &area,
+		   gs_texrender_t *texrender)
+{
+	gs_texrender_reset(texrender);
+	if (!gs_texrender_begin(texrender, area.width(), area.height())) {
+		return;
+	}
+
+	vec4 zero;
+	vec4_zero(&zero);
+
+	gs_clear(GS_CLEAR_COLOR, &zero, 0.0f, 0);
+	gs_ortho((float)(area.left()), (float)(area.right() + 1),
+		 (float)(area.top()), (float)(area.bottom() + 1), -100.0f,
+		 100.0f);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+
+	if (source) {
+		obs_source_inc_showing(source);
+		obs_source_video_render(source);
+		obs_source_dec_showing(source);
+	} else {
+		obs_render_main_texture();
+	}
+
+	gs_blend_state_pop();
+	gs_texrender_end(texrender);
+}
+
+static QImage download(gs_stagesurf_t *stagesurf, uint32_t cx, uint32_t cy)
+{
+	QImage image(cx, cy, QImage::Format::Format_RGBA8888);
+	uint8_t *videoData = nullptr;
+	uint32_t videoLinesize = 0;
+	if (!gs_stagesurface_map(stagesurf, &videoData, &videoLinesize)) {
+		return QImage();
+	}
+	const int linesize = image.bytesPerLine();
+	for (int y = 0; y < (int)cy; y++) {
+		memcpy(image.scanLine(y), videoData + (y * videoLinesize),
+		       linesize);
+	}
+	gs_stagesurface_unmap(stagesurf);
+	return image;
+}
+
+FrameSubscription::FrameSubscription(const QRect &area,
+				     std::chrono::milliseconds interval)
+	: _area(area),
+	  _interval(interval),
+	  _lastAccess(Clock::now())
+{
+}
+
+VideoFramePtr FrameSubscription::GetLatestFrame()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_lastAccess = Clock::now();
+	return _latestFrame;
+}
+
+void FrameSubscription::Publish(const VideoFramePtr &frame)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_latestFrame = frame;
+}
+
+bool FrameSubscription::IsActive(Clock::time_point now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return now - _lastAccess <= interestTimeout;
+}
+
+std::shared_future<VideoFramePtr>
+FrameProvider::Request(const OBSWeakSource &source, const QRect &area,
+		       std::chrono::milliseconds maxAge)
+{
+	// Registering the tick callback must not happen while holding the
+	// lock, as the tick callback itself acquires it
+	if (!_tickRegistered.exchange(true)) {
+		obs_add_tick_callback(Tick, this);
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto &state = _sources[source];
+	if (!state.source) {
+		state.source = source;
+	}
+
+	const auto now = Clock::now();
+	auto interest = std::find_if(state.interests.begin(),
+				     state.interests.end(),
+				     [&area](const auto &interest) {
+					     return interest.first == area;
+				     });
+	if (interest != state.interests.end()) {
+		interest->second = now;
+	} else {
+		state.interests.emplace_back(area, now);
+	}
+
+	if (maxAge.count() > 0 && now - state.captureTime <= maxAge) {
+		if (auto frame = GetFrame(state, area)) {
+			std::promise<VideoFramePtr> promise;
+			promise.set_value(frame);
+			return promise.get_future().share();
+		}
+	}
+
+	for (const auto &request : state.pending) {
+		if (request.area == area) {
+			return request.future;
+		}
+	}
+	PendingRequest request;
+	request.area = area;
+	request.future = request.promise.get_future().share();
+	auto future = request.future;
+	state.pending.emplace_back(std::move(request));
+	return future;
+}
+
+std::shared_ptr<FrameSubscription>
+FrameProvider::Subscribe(const OBSWeakSource &source, const QRect &area,
+			 std::chrono::milliseconds interval)
+{
+	if (!_tickRegistered.exchange(true)) {
+		obs_add_tick_callback(Tick, this);
+	}
+
+	std::shared_ptr<FrameSubscription> subscription(
+		new FrameSubscription(area, interval));
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto &state = _sources[source];
+	if (!state.source) {
+		state.source = source;
+	}
+	state.subscriptions.emplace_back(subscription);
+	return subscription;
+}
+
+void FrameProvider::Clear()
+{
+	if (_tickRegistered.exchange(false)) {
+		obs_remove_tick_callback(Tick, this);
+	}
+
+	obs_enter_graphics();
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto &[key, state] : _sources) {
+		for (const auto &staged : state.staged) {
+			_idleTargets.emplace_back(staged.target);
+		}
+		for (auto &request : state.pending) {
+			request.promise.set_value(
+				std::make_shared<VideoFrame>());
+		}
+	}
+	_sources.clear();
+	for (const auto &target : _idleTargets) {
+		gs_stagesurface_destroy(target.stagesurf);
+		gs_texrender_destroy(target.texrender);
+	}
+	_idleTargets.clear();
+	obs_leave_graphics();
+}
+
+void FrameProvider::Tick(void *param, float)
+{
+	auto provider = static_cast<FrameProvider *>(param);
+	if (!provider->HasWork()) {
+		return;
+	}
+
+	obs_enter_graphics();
+	{
+		std::lock_guard<std::mutex> lock(provider->_mutex);
+		// Read back the captures staged in the previous tick first,
+		// to give the GPU time to finish copying them
+		provider->FinishCaptures();
+		provider->StartCaptures();
+	}
+	obs_leave_graphics();
+}
+
+bool FrameProvider::HasWork()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	RemoveUnusedSources();
+	return std::any_of(_sources.begin(), _sources.end(),
+			   [](const auto &entry) {
+				   return !entry.second.pending.empty() ||
+					  !entry.second.staged.empty() ||
+					  !entry.second.subscriptions.empty();
+			   });
+}
+
+void FrameProvider::FinishCaptures()
+{
+	for (auto &[key, state] : _sources) {
+		if (state.staged.empty()) {
+			continue;
+		}
+
+		state.captures.clear();
+		state.frames.clear();
+		for (const auto &staged : state.staged) {
+			state.captures.push_back(
+				{staged.area, download(staged.target.stagesurf,
+						       staged.target.cx,
+						       staged.target.cy)});
+			ReturnRenderTarget(staged.target);
+		}
+		state.staged.clear();
+		state.captureTime = Clock::now();
+		DistributeFrames(state);
+	}
+}
+
+void FrameProvider::StartCaptures()
+{
+	const auto now = Clock::now();
+	for (auto &[key, state] : _sources) {
+		if (!state.staged.empty() ||
+		    (state.pending.empty() && !SubscriptionsDue(state, now))) {
+			continue;
+		}
+
+		OBSSource source = OBSGetStrongRef(state.source);
+		if (key && !source) {
+			state.captures.clear();
+			state.frames.clear();
+			state.bounds = QRect();
+			state.captureTime = now;
+			DistributeFrames(state);
+			continue;
+		}
+
+		// Also capture the areas other consumers recently asked for,
+		// as they will likely request them again soon.
+		// The areas of pending requests are always part of these.
+		state.bounds = getSourceBounds(source);
+		std::vector<QRect> areas;
+		for (const auto &[area, time] : state.interests) {
+			const auto captureArea =
+				getCaptureArea(area, state.bounds);
+			if (!captureArea.isEmpty()) {
+				areas.emplace_back(captureArea);
+			}
+		}
+		for (const auto &weakSubscription : state.subscriptions) {
+			auto subscription = weakSubscription.lock();
+			if (!subscription || !subscription->IsActive(now)) {
+				continue;
+			}
+			subscription->_lastCapture = now;
+			const auto captureArea = getCaptureArea(
+				subscription->_area, state.bounds);
+			if (!captureArea.isEmpty()) {
+				areas.emplace_back(captureArea);
+			}
+		}
+
+		for (const auto &area : MergeOverlappingAreas(areas)) {
+			auto target =
+				GetRenderTarget(area.width(), area.height());
+			render(source, area, target.texrender);
+			gs_stage_texture(
+				target.stagesurf,
+				gs_texrender_get_texture(target.texrender));
+			state.staged.push_back({area, target});
+		}
+
+		if (state.staged.empty()) {
+			vblog(LOG_WARNING,
+			      "Cannot capture \"%s\", invalid target size",
+			      obs_source_get_name(source));
+			state.captures.clear();
+			state.frames.clear();
+			state.captureTime = now;
+			DistributeFrames(state);
+		}
+	}
+}
+
+void FrameProvider::RemoveUnusedSources()
+{
+	const auto now = Clock::now();
+	for (auto it = _sources.begin(); it != _sources.end();) {
+		auto &state = it->second;
+		state.subscriptions.erase(
+			std::remove_if(state.subscriptions.begin(),
+				       state.subscriptions.end(),
+				       [](const auto &subscription) {
+					       return subscription.expired();
+				       }),
+			state.subscriptions.end());
+		state.interests.erase(
+			std::remove_if(state.interests.begin(),
+				       state.interests.end(),
+				       [&now](const auto &interest) {
+					       return now - interest.second >
+						      interestTimeout;
+				       }),
+			state.interests.end());
+		if (state.interests.empty() && state.pending.empty() &&
+		    state.subscriptions.empty() && state.staged.empty()) {
+			it = _sources.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+bool FrameProvider::SubscriptionsDue(SourceState &state, Clock::time_point now)
+{
+	for (const auto &weakSubscription : state.subscriptions) {
+		auto subscription = weakSubscription.lock();
+		if (subscription && subscription->IsActive(now) &&
+		    now - subscription->_lastCapture >=
+			    subscription->_interval) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FrameProvider::DistributeFrames(SourceState &state)
+{
+	for (const auto &weakSubscription : state.subscriptions) {
+		auto subscription = weakSubscription.lock();
+		if (!subscription) {
+			continue;
+		}
+		if (auto frame = GetFrame(state, subscription->_area)) {
+			subscription->Publish(frame);
+		}
+	}
+
+	// Requests made while a capture was in progress might not be covered
+	// by it, so these are kept for the next capture
+	for (auto it = state.pending.begin(); it != state.pending.end();) {
+		auto frame = GetFrame(state, it->area);
+		if (frame) {
+			it->promise.set_value(frame);
+			it = state.pending.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+VideoFramePtr FrameProvider::GetFrame(SourceState &state, const QRect &area)
+{
+	if (state.captureTime == Clock::time_point()) {
+		return nullptr;
+	}
+
+	for (const auto &[frameArea, frame] : state.frames) {
+		if (frameArea == area) {
+			return frame;
+		}
+	}
+
+	// An area outside of the source results in an empty image
+	QImage image;
+	const auto captureArea = getCaptureArea(area, state.bounds);
+	if (!captureArea.isEmpty()) {
+		auto capture = std::find_if(
+			state.captures.begin(), state.captures.end(),
+			[&captureArea](const Capture &capture) {
+				return capture.area.contains(captureArea);
+			});
+		if (capture == state.captures.end()) {
+			return nullptr;
+		}
+		if (capture->area == captureArea) {
+			image = capture->image;
+		} else {
+			image = capture->image.copy(captureArea.translated(
+				-capture->area.topLeft()));
+		}
+	}
+
+	auto frame = std::make_shared<VideoFrame>(
+		VideoFrame{image, state.captureTime});
+	state.frames.emplace_back(area, frame);
+	return frame;
+}
+
+FrameProvider::RenderTarget FrameProvider::GetRenderTarget(uint32_t cx,
+							   uint32_t cy)
+{
+	auto it = std::find_if(_idleTargets.begin(), _idleTargets.end(),
+			       [cx, cy](const RenderTarget &target) {
+				       return target.cx == cx &&
+					      target.cy == cy;
+			       });
+	if (it != _idleTargets.end()) {
+		auto target = *it;
+		_idleTargets.erase(it);
+		return target;
+	}
+
+	// The texture render resizes itself as needed, so only the staging
+	// surface has to be recreated
+	RenderTarget target;
+	if (!_idleTargets.empty()) {
+		target = _idleTargets.back();
+		_idleTargets.pop_back();
+		gs_stagesurface_destroy(target.stagesurf);
+	} else {
+		target.texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	}
+	target.stagesurf = gs_stagesurface_create(cx, cy, GS_RGBA);
+	target.cx = cx;
+	target.cy = cy;
+	return target;
+}
+
+void FrameProvider::ReturnRenderTarget(const RenderTarget &target)
+{
+	if (_idleTargets.size() >= maxIdleTargets) {
+		gs_stagesurface_destroy(target.stagesurf);
+		gs_texrender_destroy(target.texrender);
+		return;
+	}
+	_idleTargets.emplace_back(target);
+}
+
+FrameProvider &GetFrameProvider()
+{
+	static FrameProvider provider;
+	return provider;
+}
+
+std::vector<QRect> MergeOverlappingAreas(const std::vector<QRect> &areas)
+{
+	std::vector<QRect> result;
+	for (auto area : areas) {
+		// Merging two areas might cause the result to overlap with
+		// areas which were previously disjoint
+		bool merged = true;
+		while (merged) {
+			merged = false;
+			for (auto it = result.begin(); it != result.end();
+			     ++it) {
+				if (it->intersects(area)) {
+					area |= *it;
+					result.erase(it);
+					merged = true;
+					break;
+				}
+			}
+		}
+		result.emplace_back(area);
+	}
+	return result;
+}
+
+} // namespace advss
@@ -0,0 +1,154 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <obs.hpp>
+#include <QImage>
+#include <QRect>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace advss {
+
+struct VideoFrame {
+	QImage image;
+	std::chrono::high_resolution_clock::time_point time;
+};
+
+// Frames are shared by all consumers and must not be modified
+using VideoFramePtr = std::shared_ptr<const VideoFrame>;
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+class FrameProvider;
+
+// Continuously receives frames of an area of a source at a fixed rate.
+// Frames are only captured while the subscription is in use, so it is
+// paused if no frame was requested for a while.
+class EXPORT FrameSubscription {
+public:
+	// Returns the newest frame without waiting for a capture.
+	// Returns nullptr if no frame was captured yet.
+	VideoFramePtr GetLatestFrame();
+
+private:
+	using Clock = std::chrono::high_resolution_clock;
+
+	FrameSubscription(const QRect &area,
+			  std::chrono::milliseconds interval);
+	void Publish(const VideoFramePtr &);
+	bool IsActive(Clock::time_point now);
+
+	const QRect _area;
+	const std::chrono::milliseconds _interval;
+	// Only accessed by the frame provider while holding its lock
+	Clock::time_point _lastCapture;
+
+	std::mutex _mutex;
+	VideoFramePtr _latestFrame;
+	Clock::time_point _lastAccess;
+
+	friend FrameProvider;
+};
+
+// Captures frames of sources, or of the main output if no source is given, on
+// behalf of any number of consumers.
+// Each source is rendered and read back at most once per tick, no matter how
+// many consumers request a frame of it.
+// Areas of a source which were recently requested and overlap each other are
+// captured using a single readback, from which the frames of the individual
+// areas are cut out.
+class EXPORT FrameProvider {
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	FrameProvider() = default;
+	FrameProvider(const FrameProvider &) = delete;
+	FrameProvider &operator=(const FrameProvider &) = delete;
+
+	// An empty area refers to the whole source.
+	// If a frame covering the area was captured within the last "maxAge"
+	// it is returned right away, otherwise the request will be completed
+	// by the next capture.
+	std::shared_future<VideoFramePtr>
+	Request(const OBSWeakSource &, const QRect &area = QRect(),
+		std::chrono::milliseconds maxAge = {});
+	// Captures the area every "interval" until the returned subscription
+	// is destroyed
+	std::shared_ptr<FrameSubscription>
+	Subscribe(const OBSWeakSource &, const QRect &area,
+		  std::chrono::milliseconds interval);
+	// Completes all pending requests with empty frames and frees all
+	// graphics resources
+	void Clear();
+
+private:
+	struct RenderTarget {
+		gs_texrender_t *texrender = nullptr;
+		gs_stagesurf_t *stagesurf = nullptr;
+		uint32_t cx = 0;
+		uint32_t cy = 0;
+	};
+	struct StagedCapture {
+		QRect area;
+		RenderTarget target;
+	};
+	struct Capture {
+		QRect area;
+		QImage image;
+	};
+	struct PendingRequest {
+		QRect area;
+		std::promise<VideoFramePtr> promise;
+		std::shared_future<VideoFramePtr> future;
+	};
+	struct SourceState {
+		OBSWeakSource source;
+		// Requested areas and when they were last requested
+		std::vector<std::pair<QRect, Clock::time_point>> interests;
+		std::vector<PendingRequest> pending;
+		std::vector<std::weak_ptr<FrameSubscription>> subscriptions;
+		std::vector<StagedCapture> staged;
+		// Result of the last capture
+		std::vector<Capture> captures;
+		QRect bounds;
+		Clock::time_point captureTime;
+		std::vector<std::pair<QRect, VideoFramePtr>> frames;
+	};
+
+	static void Tick(void *, float);
+	bool HasWork();
+	void FinishCaptures();
+	void StartCaptures();
+	void RemoveUnusedSources();
+	bool SubscriptionsDue(SourceState &, Clock::time_point now);
+	void DistributeFrames(SourceState &);
+	VideoFramePtr GetFrame(SourceState &, const QRect &area);
+	RenderTarget GetRenderTarget(uint32_t cx, uint32_t cy);
+	void ReturnRenderTarget(const RenderTarget &);
+
+	std::mutex _mutex;
+	std::map<obs_weak_source_t *, SourceState> _sources;
+	std::vector<RenderTarget> _idleTargets;
+	std::atomic_bool _tickRegistered = {false};
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+EXPORT FrameProvider &GetFrameProvider();
+
+// Combines overlapping areas to their bounding rectangle
+EXPORT std::vector<QRect> MergeOverlappingAreas(const std::vector<QRect> &);
+
+} // namespace advss
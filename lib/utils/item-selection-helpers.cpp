@@ -4,6 +4,9 @@
 #include "ui-helpers.hpp"
 
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <QAction>
 #include <QLayout>
@@ -16,21 +19,10 @@ namespace advss {
 
 Item::Item(std::string name) : _name(name) {}
 
-static Item *GetItemByName(const std::string &name,
-			   std::deque<std::shared_ptr<Item>> &items)
-{
-	for (auto &item : items) {
-		if (item->Name() == name) {
-			return item.get();
-		}
-	}
-	return nullptr;
-}
-
 static Item *GetItemByName(const QString &name,
 			   std::deque<std::shared_ptr<Item>> &items)
 {
-	return GetItemByName(name.toStdString(), items);
+	return GetItemByName(items, name.toStdString()).get();
 }
 
 static bool ItemNameAvailable(const QString &name,
@@ -93,7 +85,7 @@ ItemSelection::ItemSelection(std::deque<std::shared_ptr<Item>> &items,
 
 void ItemSelection::SetItem(const std::string &item)
 {
-	if (!!GetItemByName(item, _items)) {
+	if (!!GetItemByName(_items, item)) {
 		_selection->setCurrentText(QString::fromStdString(item));
 		if (_selection->lineEdit()) {
 			_selection->lineEdit()->setText(
@@ -119,6 +111,7 @@ void ItemSelection::ChangeSelection(const QString &sel)
 			return;
 		}
 		_items.emplace_back(item);
+		InvalidateItemNameIndex(_items);
 		const QString name = QString::fromStdString(item->_name);
 		AddItem(name);
 		_selection->setCurrentText(name);
@@ -147,6 +140,7 @@ void ItemSelection::ModifyButtonClicked()
 			return;
 		}
 		if (oldName != item->_name) {
+			InvalidateItemNameIndex(_items);
 			emit ItemRenamed(QString::fromStdString(oldName),
 					 QString::fromStdString(item->_name));
 		}
@@ -202,6 +196,7 @@ void ItemSelection::RenameItem()
 
 	const auto oldName = item->_name;
 	item->_name = name;
+	InvalidateItemNameIndex(_items);
 	SetItem(name);
 	emit ItemRenamed(QString::fromStdString(oldName),
 			 QString::fromStdString(name));
@@ -246,6 +241,7 @@ void ItemSelection::RemoveItem()
 			break;
 		}
 	}
+	InvalidateItemNameIndex(_items);
 
 	emit ItemRemoved(QString::fromStdString(name));
 }
@@ -361,18 +357,125 @@ void Item::Save(obs_data_t *obj) const
 	obs_data_set_string(obj, "name", _name.c_str());
 }
 
+namespace {
+
+// Maps item names to the items of a list.
+// The index is rebuilt on the first lookup after it was invalidated, which
+// happens whenever items are added, renamed, or removed, so lookups of unknown
+// names do not have to search the list.
+// Changes which are not reported, like loading the settings, are detected by
+// the size or the first or last element of the list changing.
+class ItemNameIndex {
+public:
+	std::shared_ptr<Item>
+	Find(const std::deque<std::shared_ptr<Item>> &items,
+	     const std::string &name);
+	void Invalidate();
+
+private:
+	bool IsOutdated(const std::deque<std::shared_ptr<Item>> &items) const;
+	void Rebuild(const std::deque<std::shared_ptr<Item>> &items);
+
+	std::mutex _mutex;
+	bool _valid = false;
+	std::unordered_map<std::string, std::weak_ptr<Item>> _items;
+	size_t _size = 0;
+	const Item *_front = nullptr;
+	const Item *_back = nullptr;
+};
+
+} // namespace
+
+bool ItemNameIndex::IsOutdated(
+	const std::deque<std::shared_ptr<Item>> &items) const
+{
+	if (!_valid || items.size() != _size) {
+		return true;
+	}
+	return _size > 0 && (items.front().get() != _front ||
+			     items.back().get() != _back);
+}
+
+void ItemNameIndex::Rebuild(const std::deque<std::shared_ptr<Item>> &items)
+{
+	_items.clear();
+	for (const auto &item : items) {
+		// Keep the first occurrence to match a linear search
+		_items.emplace(item->Name(), item);
+	}
+	_size = items.size();
+	_front = _size > 0 ? items.front().get() : nullptr;
+	_back = _size > 0 ? items.back().get() : nullptr;
+	_valid = true;
+}
+
+void ItemNameIndex::Invalidate()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_valid = false;
+}
+
+std::shared_ptr<Item>
+ItemNameIndex::Find(const std::deque<std::shared_ptr<Item>> &items,
+		    const std::string &name)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (IsOutdated(items)) {
+		Rebuild(items);
+	}
+
+	auto it = _items.find(name);
+	if (it == _items.end()) {
+		return nullptr;
+	}
+	auto item = it->second.lock();
+	if (item && item->Name() == name) {
+		return item;
+	}
+
+	// The item was renamed or removed without the index being invalidated
+	Rebuild(items);
+	it = _items.find(name);
+	return it != _items.end() ? it->second.lock() : nullptr;
+}
+
+static ItemNameIndex &
+getItemNameIndex(const std::deque<std::shared_ptr<Item>> &items)
+{
+	static std::mutex mutex;
+	static std::unordered_map<const void *, ItemNameIndex> indices;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return indices[&items];
+}
+
+std::shared_ptr<Item>
+GetItemByName(const std::deque<std::shared_ptr<Item>> &items,
+	      const std::string &name)
+{
+	return getItemNameIndex(items).Find(items, name);
+}
+
+void InvalidateItemNameIndex(const std::deque<std::shared_ptr<Item>> &items)
+{
+	getItemNameIndex(items).Invalidate();
+}
+
 void RemoveItemsByName(std::deque<std::shared_ptr<Item>> &items,
 		       const QStringList &names)
 {
+	std::unordered_set<std::string> namesToRemove;
 	for (const auto &name : names) {
-		items.erase(std::remove_if(
-				    items.begin(), items.end(),
-				    [name](const std::shared_ptr<Item> &item) {
-					    return item->Name() ==
-						   name.toStdString();
-				    }),
-			    items.end());
+		namesToRemove.insert(name.toStdString());
 	}
+	items.erase(std::remove_if(items.begin(), items.end(),
+				   [&namesToRemove](
+					   const std::shared_ptr<Item> &item) {
+					   return namesToRemove.count(
+						   item->Name()) > 0;
+				   }),
+		    items.end());
+	InvalidateItemNameIndex(items);
 }
 
 } // namespace advss
@@ -34,6 +34,16 @@ protected:
 
 void EXPORT RemoveItemsByName(std::deque<std::shared_ptr<Item>> &items,
 			      const QStringList &names);
+// Lookups are served from a name index, which is maintained for each list of
+// items and rebuilt once the list was changed
+std::shared_ptr<Item> EXPORT
+GetItemByName(const std::deque<std::shared_ptr<Item>> &items,
+	      const std::string &name);
+// Has to be called whenever items are added to, removed from, or renamed in
+// the given list, which is done when the signals of the corresponding signal
+// manager are emitted
+void EXPORT
+InvalidateItemNameIndex(const std::deque<std::shared_ptr<Item>> &items);
 
 class ItemSettingsDialog : public QDialog {
 	Q_OBJECT
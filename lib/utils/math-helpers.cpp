@@ -1,21 +1,237 @@
 #include "math-helpers.hpp"
 #include "obs-module-helper.hpp"
+#include "variable-string.hpp"
 
+#include <cctype>
 #include <climits>
+#include <deque>
 #include <exprtk.hpp>
+#include <list>
+#include <mutex>
 #include <random>
+#include <unordered_map>
 
 namespace advss {
 
-std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+static double randomFunc()
 {
-	static auto randomFunc = []() {
-		thread_local std::mt19937 gen(std::random_device{}());
-		thread_local std::uniform_real_distribution<double> dis(0.0,
-									1.0);
-		return dis(gen);
+	thread_local std::mt19937 gen(std::random_device{}());
+	thread_local std::uniform_real_distribution<double> dis(0.0, 1.0);
+	return dis(gen);
+}
+
+namespace {
+
+// Compiled form of an expression in which variable references were replaced
+// by symbols bound to the values of the variables
+struct CompiledExpression {
+	struct Binding {
+		std::weak_ptr<Variable> variable;
+		// Empty until the value was read outside of a variable context
+		std::optional<uint64_t> version;
+		// Empty if the value of the variable cannot be bound
+		std::optional<double> value;
+		// Value referenced by the symbol
+		double boundValue = 0.0;
 	};
 
+	bool valid = false;
+	uint64_t variableListVersion = 0;
+	// A deque keeps the bound values at stable addresses
+	std::deque<Binding> bindings;
+	exprtk::symbol_table<double> symbolTable;
+	exprtk::expression<double> expression;
+};
+
+// Least recently used compiled expressions keyed by the unresolved expression
+class CompiledExpressionCache {
+public:
+	CompiledExpression *Get(const std::string &expression);
+
+private:
+	static constexpr size_t _maxSize = 256;
+
+	using Entry =
+		std::pair<std::string, std::unique_ptr<CompiledExpression>>;
+	std::list<Entry> _entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+};
+
+} // namespace
+
+static bool isOperandChar(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+	       c == '.' || c == '$' || c == '{' || c == '}' || c == '\'';
+}
+
+// Binding a variable reference as a symbol only yields the same result as
+// substituting its value if it is not directly adjacent to other operands,
+// e.g. "1${var}" or "${var}(2)"
+static bool canBeBound(const std::string &expression,
+		       const VariableReferences::Match &match)
+{
+	if (match.begin > 0 && isOperandChar(expression[match.begin - 1])) {
+		return false;
+	}
+	if (match.end < expression.size() &&
+	    (isOperandChar(expression[match.end]) ||
+	     expression[match.end] == '(' || expression[match.end] == '[')) {
+		return false;
+	}
+	return true;
+}
+
+// Only values consisting of digits, an optional decimal point and an optional
+// exponent are bound, as only those are parsed as a single operand if
+// substituted as text.
+// For example "-2" would change "${var}^2" to "-2^2", which is -4, while the
+// bound value would result in 4.
+static std::optional<double> getBindableValue(const std::string &value)
+{
+	size_t pos = 0;
+	const auto skipDigits = [&value, &pos]() {
+		const size_t begin = pos;
+		while (pos < value.size() &&
+		       std::isdigit(static_cast<unsigned char>(value[pos]))) {
+			pos++;
+		}
+		return pos - begin;
+	};
+
+	size_t digits = skipDigits();
+	if (pos < value.size() && value[pos] == '.') {
+		pos++;
+		digits += skipDigits();
+	}
+	if (digits == 0) {
+		return {};
+	}
+	if (pos < value.size() && (value[pos] == 'e' || value[pos] == 'E')) {
+		pos++;
+		if (pos < value.size() &&
+		    (value[pos] == '+' || value[pos] == '-')) {
+			pos++;
+		}
+		if (skipDigits() == 0) {
+			return {};
+		}
+	}
+	if (pos != value.size()) {
+		return {};
+	}
+	return GetDouble(value);
+}
+
+static std::unique_ptr<CompiledExpression>
+compileExpression(const std::string &expression)
+{
+	auto result = std::make_unique<CompiledExpression>();
+	result->variableListVersion = GetVariableListVersion();
+	result->symbolTable.add_function("random", randomFunc);
+
+	std::string text;
+	size_t literalBegin = 0;
+	const auto matches =
+		VariableReferences(expression).FindVariables(expression);
+	for (const auto &match : matches) {
+		if (!canBeBound(expression, match)) {
+			return result;
+		}
+
+		auto &binding = result->bindings.emplace_back();
+		binding.variable = match.variable;
+
+		const auto symbol = "advss_variable_" +
+				    std::to_string(result->bindings.size());
+		result->symbolTable.add_variable(symbol, binding.boundValue);
+		text.append(expression, literalBegin,
+			    match.begin - literalBegin);
+		text.append(symbol);
+		literalBegin = match.end;
+	}
+	text.append(expression, literalBegin, std::string::npos);
+
+	result->expression.register_symbol_table(result->symbolTable);
+	exprtk::parser<double> parser;
+	result->valid = parser.compile(text, result->expression);
+	return result;
+}
+
+CompiledExpression *CompiledExpressionCache::Get(const std::string &expression)
+{
+	auto it = _index.find(expression);
+	if (it != _index.end()) {
+		_entries.splice(_entries.begin(), _entries, it->second);
+		auto &compiled = it->second->second;
+		if (compiled->variableListVersion != GetVariableListVersion()) {
+			compiled = compileExpression(expression);
+		}
+		return compiled.get();
+	}
+
+	_entries.emplace_front(expression, compileExpression(expression));
+	_index[expression] = _entries.begin();
+	if (_entries.size() > _maxSize) {
+		_index.erase(_entries.back().first);
+		_entries.pop_back();
+	}
+	return _entries.front().second.get();
+}
+
+// Returns false if any of the variables currently has a value which cannot be
+// bound, in which case the expression has to be evaluated as text
+static bool updateBindings(CompiledExpression &compiled)
+{
+	// Values of an active variable context, e.g. of an action queue, are
+	// not reflected in the version of the variable, so they are not cached
+	const bool contextActive = IsVariableContextActive();
+	for (auto &binding : compiled.bindings) {
+		auto variable = binding.variable.lock();
+		if (!variable) {
+			return false;
+		}
+		variable->MarkAsUsed();
+		std::optional<double> value;
+		if (contextActive) {
+			value = getBindableValue(variable->Value(false));
+		} else {
+			const auto version = variable->GetVersion();
+			if (version != binding.version) {
+				binding.version = version;
+				binding.value = getBindableValue(
+					variable->Value(false));
+			}
+			value = binding.value;
+		}
+		if (!value) {
+			return false;
+		}
+		binding.boundValue = *value;
+	}
+	return true;
+}
+
+std::variant<double, std::string>
+EvalMathExpressionWithVariables(const StringVariable &expression)
+{
+	static std::mutex mutex;
+	static CompiledExpressionCache cache;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto compiled = cache.Get(expression.UnresolvedValue());
+		if (compiled->valid && updateBindings(*compiled)) {
+			return compiled->expression.value();
+		}
+	}
+
+	// Variables which cannot be bound, like non-numeric or negative
+	// values, are substituted as text instead
+	return EvalMathExpression(std::string(expression));
+}
+
+std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+{
 	exprtk::symbol_table<double> symbolTable;
 	symbolTable.add_function("random", randomFunc);
 
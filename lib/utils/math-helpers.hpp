@@ -7,8 +7,14 @@
 
 namespace advss {
 
+class StringVariable;
+
 std::variant<double, std::string>
 EvalMathExpression(const std::string &expression);
+// Variables referenced in the expression are bound as symbols, so the compiled
+// expression can be reused when their values change
+std::variant<double, std::string>
+EvalMathExpressionWithVariables(const StringVariable &expression);
 bool IsValidNumber(const std::string &str);
 EXPORT std::optional<double> GetDouble(const std::string &str);
 EXPORT std::optional<int> GetInt(const std::string &str);
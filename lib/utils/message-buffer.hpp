@@ -1,49 +1,240 @@
 #pragma once
-#include <deque>
-#include <mutex>
-#include <optional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
 namespace advss {
 
+// Bounded lock-free queue of messages.
+// Multiple threads can append messages while a single consumer, usually a
+// macro segment, consumes them.
+// Messages are stored as immutable shared handles, so the same message can be
+// handed to many buffers without being copied.
+// All slots are allocated up front, so the capacity should be chosen based on
+// the expected message rate.
 template<class T> class MessageBuffer {
 public:
-	bool Empty();
+	using Message = std::shared_ptr<const T>;
+
+	enum class OverflowPolicy {
+		// Remove the oldest message to make room for the new one
+		DROP_OLDEST,
+		// Discard the new message
+		DROP_NEWEST,
+		// Wait for the consumer to make room, but drop the new message
+		// if that does not happen within the block timeout, as the
+		// consumer might not exist anymore
+		BLOCK,
+	};
+
+	static constexpr size_t defaultCapacity = 1024;
+
+	MessageBuffer(size_t capacity = defaultCapacity,
+		      OverflowPolicy policy = OverflowPolicy::DROP_OLDEST,
+		      std::chrono::milliseconds blockTimeout =
+			      std::chrono::milliseconds(1000));
+
+	bool Empty() const;
 	void Clear();
 	void AppendMessage(const T &);
-	std::optional<T> ConsumeMessage();
+	void AppendMessage(T &&);
+	void AppendMessage(const Message &);
+	// Returns nullptr if the buffer is empty
+	Message ConsumeMessage();
+	std::vector<Message> ConsumeAll();
+
+	size_t Capacity() const { return _mask + 1; }
+	OverflowPolicy GetOverflowPolicy() const { return _policy; }
+	// Number of messages discarded because the buffer was full
+	uint64_t GetDroppedCount() const { return _dropped; }
 
 private:
-	std::deque<T> _buffer;
-	std::mutex _mutex;
+	struct Slot {
+		// Tells which "lap" of the ring the slot is in and whether it
+		// currently holds a message
+		std::atomic<size_t> sequence;
+		Message message;
+	};
+
+	static size_t GetRingSize(size_t capacity);
+	bool TryPush(Message &message);
+	Message TryPop();
+	void Push(Message message);
+
+	const size_t _mask;
+	const OverflowPolicy _policy;
+	const std::chrono::milliseconds _blockTimeout;
+	std::unique_ptr<Slot[]> _slots;
+	alignas(64) std::atomic<size_t> _pushPos{0};
+	alignas(64) std::atomic<size_t> _popPos{0};
+	std::atomic<uint64_t> _dropped{0};
 };
 
-template<class T> inline bool MessageBuffer<T>::Empty()
+template<class T>
+inline size_t MessageBuffer<T>::GetRingSize(size_t capacity)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	return _buffer.empty();
+	size_t size = 2;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	return size;
+}
+
+template<class T>
+inline MessageBuffer<T>::MessageBuffer(size_t capacity, OverflowPolicy policy,
+				       std::chrono::milliseconds blockTimeout)
+	: _mask(GetRingSize(capacity) - 1),
+	  _policy(policy),
+	  _blockTimeout(blockTimeout),
+	  _slots(new Slot[_mask + 1])
+{
+	for (size_t i = 0; i <= _mask; i++) {
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+// Bounded queue as described by Dmitry Vyukov.
+// A slot can be written at position "pos" if its sequence equals "pos" and
+// read if its sequence equals "pos + 1".
+template<class T>
+inline bool MessageBuffer<T>::TryPush(Message &message)
+{
+	size_t pos = _pushPos.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = _slots[pos & _mask];
+		const size_t sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos);
+		if (diff == 0) {
+			if (_pushPos.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				slot.message = std::move(message);
+				slot.sequence.store(pos + 1,
+						    std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = _pushPos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// Producers also remove messages when the oldest message has to be dropped, so
+// this has to support multiple concurrent callers
+template<class T>
+inline typename MessageBuffer<T>::Message MessageBuffer<T>::TryPop()
+{
+	size_t pos = _popPos.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = _slots[pos & _mask];
+		const size_t sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos + 1);
+		if (diff == 0) {
+			if (_popPos.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				auto message = std::move(slot.message);
+				slot.sequence.store(pos + _mask + 1,
+						    std::memory_order_release);
+				return message;
+			}
+		} else if (diff < 0) {
+			return {};
+		} else {
+			pos = _popPos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<class T>
+inline void MessageBuffer<T>::Push(Message message)
+{
+	if (TryPush(message)) {
+		return;
+	}
+
+	switch (_policy) {
+	case OverflowPolicy::DROP_OLDEST:
+		do {
+			if (TryPop()) {
+				++_dropped;
+			}
+		} while (!TryPush(message));
+		return;
+	case OverflowPolicy::DROP_NEWEST:
+		++_dropped;
+		return;
+	case OverflowPolicy::BLOCK: {
+		const auto deadline =
+			std::chrono::steady_clock::now() + _blockTimeout;
+		while (!TryPush(message)) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				++_dropped;
+				return;
+			}
+			std::this_thread::sleep_for(
+				std::chrono::microseconds(100));
+		}
+		return;
+	}
+	}
+}
+
+template<class T> inline bool MessageBuffer<T>::Empty() const
+{
+	const size_t pos = _popPos.load(std::memory_order_relaxed);
+	const size_t sequence =
+		_slots[pos & _mask].sequence.load(std::memory_order_acquire);
+	return sequence != pos + 1;
 }
 
 template<class T> inline void MessageBuffer<T>::Clear()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.clear();
+	while (TryPop()) {
+	}
 }
 
 template<class T> inline void MessageBuffer<T>::AppendMessage(const T &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.emplace_back(message);
+	Push(std::make_shared<const T>(message));
+}
+
+template<class T> inline void MessageBuffer<T>::AppendMessage(T &&message)
+{
+	Push(std::make_shared<const T>(std::move(message)));
+}
+
+template<class T>
+inline void MessageBuffer<T>::AppendMessage(const Message &message)
+{
+	if (!message) {
+		return;
+	}
+	Push(message);
+}
+
+template<class T>
+inline typename MessageBuffer<T>::Message MessageBuffer<T>::ConsumeMessage()
+{
+	return TryPop();
 }
 
-template<class T> inline std::optional<T> MessageBuffer<T>::ConsumeMessage()
+template<class T>
+inline std::vector<typename MessageBuffer<T>::Message>
+MessageBuffer<T>::ConsumeAll()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	if (_buffer.empty()) {
-		return {};
+	std::vector<Message> messages;
+	while (auto message = TryPop()) {
+		messages.emplace_back(std::move(message));
 	}
-	T message = _buffer.at(0);
-	_buffer.pop_front();
-	return message;
+	return messages;
 }
 
 } // namespace advss
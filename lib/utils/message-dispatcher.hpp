@@ -1,8 +1,11 @@
 #pragma once
 #include "message-buffer.hpp"
+#include "plugin-state-helpers.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace advss {
@@ -30,42 +33,154 @@ public:
 		return *this;
 	}
 
-	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient();
+	// Evaluated on the dispatching thread to decide whether a message is
+	// added to a client's buffer, so it must not access any state which
+	// might be modified concurrently
+	using Filter = std::function<bool(const T &)>;
+
+	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient(
+		size_t capacity = MessageBuffer<T>::defaultCapacity,
+		typename MessageBuffer<T>::OverflowPolicy policy =
+			MessageBuffer<T>::OverflowPolicy::DROP_OLDEST);
+	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient(
+		const Filter &filter,
+		size_t capacity = MessageBuffer<T>::defaultCapacity,
+		typename MessageBuffer<T>::OverflowPolicy policy =
+			MessageBuffer<T>::OverflowPolicy::DROP_OLDEST);
 	void DispatchMessage(const T &message);
+	void DispatchMessage(T &&message);
 
 private:
-	std::vector<std::weak_ptr<MessageBuffer<T>>> _clients;
+	struct Client {
+		std::weak_ptr<MessageBuffer<T>> buffer;
+		Filter filter;
+	};
+
+	// Clients share a single immutable copy of the message
+	template<class U> void Dispatch(U &&message);
+
+	std::vector<Client> _clients;
 	std::mutex _mutex;
 };
 
+// Filter which can be replaced after a client was registered using it.
+// Registering a new client whenever the filter changes would lose all
+// messages which were not yet consumed.
+template<class T> class ReplaceableMessageFilter {
+public:
+	using Filter = typename MessageDispatcher<T>::Filter;
+
+	ReplaceableMessageFilter() : _state(std::make_shared<State>()) {}
+
+	void Set(const Filter &filter);
+	// The returned filter forwards to the filter which is currently set
+	Filter Get() const;
+
+private:
+	struct State {
+		std::mutex mutex;
+		Filter filter;
+	};
+	std::shared_ptr<State> _state;
+};
+
+template<class T>
+inline void ReplaceableMessageFilter<T>::Set(const Filter &filter)
+{
+	std::lock_guard<std::mutex> lock(_state->mutex);
+	_state->filter = filter;
+}
+
 template<class T>
-inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient()
+inline typename ReplaceableMessageFilter<T>::Filter
+ReplaceableMessageFilter<T>::Get() const
+{
+	return [state = _state](const T &message) {
+		std::lock_guard<std::mutex> lock(state->mutex);
+		return !state->filter || state->filter(message);
+	};
+}
+
+template<class T>
+inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient(
+	size_t capacity, typename MessageBuffer<T>::OverflowPolicy policy)
+{
+	return RegisterClient(Filter(), capacity, policy);
+}
+
+template<class T>
+inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient(
+	const Filter &filter, size_t capacity,
+	typename MessageBuffer<T>::OverflowPolicy policy)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
 	// Clear expired client buffers
-	auto isExpired = [](const std::weak_ptr<MessageBuffer<T>> &ptr) {
-		return ptr.expired();
+	auto isExpired = [](const Client &client) {
+		return client.buffer.expired();
 	};
 	_clients.erase(std::remove_if(_clients.begin(), _clients.end(),
 				      isExpired),
 		       _clients.end());
 	// Prepare new buffer for client
-	auto buffer = std::make_shared<MessageBuffer<T>>();
-	_clients.emplace_back(buffer);
+	auto buffer = std::make_shared<MessageBuffer<T>>(capacity, policy);
+	_clients.push_back({buffer, filter});
 	return buffer;
 }
 
 template<class T>
 inline void MessageDispatcher<T>::DispatchMessage(const T &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	for (auto &client_ : _clients) {
-		auto client = client_.lock();
-		if (!client) {
-			continue;
+	Dispatch(message);
+}
+
+template<class T> inline void MessageDispatcher<T>::DispatchMessage(T &&message)
+{
+	Dispatch(std::move(message));
+}
+
+template<class T>
+template<class U>
+inline void MessageDispatcher<T>::Dispatch(U &&message)
+{
+	// Reused by each thread to avoid allocations
+	thread_local std::vector<std::shared_ptr<MessageBuffer<T>>> recipients;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		size_t i = 0;
+		while (i < _clients.size()) {
+			auto &client = _clients[i];
+			auto buffer = client.buffer.lock();
+			if (!buffer) {
+				// Clients are not ordered, so there is no need
+				// to shift the remaining ones
+				std::swap(client, _clients.back());
+				_clients.pop_back();
+				continue;
+			}
+			if (!client.filter || client.filter(message)) {
+				recipients.emplace_back(std::move(buffer));
+			}
+			i++;
 		}
-		client->AppendMessage(message);
 	}
+
+	if (recipients.empty()) {
+		return;
+	}
+
+	// Appending is done without holding the lock, as buffers using the
+	// BLOCK overflow policy might wait for their consumer to make room,
+	// which must not delay the delivery to other clients
+	const auto sharedMessage =
+		std::make_shared<const T>(std::forward<U>(message));
+	for (const auto &buffer : recipients) {
+		buffer->AppendMessage(sharedMessage);
+	}
+	recipients.clear();
+
+	// Let the main loop react to the new message without having to wait
+	// for the next regular interval
+	WakeUpMainLoop();
 }
 
 } // namespace advss
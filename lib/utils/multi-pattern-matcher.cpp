@@ -0,0 +1,395 @@
+#include "multi-pattern-matcher.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+
+namespace advss {
+
+static char toLower(char c)
+{
+	return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+static size_t utf8SequenceLength(unsigned char c)
+{
+	if (c >= 0xF0) {
+		return 4;
+	}
+	if (c >= 0xE0) {
+		return 3;
+	}
+	if (c >= 0xC0) {
+		return 2;
+	}
+	return 1;
+}
+
+// Returns the position after the closing bracket of the character class
+// starting at pos
+static size_t skipCharacterClass(const std::string &pattern, size_t pos)
+{
+	pos++;
+	if (pos < pattern.size() && pattern[pos] == '^') {
+		pos++;
+	}
+	// A closing bracket right at the start is part of the class
+	if (pos < pattern.size() && pattern[pos] == ']') {
+		pos++;
+	}
+	while (pos < pattern.size() && pattern[pos] != ']') {
+		if (pattern[pos] == '\\') {
+			pos += 2;
+		} else if (pattern.compare(pos, 2, "[:") == 0) {
+			const auto end = pattern.find(":]", pos + 2);
+			pos = end == std::string::npos ? pattern.size()
+						       : end + 2;
+		} else {
+			pos++;
+		}
+	}
+	return std::min(pos + 1, pattern.size());
+}
+
+// Returns the position after the escape sequence starting at pos, which is
+// not a literal character
+static size_t skipEscapeSequence(const std::string &pattern, size_t pos)
+{
+	const char type = pattern[pos + 1];
+	pos += 2;
+	if (pos >= pattern.size()) {
+		return pos;
+	}
+
+	const char next = pattern[pos];
+	if (next == '{') {
+		const auto end = pattern.find('}', pos);
+		return end == std::string::npos ? pattern.size() : end + 1;
+	}
+	if ((type == 'k' || type == 'g') && (next == '<' || next == '\'')) {
+		const auto end = pattern.find(next == '<' ? '>' : '\'', pos);
+		return end == std::string::npos ? pattern.size() : end + 1;
+	}
+	if (type == 'c') {
+		return pos + 1;
+	}
+	if (type == 'x') {
+		for (int i = 0; i < 2 && pos < pattern.size() &&
+				std::isxdigit(static_cast<unsigned char>(
+					pattern[pos]));
+		     i++) {
+			pos++;
+		}
+		return pos;
+	}
+	while (std::isdigit(static_cast<unsigned char>(type)) &&
+	       pos < pattern.size() &&
+	       std::isdigit(static_cast<unsigned char>(pattern[pos]))) {
+		pos++;
+	}
+	return pos;
+}
+
+// Returns the position after the group starting at pos
+static size_t skipGroup(const std::string &pattern, size_t pos)
+{
+	int depth = 0;
+	while (pos < pattern.size()) {
+		switch (pattern[pos]) {
+		case '\\':
+			pos += 2;
+			continue;
+		case '[':
+			pos = skipCharacterClass(pattern, pos);
+			continue;
+		case '(':
+			depth++;
+			break;
+		case ')':
+			if (--depth == 0) {
+				return pos + 1;
+			}
+			break;
+		default:
+			break;
+		}
+		pos++;
+	}
+	return pattern.size();
+}
+
+// Checks if a quantifier starts at pos and returns its length and whether it
+// allows the preceding item to be absent
+static bool getQuantifier(const std::string &pattern, size_t pos,
+			  size_t &length, bool &optional)
+{
+	if (pos >= pattern.size()) {
+		return false;
+	}
+
+	const char c = pattern[pos];
+	if (c == '*' || c == '?' || c == '+') {
+		length = 1;
+		optional = c != '+';
+	} else if (c == '{') {
+		const auto end = pattern.find('}', pos);
+		if (end == std::string::npos) {
+			return false;
+		}
+		const auto content = pattern.substr(pos + 1, end - pos - 1);
+		const auto comma = content.find(',');
+		const auto min = content.substr(0, comma);
+		const auto max = comma == std::string::npos
+					 ? std::string()
+					 : content.substr(comma + 1);
+		auto isNumber = [](const std::string &str) {
+			return std::all_of(str.begin(), str.end(), [](char c) {
+				return !!std::isdigit(
+					static_cast<unsigned char>(c));
+			});
+		};
+		if (!isNumber(min) || !isNumber(max) ||
+		    (min.empty() && max.empty())) {
+			// Not a quantifier, so the brace is matched literally
+			return false;
+		}
+		length = end - pos + 1;
+		optional = min.find_first_not_of('0') == std::string::npos;
+	} else {
+		return false;
+	}
+
+	// Lazy and possessive quantifiers
+	if (pos + length < pattern.size() &&
+	    (pattern[pos + length] == '?' || pattern[pos + length] == '+')) {
+		length++;
+	}
+	return true;
+}
+
+std::string MultiPatternMatcher::GetRequiredLiteral(const std::string &pattern,
+						    const RegexConfig &regex)
+{
+	std::string lowerPattern = pattern;
+	std::transform(lowerPattern.begin(), lowerPattern.end(),
+		       lowerPattern.begin(), toLower);
+	if (!regex.Enabled()) {
+		return lowerPattern;
+	}
+
+	const auto options = regex.GetPatternOptions();
+	// Alternations, option settings and quoted sequences are not analyzed
+	if (options & QRegularExpression::ExtendedPatternSyntaxOption ||
+	    pattern.find('|') != std::string::npos ||
+	    pattern.find("(?") != std::string::npos ||
+	    pattern.find("(*") != std::string::npos ||
+	    pattern.find("\\Q") != std::string::npos) {
+		return {};
+	}
+
+	// Unicode case folding maps non-ASCII characters like the Kelvin sign
+	// or the long s to 'k' and 's', so these cannot be part of the literal
+	const bool caseInsensitive =
+		options & QRegularExpression::CaseInsensitiveOption;
+	auto canBePartOfLiteral = [caseInsensitive](char c) {
+		if (!caseInsensitive) {
+			return true;
+		}
+		const char lower = toLower(c);
+		return static_cast<unsigned char>(c) < 0x80 && lower != 'k' &&
+		       lower != 's';
+	};
+
+	std::string longest;
+	std::string current;
+	auto endLiteral = [&]() {
+		if (current.size() > longest.size()) {
+			longest = current;
+		}
+		current.clear();
+	};
+
+	size_t pos = 0;
+	while (pos < pattern.size()) {
+		const char c = pattern[pos];
+		// Empty if the next item is not a literal character
+		std::string atom;
+
+		if (c == '\\') {
+			if (pos + 1 >= pattern.size()) {
+				break;
+			}
+			const char escaped = pattern[pos + 1];
+			if (std::isalnum(static_cast<unsigned char>(escaped))) {
+				pos = skipEscapeSequence(pattern, pos);
+			} else {
+				atom = lowerPattern.substr(pos + 1, 1);
+				pos += 2;
+			}
+		} else if (c == '[') {
+			pos = skipCharacterClass(pattern, pos);
+		} else if (c == '(') {
+			pos = skipGroup(pattern, pos);
+		} else if (c == '.' || c == '^' || c == '$' || c == ')') {
+			pos++;
+		} else {
+			const auto length = std::min(
+				utf8SequenceLength(
+					static_cast<unsigned char>(c)),
+				pattern.size() - pos);
+			atom = lowerPattern.substr(pos, length);
+			pos += length;
+		}
+
+		const bool isPartOfLiteral =
+			!atom.empty() && std::all_of(atom.begin(), atom.end(),
+						     canBePartOfLiteral);
+
+		size_t quantifierLength = 0;
+		bool optional = false;
+		if (getQuantifier(pattern, pos, quantifierLength, optional)) {
+			pos += quantifierLength;
+			// The item might be repeated, so the literal ends here
+			if (!optional && isPartOfLiteral) {
+				current += atom;
+			}
+			endLiteral();
+			continue;
+		}
+
+		if (isPartOfLiteral) {
+			current += atom;
+		} else {
+			endLiteral();
+		}
+	}
+	endLiteral();
+	return longest;
+}
+
+size_t MultiPatternMatcher::Add(const std::string &pattern,
+				const RegexConfig &regex)
+{
+	const auto id = _nextId++;
+	_patterns[id] = {pattern, regex, GetRequiredLiteral(pattern, regex)};
+	_outdated = true;
+	return id;
+}
+
+void MultiPatternMatcher::Remove(size_t id)
+{
+	_patterns.erase(id);
+	_outdated = true;
+}
+
+void MultiPatternMatcher::Clear()
+{
+	_patterns.clear();
+	_outdated = true;
+}
+
+size_t MultiPatternMatcher::Next(size_t node, unsigned char c) const
+{
+	while (true) {
+		for (const auto &[transition, target] : _nodes[node].next) {
+			if (transition == c) {
+				return target;
+			}
+		}
+		if (node == 0) {
+			return 0;
+		}
+		node = _nodes[node].fail;
+	}
+}
+
+void MultiPatternMatcher::Build()
+{
+	_nodes.assign(1, Node());
+	_alwaysCheck.clear();
+
+	for (const auto &[id, pattern] : _patterns) {
+		if (pattern.literal.empty()) {
+			_alwaysCheck.emplace_back(id);
+			continue;
+		}
+
+		size_t node = 0;
+		for (const auto c : pattern.literal) {
+			const auto transition = static_cast<unsigned char>(c);
+			auto &next = _nodes[node].next;
+			auto it = std::find_if(next.begin(), next.end(),
+					       [transition](const auto &entry) {
+						       return entry.first ==
+							      transition;
+					       });
+			if (it != next.end()) {
+				node = it->second;
+				continue;
+			}
+			next.emplace_back(transition, _nodes.size());
+			node = _nodes.size();
+			_nodes.emplace_back();
+		}
+		_nodes[node].ids.emplace_back(id);
+	}
+
+	// Breadth first, so the fail links of shallower nodes are known
+	std::deque<size_t> queue;
+	for (const auto &[transition, child] : _nodes[0].next) {
+		queue.emplace_back(child);
+	}
+	while (!queue.empty()) {
+		const auto node = queue.front();
+		queue.pop_front();
+		for (const auto &[transition, child] : _nodes[node].next) {
+			const auto fail = Next(_nodes[node].fail, transition);
+			_nodes[child].fail = fail;
+			_nodes[child].output = _nodes[fail].ids.empty()
+						       ? _nodes[fail].output
+						       : fail;
+			queue.emplace_back(child);
+		}
+	}
+
+	_outdated = false;
+}
+
+std::vector<size_t> MultiPatternMatcher::Match(const std::string &text)
+{
+	if (_outdated) {
+		Build();
+	}
+
+	std::vector<size_t> candidates = _alwaysCheck;
+	std::vector<bool> visited(_nodes.size(), false);
+	size_t node = 0;
+	for (const auto c : text) {
+		node = Next(node, static_cast<unsigned char>(toLower(c)));
+		size_t match = _nodes[node].ids.empty() ? _nodes[node].output
+							: node;
+		while (match != 0 && !visited[match]) {
+			visited[match] = true;
+			candidates.insert(candidates.end(),
+					  _nodes[match].ids.begin(),
+					  _nodes[match].ids.end());
+			match = _nodes[match].output;
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+	std::vector<size_t> result;
+	for (const auto id : candidates) {
+		const auto &pattern = _patterns.at(id);
+		const bool matches =
+			pattern.regex.Enabled()
+				? pattern.regex.Matches(text, pattern.pattern)
+				: text == pattern.pattern;
+		if (matches) {
+			result.emplace_back(id);
+		}
+	}
+	return result;
+}
+
+} // namespace advss
@@ -0,0 +1,66 @@
+#pragma once
+#include "regex-config.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Matches a text against many patterns at once.
+// For each pattern a literal is extracted, which every matching text has to
+// contain. A single pass over the text determines which of these literals
+// occur, so only the patterns whose literal was found, or for which no such
+// literal exists, have to be evaluated individually.
+class EXPORT MultiPatternMatcher {
+public:
+	// If the RegexConfig is disabled the text has to equal the pattern
+	size_t Add(const std::string &pattern, const RegexConfig &regex);
+	void Remove(size_t id);
+	void Clear();
+	size_t Size() const { return _patterns.size(); }
+
+	// Returns the ids of all matching patterns in ascending order
+	std::vector<size_t> Match(const std::string &text);
+
+	// Returns a literal all texts matching the pattern have to contain, in
+	// lower case, or an empty string if no such literal could be determined
+	static std::string GetRequiredLiteral(const std::string &pattern,
+					      const RegexConfig &regex);
+
+private:
+	struct Pattern {
+		std::string pattern;
+		RegexConfig regex;
+		std::string literal;
+	};
+
+	// Aho-Corasick automaton over the required literals
+	struct Node {
+		std::vector<std::pair<unsigned char, size_t>> next;
+		size_t fail = 0;
+		// Closest node reachable via fail links which ends a literal
+		size_t output = 0;
+		std::vector<size_t> ids;
+	};
+
+	void Build();
+	size_t Next(size_t node, unsigned char c) const;
+
+	size_t _nextId = 0;
+	std::unordered_map<size_t, Pattern> _patterns;
+	bool _outdated = true;
+	std::vector<Node> _nodes;
+	std::vector<size_t> _alwaysCheck;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace advss
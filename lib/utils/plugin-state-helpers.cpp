@@ -303,6 +303,14 @@ int GetIntervalValue()
 	return GetSwitcher()->interval;
 }
 
+void WakeUpMainLoop()
+{
+	if (!GetSwitcher()) {
+		return;
+	}
+	GetSwitcher()->RequestWakeup();
+}
+
 void SetPluginNoMatchBehavior(NoMatchBehavior behavior)
 {
 	GetSwitcher()->switchIfNotMatching = behavior;
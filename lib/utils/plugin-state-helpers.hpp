@@ -30,6 +30,9 @@ EXPORT void StopPlugin();
 EXPORT void StartPlugin();
 EXPORT bool PluginIsRunning();
 EXPORT int GetIntervalValue();
+// Request the main loop to check the conditions as soon as possible instead of
+// waiting for the regular interval to elapse (rate limited)
+EXPORT void WakeUpMainLoop();
 EXPORT void AddStartStep(std::function<void()>);
 EXPORT void AddStopStep(std::function<void()>);
 void RunStartSteps();
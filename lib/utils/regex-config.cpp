@@ -47,19 +47,54 @@ void RegexConfig::SetPatternOptions(QRegularExpression::PatternOptions options)
 	_options = options;
 }
 
+static bool isLiteral(const std::string &expr,
+		      QRegularExpression::PatternOptions options)
+{
+	if (options & (QRegularExpression::CaseInsensitiveOption |
+		       QRegularExpression::ExtendedPatternSyntaxOption)) {
+		return false;
+	}
+	return expr.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+}
+
+bool RegexConfig::CacheIsValid() const
+{
+	return _cache.valid && _cache.options == _options &&
+	       _cache.partialMatch == _partialMatch;
+}
+
+void RegexConfig::UpdateCache(const QString &expr,
+			      const std::string &stdExpr) const
+{
+	_cache.valid = true;
+	_cache.expression = expr;
+	_cache.stdExpression = stdExpr;
+	_cache.options = _options;
+	_cache.partialMatch = _partialMatch;
+	_cache.isLiteral = isLiteral(stdExpr, _options);
+	_cache.regex = QRegularExpression(
+		_partialMatch ? expr : QRegularExpression::anchoredPattern(expr),
+		_options);
+	_cache.regex.optimize();
+}
+
 QRegularExpression RegexConfig::GetRegularExpression(const QString &expr) const
 {
-	if (_partialMatch) {
-		return QRegularExpression(expr, _options);
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	if (!CacheIsValid() || _cache.expression != expr) {
+		UpdateCache(expr, expr.toStdString());
 	}
-	return QRegularExpression(QRegularExpression::anchoredPattern(expr),
-				  _options);
+	return _cache.regex;
 }
 
 QRegularExpression
 RegexConfig::GetRegularExpression(const std::string &expr) const
 {
-	return GetRegularExpression(QString::fromStdString(expr));
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	if (!CacheIsValid() || _cache.stdExpression != expr) {
+		UpdateCache(QString::fromStdString(expr), expr);
+	}
+	return _cache.regex;
 }
 
 bool RegexConfig::Matches(const QString &text, const QString &expression) const
@@ -75,8 +110,34 @@ bool RegexConfig::Matches(const QString &text, const QString &expression) const
 bool RegexConfig::Matches(const std::string &text,
 			  const std::string &expression) const
 {
-	return Matches(QString::fromStdString(text),
-		       QString::fromStdString(expression));
+	QRegularExpression regex;
+	{
+		std::lock_guard<std::mutex> lock(_cache.mutex);
+		if (!CacheIsValid() || _cache.stdExpression != expression) {
+			UpdateCache(QString::fromStdString(expression),
+				    expression);
+		}
+		if (_cache.isLiteral) {
+			return _partialMatch
+				       ? text.find(expression) !=
+						 std::string::npos
+				       : text == expression;
+		}
+		regex = _cache.regex;
+	}
+
+	if (!regex.isValid()) {
+		return false;
+	}
+	auto match = regex.match(QString::fromStdString(text));
+	return match.hasMatch();
+}
+
+bool RegexConfig::operator==(const RegexConfig &other) const
+{
+	return _enable == other._enable &&
+	       _partialMatch == other._partialMatch &&
+	       _options == other._options;
 }
 
 RegexConfig RegexConfig::PartialMatchRegexConfig(bool enabled)
@@ -1,7 +1,9 @@
 #pragma once
 #include "export-symbol-helper.hpp"
 
+#include <mutex>
 #include <obs-data.h>
+#include <string>
 #include <QCheckBox>
 #include <QDialog>
 #include <QDialogButtonBox>
@@ -37,13 +39,42 @@ public:
 	EXPORT bool Matches(const std::string &text,
 			    const std::string &expression) const;
 
+	EXPORT bool operator==(const RegexConfig &other) const;
+	EXPORT bool operator!=(const RegexConfig &other) const
+	{
+		return !(*this == other);
+	}
+
 	EXPORT static RegexConfig PartialMatchRegexConfig(bool enabled = false);
 
 private:
+	// Compiled form of the most recently used expression, which is not
+	// shared with copies of the RegexConfig
+	struct Cache {
+		Cache() = default;
+		Cache(const Cache &) {}
+		Cache &operator=(const Cache &) { return *this; }
+
+		std::mutex mutex;
+		bool valid = false;
+		QString expression;
+		std::string stdExpression;
+		QRegularExpression::PatternOptions options;
+		bool partialMatch = false;
+		// Expressions without special characters can be matched
+		// without converting the text to UTF-16
+		bool isLiteral = false;
+		QRegularExpression regex;
+	};
+
+	bool CacheIsValid() const;
+	void UpdateCache(const QString &, const std::string &) const;
+
 	bool _enable = false;
 	bool _partialMatch = false;
 	QRegularExpression::PatternOptions _options =
 		QRegularExpression::NoPatternOption;
+	mutable Cache _cache;
 	friend RegexConfigWidget;
 	friend RegexConfigDialog;
 };
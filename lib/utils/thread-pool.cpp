@@ -0,0 +1,240 @@
+#include "thread-pool.hpp"
+#include "log-helper.hpp"
+
+#include <algorithm>
+
+namespace advss {
+
+ThreadPool::ThreadPool(const char *name, size_t defaultThreadCount,
+		       size_t maxQueueSize)
+	: _name(name),
+	  _defaultThreadCount(defaultThreadCount ? defaultThreadCount
+						 : GetDefaultThreadCount()),
+	  _maxQueueSize(maxQueueSize)
+{
+	Start(_defaultThreadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+}
+
+size_t ThreadPool::GetDefaultThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::Start(size_t threadCount)
+{
+	auto workers = std::make_shared<WorkerList>();
+	for (size_t i = 0; i < threadCount; i++) {
+		workers->emplace_back(std::make_shared<Worker>());
+	}
+	{
+		std::lock_guard<std::mutex> lock(_workersMutex);
+		_workers = workers;
+		for (const auto &worker : *workers) {
+			worker->thread =
+				std::thread(&ThreadPool::Run, this, worker);
+		}
+	}
+	blog(LOG_INFO, "started thread pool \"%s\" with %d threads",
+	     _name.c_str(), (int)threadCount);
+}
+
+void ThreadPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+
+	WorkerList workers;
+	{
+		std::lock_guard<std::mutex> lock(_workersMutex);
+		workers = *_workers;
+		workers.insert(workers.end(), _retiredWorkers.begin(),
+			       _retiredWorkers.end());
+		_retiredWorkers.clear();
+	}
+	for (auto &worker : workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> &&func)
+{
+	{
+		// The task must be accounted for before it is published, as
+		// workers decrement the counter as soon as they take a task
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_maxQueueSize != 0 && _queued >= _maxQueueSize) {
+			_rejected++;
+			return {};
+		}
+		_queued++;
+	}
+
+	std::packaged_task<void()> task(std::move(func));
+	auto future = task.get_future();
+
+	{
+		std::lock_guard<std::mutex> workersLock(_workersMutex);
+		const auto idx = _nextWorker++ % _workers->size();
+		auto &worker = (*_workers)[idx];
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		worker->queue.emplace_back(std::move(task));
+	}
+	_cv.notify_one();
+	return future;
+}
+
+void ThreadPool::SetThreadCount(size_t threadCount)
+{
+	if (threadCount == 0) {
+		threadCount = _defaultThreadCount;
+	}
+
+	WorkerList finished;
+	{
+		std::lock_guard<std::mutex> lock(_workersMutex);
+		if (threadCount == _workers->size()) {
+			return;
+		}
+
+		auto workers = std::make_shared<WorkerList>();
+		for (size_t i = 0; i < threadCount; i++) {
+			workers->emplace_back(std::make_shared<Worker>());
+		}
+
+		// The new workers are not visible to anyone yet, so their
+		// queues can be filled without locking them
+		size_t idx = 0;
+		for (const auto &worker : *_workers) {
+			worker->retired = true;
+			std::lock_guard<std::mutex> workerLock(worker->mutex);
+			for (auto &task : worker->queue) {
+				auto &target = (*workers)[idx++ % threadCount];
+				target->queue.emplace_back(std::move(task));
+			}
+			worker->queue.clear();
+			_retiredWorkers.emplace_back(worker);
+		}
+		for (const auto &worker : *workers) {
+			worker->thread =
+				std::thread(&ThreadPool::Run, this, worker);
+		}
+		_workers = workers;
+
+		// Workers retired by earlier calls can be cleaned up once they
+		// are done
+		auto it = std::partition(
+			_retiredWorkers.begin(), _retiredWorkers.end(),
+			[](const std::shared_ptr<Worker> &worker) {
+				return !worker->done;
+			});
+		finished.assign(it, _retiredWorkers.end());
+		_retiredWorkers.erase(it, _retiredWorkers.end());
+	}
+
+	{
+		// Make sure waiting workers either notice the retirement or
+		// receive the notification
+		std::lock_guard<std::mutex> lock(_mutex);
+	}
+	_cv.notify_all();
+
+	for (auto &worker : finished) {
+		worker->thread.join();
+	}
+	blog(LOG_INFO, "changed thread count of thread pool \"%s\" to %d",
+	     _name.c_str(), (int)threadCount);
+}
+
+size_t ThreadPool::GetThreadCount() const
+{
+	return GetWorkers()->size();
+}
+
+ThreadPool::Stats ThreadPool::GetStats() const
+{
+	Stats stats;
+	stats.threadCount = GetThreadCount();
+	stats.queued = _queued;
+	stats.running = _running;
+	stats.executed = _executed;
+	stats.stolen = _stolen;
+	stats.rejected = _rejected;
+	return stats;
+}
+
+std::shared_ptr<const ThreadPool::WorkerList> ThreadPool::GetWorkers() const
+{
+	std::lock_guard<std::mutex> lock(_workersMutex);
+	return _workers;
+}
+
+bool ThreadPool::PopTask(Worker &worker, std::packaged_task<void()> &task)
+{
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (worker.queue.empty()) {
+		return false;
+	}
+	task = std::move(worker.queue.front());
+	worker.queue.pop_front();
+	return true;
+}
+
+bool ThreadPool::StealTask(const Worker &thief,
+			   std::packaged_task<void()> &task)
+{
+	const auto workers = GetWorkers();
+	for (const auto &victim : *workers) {
+		if (victim.get() == &thief) {
+			continue;
+		}
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (victim->queue.empty()) {
+			continue;
+		}
+		// Take the most recently submitted task to reduce contention
+		// with the owner of the queue, which works from the front
+		task = std::move(victim->queue.back());
+		victim->queue.pop_back();
+		_stolen++;
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::Run(std::shared_ptr<Worker> worker)
+{
+	while (!worker->retired) {
+		std::packaged_task<void()> task;
+		if (!PopTask(*worker, task) && !StealTask(*worker, task)) {
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this, &worker]() {
+				return _stop || _queued > 0 || worker->retired;
+			});
+			// Make sure to finish all remaining tasks before
+			// shutting down
+			if (_stop && _queued == 0) {
+				break;
+			}
+			continue;
+		}
+
+		_queued--;
+		_running++;
+		task();
+		_running--;
+		_executed++;
+	}
+	worker->done = true;
+}
+
+} // namespace advss
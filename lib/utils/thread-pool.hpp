@@ -0,0 +1,104 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Fixed size thread pool using a work-stealing strategy.
+// Each worker owns a task queue, which tasks are submitted to in a round-robin
+// fashion. Idle workers will take tasks from the queues of other workers.
+class EXPORT ThreadPool {
+public:
+	struct Stats {
+		size_t threadCount = 0;
+		size_t queued = 0;
+		size_t running = 0;
+		uint64_t executed = 0;
+		uint64_t stolen = 0;
+		uint64_t rejected = 0;
+	};
+
+	// A default thread count of 0 will use the number of available cores.
+	// A maximum queue size of 0 will not limit the number of queued tasks.
+	ThreadPool(const char *name, size_t defaultThreadCount = 0,
+		   size_t maxQueueSize = 0);
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	// Returns an invalid future if the task was rejected as the maximum
+	// queue size was reached
+	std::future<void> Submit(std::function<void()> &&task);
+
+	// Queued tasks are moved to the new set of workers. Replaced workers
+	// exit once their current task is done, so this does not wait for any
+	// task to complete.
+	// A thread count of 0 will restore the default thread count.
+	void SetThreadCount(size_t threadCount);
+	size_t GetThreadCount() const;
+	Stats GetStats() const;
+
+	static size_t GetDefaultThreadCount();
+
+private:
+	struct Worker {
+		std::deque<std::packaged_task<void()>> queue;
+		std::mutex mutex;
+		std::thread thread;
+		// Set once the worker was replaced by a call to
+		// SetThreadCount()
+		std::atomic_bool retired = {false};
+		std::atomic_bool done = {false};
+	};
+	using WorkerList = std::vector<std::shared_ptr<Worker>>;
+
+	void Start(size_t threadCount);
+	void Stop();
+	void Run(std::shared_ptr<Worker>);
+	std::shared_ptr<const WorkerList> GetWorkers() const;
+	bool PopTask(Worker &, std::packaged_task<void()> &task);
+	bool StealTask(const Worker &, std::packaged_task<void()> &task);
+
+	const std::string _name;
+	const size_t _defaultThreadCount;
+	const size_t _maxQueueSize;
+	// Replaced as a whole when the thread count changes, so workers can
+	// keep using their copy without holding the lock
+	std::shared_ptr<const WorkerList> _workers;
+	// Replaced workers which might still be running their last task
+	WorkerList _retiredWorkers;
+	mutable std::mutex _workersMutex;
+	std::atomic_size_t _nextWorker = 0;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _stop = false;
+
+	std::atomic_size_t _queued = 0;
+	std::atomic_size_t _running = 0;
+	std::atomic_uint64_t _executed = 0;
+	std::atomic_uint64_t _stolen = 0;
+	std::atomic_uint64_t _rejected = 0;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace advss
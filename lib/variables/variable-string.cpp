@@ -1,20 +1,50 @@
 #include "variable-string.hpp"
-#include "utility.hpp"
 
 namespace advss {
 
+bool StringVariable::ResolveOutdated() const
+{
+	if (_resolveOutdated ||
+	    _variableListVersion != GetVariableListVersion()) {
+		return true;
+	}
+	for (const auto &[weakVariable, version] : _usedVariables) {
+		auto variable = weakVariable.lock();
+		if (!variable || variable->GetVersion() != version) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void StringVariable::Resolve() const
 {
 	if (GetVariables().empty()) {
 		_resolvedValue = _value;
+		_resolveOutdated = true;
+		return;
+	}
+	if (_referencesOutdated) {
+		_references = VariableReferences(_value);
+		_referencesOutdated = false;
+		_resolveOutdated = true;
+	}
+
+	// Changes of the values of an action queue's variable context are
+	// not tracked, so the result cannot be cached in that case
+	if (IsVariableContextActive()) {
+		_resolvedValue = _references.Substitute(_value);
+		_resolveOutdated = true;
 		return;
 	}
-	const auto lastChange = GetLastVariableChangeTime();
-	if (_lastResolve == lastChange) {
+
+	if (!ResolveOutdated()) {
 		return;
 	}
-	_resolvedValue = SubstitueVariables(_value);
-	_lastResolve = lastChange;
+	_variableListVersion = GetVariableListVersion();
+	_usedVariables.clear();
+	_resolvedValue = _references.Substitute(_value, &_usedVariables);
+	_resolveOutdated = false;
 }
 
 StringVariable::operator std::string() const
@@ -31,19 +61,22 @@ StringVariable::operator QVariant() const
 void StringVariable::operator=(std::string value)
 {
 	_value = value;
-	_lastResolve = {};
+	_referencesOutdated = true;
+	_resolveOutdated = true;
 }
 
 void StringVariable::operator=(const char *value)
 {
 	_value = value;
-	_lastResolve = {};
+	_referencesOutdated = true;
+	_resolveOutdated = true;
 }
 
 void StringVariable::Load(obs_data_t *obj, const char *name)
 {
 	_value = obs_data_get_string(obj, name);
-	_lastResolve = {};
+	_referencesOutdated = true;
+	_resolveOutdated = true;
 	Resolve();
 }
 
@@ -56,6 +89,7 @@ void StringVariable::ResolveVariables()
 {
 	Resolve();
 	_value = _resolvedValue;
+	_referencesOutdated = true;
 }
 
 const char *StringVariable::c_str()
@@ -76,16 +110,91 @@ bool StringVariable::empty() const
 	return _resolvedValue.empty();
 }
 
-std::string SubstitueVariables(std::string str)
+VariableReferences::VariableReferences(const std::string &str)
+{
+	size_t pos = str.find("${");
+	while (pos != std::string::npos) {
+		const size_t next = str.find("${", pos + 2);
+		const size_t first = _closingBraces.size();
+		for (size_t brace = str.find('}', pos + 2);
+		     brace != std::string::npos && brace < next;
+		     brace = str.find('}', brace + 1)) {
+			_closingBraces.emplace_back(brace);
+		}
+		if (_closingBraces.size() > first) {
+			_references.push_back(
+				{pos, first, _closingBraces.size() - 1});
+		}
+		pos = next;
+	}
+}
+
+std::shared_ptr<Variable>
+VariableReferences::Lookup(const std::string &str, const Reference &reference,
+			   size_t &end) const
 {
-	for (const auto &v : GetVariables()) {
-		const auto &variable = std::dynamic_pointer_cast<Variable>(v);
-		const std::string pattern = "${" + variable->Name() + "}";
-		if (ReplaceAll(str, pattern, variable->Value(false))) {
-			variable->MarkAsUsed();
+	const size_t nameBegin = reference.begin + 2;
+	for (size_t i = reference.firstClosingBrace;
+	     i <= reference.lastClosingBrace; ++i) {
+		const size_t nameEnd = _closingBraces[i];
+		const auto name = str.substr(nameBegin, nameEnd - nameBegin);
+		auto variable = GetWeakVariableByName(name).lock();
+		if (variable) {
+			end = nameEnd + 1;
+			return variable;
 		}
 	}
-	return str;
+	return {};
+}
+
+std::string VariableReferences::Substitute(const std::string &str,
+					   UsedVariables *usedVariables) const
+{
+	std::string result;
+	result.reserve(str.size());
+	size_t literalBegin = 0;
+
+	for (const auto &reference : _references) {
+		size_t end = 0;
+		auto variable = Lookup(str, reference, end);
+		if (!variable) {
+			continue;
+		}
+
+		// Read the version first so a concurrent change is detected the
+		// next time at the latest
+		if (usedVariables) {
+			usedVariables->emplace_back(variable,
+						    variable->GetVersion());
+		}
+		result.append(str, literalBegin,
+			      reference.begin - literalBegin);
+		result.append(variable->Value(false));
+		variable->MarkAsUsed();
+		literalBegin = end;
+	}
+
+	result.append(str, literalBegin, std::string::npos);
+	return result;
+}
+
+std::vector<VariableReferences::Match>
+VariableReferences::FindVariables(const std::string &str) const
+{
+	std::vector<Match> matches;
+	for (const auto &reference : _references) {
+		size_t end = 0;
+		auto variable = Lookup(str, reference, end);
+		if (variable) {
+			matches.push_back({reference.begin, end, variable});
+		}
+	}
+	return matches;
+}
+
+std::string SubstitueVariables(std::string str)
+{
+	return VariableReferences(str).Substitute(str);
 }
 
 } // namespace advss
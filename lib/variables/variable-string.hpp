@@ -1,11 +1,54 @@
 #pragma once
 #include "variable.hpp"
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include <obs-data.h>
 
 namespace advss {
 
+// Positions of all potential variable references of the form "${name}" in a
+// string, so resolving them does not require searching the string again
+class VariableReferences {
+public:
+	// Variables used during substitution and their versions at that time
+	using UsedVariables =
+		std::vector<std::pair<std::weak_ptr<Variable>, uint64_t>>;
+
+	VariableReferences() = default;
+	EXPORT VariableReferences(const std::string &str);
+
+	EXPORT std::string
+	Substitute(const std::string &str,
+		   UsedVariables *usedVariables = nullptr) const;
+
+	// Reference to an existing variable covering [begin, end) of the string
+	struct Match {
+		size_t begin;
+		size_t end;
+		std::shared_ptr<Variable> variable;
+	};
+	EXPORT std::vector<Match> FindVariables(const std::string &str) const;
+
+private:
+	struct Reference {
+		size_t begin;
+		// Range of candidates in _closingBraces, as variable names
+		// might contain closing braces themselves
+		size_t firstClosingBrace;
+		size_t lastClosingBrace;
+	};
+
+	std::shared_ptr<Variable> Lookup(const std::string &str,
+					 const Reference &reference,
+					 size_t &end) const;
+
+	std::vector<Reference> _references;
+	std::vector<size_t> _closingBraces;
+};
+
 // Helper class which automatically resolves variables contained in strings
 // when reading its value as a std::string
 
@@ -30,11 +73,16 @@ public:
 	EXPORT void ResolveVariables();
 
 private:
+	bool ResolveOutdated() const;
 	void Resolve() const;
 
 	std::string _value = "";
+	mutable VariableReferences _references;
+	mutable bool _referencesOutdated = true;
 	mutable std::string _resolvedValue = "";
-	mutable std::chrono::high_resolution_clock::time_point _lastResolve{};
+	mutable bool _resolveOutdated = true;
+	mutable uint64_t _variableListVersion = 0;
+	mutable VariableReferences::UsedVariables _usedVariables;
 };
 
 std::string SubstitueVariables(std::string str);
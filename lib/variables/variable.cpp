@@ -13,10 +13,9 @@ namespace advss {
 
 static std::deque<std::shared_ptr<Item>> variables;
 
-// Keep track of the last time a variable was changed to save some work when
-// when resolving strings containing variables, etc.
-static std::mutex lastVariableChangeMutex;
-static std::chrono::high_resolution_clock::time_point lastVariableChange{};
+// Incremented whenever variables are added, removed or renamed, as this might
+// change how references to variables in strings are resolved
+static std::atomic<uint64_t> variableListVersion{0};
 
 // When set, Variable::Value() and Variable::SetValue() operate on this context
 // instead of the global variable state. Used by action queues to isolate
@@ -42,6 +41,11 @@ void SetActiveVariableContext(VariableContext *context)
 	activeVarContext = context;
 }
 
+bool IsVariableContextActive()
+{
+	return !!activeVarContext;
+}
+
 static bool setup()
 {
 	AddEarlySaveStep(SaveVariables);
@@ -51,20 +55,19 @@ static bool setup()
 }
 static bool setupDone = setup();
 
-static void setLastVariableChangeTime()
+static void variableListChanged()
 {
-	std::lock_guard<std::mutex> lock(lastVariableChangeMutex);
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	++variableListVersion;
 }
 
 Variable::Variable() : Item()
 {
-	setLastVariableChangeTime();
+	variableListChanged();
 }
 
 Variable::~Variable()
 {
-	setLastVariableChangeTime();
+	variableListChanged();
 }
 
 void Variable::Load(obs_data_t *obj)
@@ -80,7 +83,7 @@ void Variable::Load(obs_data_t *obj)
 		SetValue(_defaultValue);
 	}
 
-	setLastVariableChangeTime();
+	variableListChanged();
 }
 
 void Variable::Save(obs_data_t *obj) const
@@ -146,7 +149,6 @@ void Variable::SetValue(const std::string &value)
 			return;
 		}
 		it->second = value;
-		setLastVariableChangeTime();
 		return;
 	}
 
@@ -160,8 +162,8 @@ void Variable::SetValue(const std::string &value)
 			_lastChanged =
 				std::chrono::high_resolution_clock::now();
 			++_valueChangeCount;
+			++_version;
 		}
-		setLastVariableChangeTime();
 	}
 
 	_cv.notify_all();
@@ -290,7 +292,7 @@ bool VariableSettingsDialog::AskForSettings(QWidget *parent, Variable &settings)
 		dialog._defaultValue->toPlainText().toStdString();
 	settings._saveAction =
 		static_cast<Variable::SaveAction>(dialog._save->currentIndex());
-	setLastVariableChangeTime();
+	variableListChanged();
 
 	return true;
 }
@@ -401,6 +403,13 @@ bool VariableSelectionDialog::AskForVariable(std::string &varName)
 
 VariableSignalManager::VariableSignalManager(QObject *parent) : QObject(parent)
 {
+	const auto listChanged = []() {
+		variableListChanged();
+		InvalidateItemNameIndex(variables);
+	};
+	connect(this, &VariableSignalManager::Rename, this, listChanged);
+	connect(this, &VariableSignalManager::Add, this, listChanged);
+	connect(this, &VariableSignalManager::Remove, this, listChanged);
 }
 
 VariableSignalManager *VariableSignalManager::Instance()
@@ -416,13 +425,7 @@ std::deque<std::shared_ptr<Item>> &GetVariables()
 
 Variable *GetVariableByName(const std::string &name)
 {
-	for (const auto &v : variables) {
-		if (v->Name() == name) {
-			return dynamic_cast<Variable *>(v.get());
-		}
-	}
-
-	return nullptr;
+	return dynamic_cast<Variable *>(GetItemByName(variables, name).get());
 }
 
 Variable *GetVariableByQString(const QString &name)
@@ -432,15 +435,8 @@ Variable *GetVariableByQString(const QString &name)
 
 std::weak_ptr<Variable> GetWeakVariableByName(const std::string &name)
 {
-	for (const auto &v : variables) {
-		if (v->Name() == name) {
-			std::weak_ptr<Variable> wp =
-				std::dynamic_pointer_cast<Variable>(v);
-			return wp;
-		}
-	}
-
-	return std::weak_ptr<Variable>();
+	return std::dynamic_pointer_cast<Variable>(
+		GetItemByName(variables, name));
 }
 
 std::weak_ptr<Variable> GetWeakVariableByQString(const QString &name)
@@ -537,10 +533,9 @@ void ImportVariables(obs_data_t *data)
 	QueueUITask(signalImportedVariables, importedVars);
 }
 
-std::chrono::high_resolution_clock::time_point GetLastVariableChangeTime()
+uint64_t GetVariableListVersion()
 {
-	std::lock_guard<std::mutex> lock(lastVariableChangeMutex);
-	return lastVariableChange;
+	return variableListVersion;
 }
 
 } // namespace advss
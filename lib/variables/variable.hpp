@@ -3,6 +3,7 @@
 #include "item-selection-helpers.hpp"
 #include "resizing-text-edit.hpp"
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <obs-data.h>
@@ -42,6 +43,9 @@ public:
 	void SetValue(double value);
 	SaveAction GetSaveAction() const { return _saveAction; }
 	int GetValueChangeCount() const;
+	// Incremented whenever the value changes and can be checked without
+	// acquiring the lock protecting the value
+	EXPORT uint64_t GetVersion() const { return _version; }
 	std::optional<uint64_t> GetSecondsSinceLastUse() const;
 	std::optional<uint64_t> GetSecondsSinceLastChange() const;
 	void MarkAsUsed() const;
@@ -57,6 +61,7 @@ private:
 	std::string _previousValue = "";
 	std::string _defaultValue = "";
 	int _valueChangeCount = 0;
+	std::atomic<uint64_t> _version{0};
 	mutable std::chrono::high_resolution_clock::time_point _lastUsed;
 	mutable std::chrono::high_resolution_clock::time_point _lastChanged;
 	mutable std::mutex _mutex;
@@ -120,6 +125,7 @@ signals:
 using VariableContext = std::unordered_map<std::string, std::string>;
 VariableContext CreateVariableContext();
 void SetActiveVariableContext(VariableContext *context);
+bool IsVariableContextActive();
 
 std::deque<std::shared_ptr<Item>> &GetVariables();
 EXPORT Variable *GetVariableByName(const std::string &name);
@@ -133,6 +139,6 @@ void SaveVariables(obs_data_t *obj);
 void LoadVariables(obs_data_t *obj);
 void ImportVariables(obs_data_t *obj);
 
-std::chrono::high_resolution_clock::time_point GetLastVariableChangeTime();
+uint64_t GetVariableListVersion();
 
 } // namespace advss
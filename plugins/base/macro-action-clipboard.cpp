@@ -1,5 +1,5 @@
 #include "macro-action-clipboard.hpp"
-#include "curl-helper.hpp"
+#include "curl-request-engine.hpp"
 
 #include <obs.hpp>
 #include <QApplication>
@@ -23,32 +23,23 @@ const static std::map<MacroActionClipboard::Action, std::string> actionTypes = {
 	 "AdvSceneSwitcher.action.clipboard.type.copy.image"},
 };
 
-static size_t writeCallback(void *ptr, size_t size, size_t nmemb,
-			    QByteArray *buffer)
-{
-	buffer->append((char *)ptr, nmemb);
-	return size * nmemb;
-}
-
 static std::optional<QImage> getImageFromUrl(const char *url)
 {
-	QByteArray response;
-
-	CurlHelper::SetOpt(CURLOPT_URL, url);
-	CurlHelper::SetOpt(CURLOPT_HTTPGET, 1L);
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, 30000);
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, writeCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &response);
-	auto code = CurlHelper::Perform();
+	CurlRequest request;
+	request.url = url;
+	request.timeout = std::chrono::seconds(30);
+	const auto response =
+		GetCurlRequestEngine().Perform(std::move(request));
 
-	if (code != CURLE_OK) {
+	if (response.code != CURLE_OK) {
 		blog(LOG_WARNING,
 		     "Retrieving image failed in %s with error: %s", __func__,
-		     CurlHelper::GetError(code));
+		     response.error.c_str());
 		return {};
 	}
 
-	return QImage::fromData(response);
+	return QImage::fromData(QByteArray(response.body.data(),
+					   (int)response.body.size()));
 }
 
 static void setMimeTypeParams(ClipboardQueueParams *params,
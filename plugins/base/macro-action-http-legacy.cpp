@@ -1,5 +1,6 @@
 #include "macro-action-http-legacy.hpp"
 #include "curl-helper.hpp"
+#include "curl-request-engine.hpp"
 #include "layout-helpers.hpp"
 
 namespace advss {
@@ -17,57 +18,39 @@ const static std::map<MacroActionHttp::Method, std::string> methods = {
 	 "AdvSceneSwitcher.action.http.type.post"},
 };
 
-static size_t DropCB(void *, size_t size, size_t nmemb, std::string *)
-{
-	return size * nmemb;
-}
-
-static size_t WriteCB(void *ptr, size_t size, size_t nmemb, std::string *buffer)
-{
-	buffer->append((char *)ptr, nmemb);
-	return size * nmemb;
-}
-
-void MacroActionHttp::SetupHeaders()
+void MacroActionHttp::SetupHeaders(CurlRequest &request) const
 {
 	if (!_setHeaders) {
 		return;
 	}
-	struct curl_slist *headers = nullptr;
 	for (auto &header : _headers) {
-		headers = CurlHelper::SlistAppend(headers, header.c_str());
-	}
-	if (!_headers.empty()) {
-		CurlHelper::SetOpt(CURLOPT_HTTPHEADER, headers);
+		request.headers.emplace_back(header);
 	}
 }
 
 void MacroActionHttp::Get()
 {
-	CurlHelper::SetOpt(CURLOPT_URL, _url.c_str());
-	CurlHelper::SetOpt(CURLOPT_HTTPGET, 1L);
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, _timeout.Milliseconds());
-	SetupHeaders();
-
-	std::string response;
-	if (IsReferencedInVars()) {
-		CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCB);
-	} else {
-		CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, DropCB);
-	}
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &response);
-	CurlHelper::Perform();
-
-	SetVariableValue(response);
+	CurlRequest request;
+	request.url = _url;
+	request.timeout = std::chrono::milliseconds(
+		(long long)_timeout.Milliseconds());
+	request.discardResponseBody = !IsReferencedInVars();
+	SetupHeaders(request);
+
+	auto response = GetCurlRequestEngine().Perform(std::move(request));
+	SetVariableValue(response.body);
 }
 
 void MacroActionHttp::Post()
 {
-	CurlHelper::SetOpt(CURLOPT_URL, _url.c_str());
-	CurlHelper::SetOpt(CURLOPT_POSTFIELDS, _data.c_str());
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, _timeout.Milliseconds());
-	SetupHeaders();
-	CurlHelper::Perform();
+	CurlRequest request;
+	request.url = _url;
+	request.method = "POST";
+	request.body = _data;
+	request.timeout = std::chrono::milliseconds(
+		(long long)_timeout.Milliseconds());
+	SetupHeaders(request);
+	GetCurlRequestEngine().Perform(std::move(request));
 }
 
 bool MacroActionHttp::PerformAction()
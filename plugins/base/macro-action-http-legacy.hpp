@@ -11,6 +11,8 @@
 
 namespace advss {
 
+struct CurlRequest;
+
 class MacroActionHttp : public MacroAction {
 public:
 	MacroActionHttp(Macro *m) : MacroAction(m, true) {}
@@ -37,7 +39,7 @@ public:
 	Duration _timeout = Duration(1.0);
 
 private:
-	void SetupHeaders();
+	void SetupHeaders(CurlRequest &) const;
 	void Get();
 	void Post();
 
@@ -94,15 +94,16 @@ static std::string getCurrentClipboardText()
 	return clipboard->text().toStdString();
 }
 
+bool MacroConditionClipboard::HasPendingMessages() const
+{
+	return _messageBuffer && !_messageBuffer->Empty();
+}
+
 bool MacroConditionClipboard::CheckCondition()
 {
 	switch (_condition) {
 	case Condition::CHANGED:
-		while (!_messageBuffer->Empty()) {
-			auto message = _messageBuffer->ConsumeMessage();
-			if (!message) {
-				continue;
-			}
+		while (auto message = _messageBuffer->ConsumeMessage()) {
 			SetTempVarValue("text", *message);
 			return true;
 		}
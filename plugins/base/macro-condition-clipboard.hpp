@@ -34,6 +34,7 @@ public:
 	static std::shared_ptr<MacroCondition> Create(Macro *m);
 	std::string GetId() const { return id; };
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
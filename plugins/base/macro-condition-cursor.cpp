@@ -1,5 +1,6 @@
 #include "macro-condition-cursor.hpp"
 #include "cursor-helpers.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "utility.hpp"
 
@@ -52,7 +53,7 @@ bool MacroConditionCursor::CheckClick()
 bool MacroConditionCursor::CheckCondition()
 {
 	bool ret = false;
-	const auto &[x, y] = GetCursorPos();
+	const auto &[x, y] = EnvironmentSnapshot::Get().GetCursorPos();
 	SetTempVarValue("x", std::to_string(x));
 	SetTempVarValue("y", std::to_string(y));
 
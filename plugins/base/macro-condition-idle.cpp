@@ -1,4 +1,5 @@
 #include "macro-condition-idle.hpp"
+#include "environment-snapshot.hpp"
 #include "platform-funcs.hpp"
 #include "layout-helpers.hpp"
 
@@ -13,7 +14,7 @@ bool MacroConditionIdle::_registered = MacroConditionFactory::Register(
 
 bool MacroConditionIdle::CheckCondition()
 {
-	auto seconds = SecondsSinceLastInput();
+	auto seconds = EnvironmentSnapshot::Get().SecondsSinceLastInput();
 	SetVariableValue(std::to_string(seconds));
 	return seconds >= _duration.Seconds();
 }
@@ -1,4 +1,5 @@
 #include "macro-condition-process.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
 #include "selection-helpers.hpp"
@@ -16,7 +17,8 @@ bool MacroConditionProcess::_registered = MacroConditionFactory::Register(
 
 bool MacroConditionProcess::CheckCondition()
 {
-	const auto foregroundProcessName = GetForegroundProcessName();
+	const auto foregroundProcessName =
+		EnvironmentSnapshot::Get().GetForegroundProcessName();
 	SetVariableValue(foregroundProcessName);
 
 	const QString proc = QString::fromStdString(_process);
@@ -25,7 +27,8 @@ bool MacroConditionProcess::CheckCondition()
 		// Check name and path against the same foreground process
 		// instance to avoid false positives when multiple processes
 		// share the same name
-		const auto foregroundPath = GetForegroundProcessPath();
+		const auto foregroundPath =
+			EnvironmentSnapshot::Get().GetForegroundProcessPath();
 		const QString foregroundName =
 			QString::fromStdString(foregroundProcessName);
 
@@ -57,7 +60,8 @@ bool MacroConditionProcess::CheckCondition()
 		return true;
 	}
 
-	const auto runningProcesses = GetProcessList();
+	const auto runningProcesses =
+		EnvironmentSnapshot::Get().GetProcessList();
 
 	for (const auto &process : runningProcesses) {
 		bool nameMatches = _regex.Enabled()
@@ -72,7 +76,9 @@ bool MacroConditionProcess::CheckCondition()
 			return true;
 		}
 
-		const auto paths = GetProcessPathsFromName(process);
+		const auto paths =
+			EnvironmentSnapshot::Get().GetProcessPathsFromName(
+				process);
 
 		const QString pathPattern =
 			QString::fromStdString(_processPath);
@@ -24,7 +24,12 @@ const static std::map<MacroConditionWebsocket::Type, std::string>
 MacroConditionWebsocket::MacroConditionWebsocket(Macro *m)
 	: MacroCondition(m, true)
 {
-	_messageBuffer = RegisterForWebsocketMessages();
+	RegisterForMessages();
+}
+
+bool MacroConditionWebsocket::HasPendingMessages() const
+{
+	return _messageBuffer && !_messageBuffer->Empty();
 }
 
 bool MacroConditionWebsocket::CheckCondition()
@@ -41,11 +46,7 @@ bool MacroConditionWebsocket::CheckCondition()
 		return false;
 	}
 
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
+	while (auto message = _messageBuffer->ConsumeMessage()) {
 		if (_regex.Enabled()) {
 			if (!_regex.Matches(*message, _message)) {
 				continue;
@@ -121,16 +122,7 @@ std::string MacroConditionWebsocket::GetShortDesc() const
 void MacroConditionWebsocket::SetType(Type type)
 {
 	_type = type;
-	if (_type == Type::REQUEST) {
-		_messageBuffer = RegisterForWebsocketMessages();
-		return;
-	}
-
-	auto connection = _connection.lock();
-	if (!connection) {
-		return;
-	}
-	_messageBuffer = connection->RegisterForEvents();
+	RegisterForMessages();
 }
 
 void MacroConditionWebsocket::SetConnection(const std::string &connectionName)
@@ -140,12 +132,44 @@ void MacroConditionWebsocket::SetConnection(const std::string &connectionName)
 		// This should not really happen, but let's be safe
 		return;
 	}
+	RegisterForMessages();
+}
+
+void MacroConditionWebsocket::RegisterForMessages()
+{
+	UpdateMessageFilter();
+	if (_type == Type::REQUEST) {
+		_messageBuffer =
+			RegisterForWebsocketMessages(_messageFilter.Get());
+		return;
+	}
 
 	auto connection = _connection.lock();
 	if (!connection) {
 		return;
 	}
-	_messageBuffer = connection->RegisterForEvents();
+	_messageBuffer = connection->RegisterForEvents(_messageFilter.Get());
+}
+
+void MacroConditionWebsocket::UpdateMessageFilter()
+{
+	_messageFilter.Set(CreateMessageFilter());
+}
+
+WebsocketMessageFilter MacroConditionWebsocket::CreateMessageFilter() const
+{
+	// The filter runs on the websocket threads, so it only works with
+	// copies of the settings
+	const auto pattern = _message.UnresolvedValue();
+	if (pattern.find("${") != std::string::npos) {
+		// Variables can only be resolved when checking the condition
+		return {};
+	}
+	const auto regex = _regex;
+	return [pattern, regex](const std::string &message) {
+		return regex.Enabled() ? regex.Matches(message, pattern)
+				       : message == pattern;
+	};
 }
 
 std::weak_ptr<WSConnection> MacroConditionWebsocket::GetConnection() const
@@ -283,6 +307,7 @@ void MacroConditionWebsocketEdit::MessageChanged()
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_message = _message->toPlainText().toUtf8().constData();
+	_entryData->UpdateMessageFilter();
 
 	adjustSize();
 	updateGeometry();
@@ -306,6 +331,7 @@ void MacroConditionWebsocketEdit::RegexChanged(const RegexConfig &conf)
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_regex = conf;
+	_entryData->UpdateMessageFilter();
 
 	adjustSize();
 	updateGeometry();
@@ -13,6 +13,7 @@ class MacroConditionWebsocket : public MacroCondition {
 public:
 	MacroConditionWebsocket(Macro *m);
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc() const;
@@ -31,17 +32,23 @@ public:
 	Type GetType() const { return _type; }
 	void SetConnection(const std::string &);
 	std::weak_ptr<WSConnection> GetConnection() const;
+	// Has to be called whenever the message or regex settings change.
+	// Messages which were already received are kept.
+	void UpdateMessageFilter();
 	StringVariable _message = obs_module_text("AdvSceneSwitcher.enterText");
 	RegexConfig _regex;
 	bool _clearBufferOnMatch = true;
 
 private:
 	void SetupTempVars();
+	void RegisterForMessages();
+	WebsocketMessageFilter CreateMessageFilter() const;
 
 	Type _type = Type::REQUEST;
 	std::weak_ptr<WSConnection> _connection;
 
 	WebsocketMessageBuffer _messageBuffer;
+	ReplaceableMessageFilter<std::string> _messageFilter;
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
 
 	static bool _registered;
@@ -1,4 +1,5 @@
 #include "macro-condition-window.hpp"
+#include "environment-snapshot.hpp"
 #include "layout-helpers.hpp"
 #include "plugin-state-helpers.hpp"
 #include "platform-funcs.hpp"
@@ -123,7 +124,7 @@ bool MacroConditionWindow::CheckCondition()
 	options.text = _checkText;
 #endif
 
-	const auto windows = GetWindows(options);
+	const auto windows = EnvironmentSnapshot::Get().GetWindows(options);
 	bool match = FindMatch(windows);
 	match = match && (!_windowFocusChanged || foregroundWindowChanged());
 	return match;
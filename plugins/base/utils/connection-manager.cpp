@@ -247,9 +247,10 @@ void WSConnection::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "version", 1);
 }
 
-WebsocketMessageBuffer WSConnection::RegisterForEvents()
+WebsocketMessageBuffer
+WSConnection::RegisterForEvents(const WebsocketMessageFilter &filter)
 {
-	return _client.RegisterForEvents();
+	return _client.RegisterForEvents(filter);
 }
 
 void WSConnection::UseOBSWebsocketProtocol(bool useOBSWSProtocol)
@@ -265,24 +266,14 @@ WSConnection *GetConnectionByName(const QString &name)
 
 WSConnection *GetConnectionByName(const std::string &name)
 {
-	for (auto &con : connections) {
-		if (con->Name() == name) {
-			return dynamic_cast<WSConnection *>(con.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<WSConnection *>(
+		GetItemByName(connections, name).get());
 }
 
 std::weak_ptr<WSConnection> GetWeakConnectionByName(const std::string &name)
 {
-	for (const auto &c : connections) {
-		if (c->Name() == name) {
-			std::weak_ptr<WSConnection> wp =
-				std::dynamic_pointer_cast<WSConnection>(c);
-			return wp;
-		}
-	}
-	return std::weak_ptr<WSConnection>();
+	return std::dynamic_pointer_cast<WSConnection>(
+		GetItemByName(connections, name));
 }
 
 std::weak_ptr<WSConnection> GetWeakConnectionByQString(const QString &name)
@@ -605,6 +596,16 @@ ConnectionSelectionSignalManager::ConnectionSelectionSignalManager(
 	QObject *parent)
 	: QObject(parent)
 {
+	// Keep the name index used for lookups up to date
+	const auto invalidateIndex = []() {
+		InvalidateItemNameIndex(connections);
+	};
+	connect(this, &ConnectionSelectionSignalManager::Add, this,
+		invalidateIndex);
+	connect(this, &ConnectionSelectionSignalManager::Rename, this,
+		invalidateIndex);
+	connect(this, &ConnectionSelectionSignalManager::Remove, this,
+		invalidateIndex);
 }
 
 ConnectionSelectionSignalManager *ConnectionSelectionSignalManager::Instance()
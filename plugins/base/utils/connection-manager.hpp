@@ -41,7 +41,8 @@ public:
 	void Load(obs_data_t *obj);
 	void Save(obs_data_t *obj) const;
 	std::string GetName() const { return _name; }
-	WebsocketMessageBuffer RegisterForEvents();
+	WebsocketMessageBuffer
+	RegisterForEvents(const WebsocketMessageFilter &filter = {});
 	bool IsUsingOBSProtocol() const { return _useOBSWSProtocol; }
 	std::string GetURI() const;
 	uint64_t GetPort() const { return _port; }
@@ -34,9 +34,10 @@ bool setup()
 	return true;
 }
 
-WebsocketMessageBuffer RegisterForWebsocketMessages()
+WebsocketMessageBuffer
+RegisterForWebsocketMessages(const WebsocketMessageFilter &filter)
 {
-	return websocketMessageDispatcher.RegisterClient();
+	return websocketMessageDispatcher.RegisterClient(filter);
 }
 
 void SendWebsocketEvent(const std::string &eventMsg)
@@ -198,9 +199,10 @@ void WSClientConnection::SendRequest(const std::string &msg)
 	Send(msg);
 }
 
-WebsocketMessageBuffer WSClientConnection::RegisterForEvents()
+WebsocketMessageBuffer
+WSClientConnection::RegisterForEvents(const WebsocketMessageFilter &filter)
 {
-	return _dispatcher.RegisterClient();
+	return _dispatcher.RegisterClient(filter);
 }
 
 WSClientConnection::Status WSClientConnection::GetStatus() const
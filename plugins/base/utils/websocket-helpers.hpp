@@ -25,10 +25,12 @@ namespace advss {
 using websocketpp::connection_hdl;
 using WebsocketMessageBuffer = std::shared_ptr<MessageBuffer<std::string>>;
 using WebsocketMessageDispatcher = MessageDispatcher<std::string>;
+using WebsocketMessageFilter = WebsocketMessageDispatcher::Filter;
 
 void SendWebsocketEvent(const std::string &);
 std::string ConstructVendorRequestMessage(const std::string &message);
-[[nodiscard]] WebsocketMessageBuffer RegisterForWebsocketMessages();
+[[nodiscard]] WebsocketMessageBuffer
+RegisterForWebsocketMessages(const WebsocketMessageFilter &filter = {});
 
 class WSClientConnection : public QObject {
 	using server = websocketpp::server<websocketpp::config::asio>;
@@ -42,7 +44,8 @@ public:
 		     bool _reconnect, int reconnectDelay = 10);
 	void Disconnect();
 	void SendRequest(const std::string &msg);
-	[[nodiscard]] WebsocketMessageBuffer RegisterForEvents();
+	[[nodiscard]] WebsocketMessageBuffer
+	RegisterForEvents(const WebsocketMessageFilter &filter = {});
 	std::string GetFail() { return _failMsg; }
 
 	enum class Status {
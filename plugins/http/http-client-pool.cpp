@@ -0,0 +1,110 @@
+#include "http-client-pool.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <httplib.h>
+
+namespace advss {
+
+static bool setup();
+static bool setupDone = setup();
+
+bool setup()
+{
+	AddPluginCleanupStep([]() { GetHttpClientPool().Clear(); });
+	return true;
+}
+
+HttpClientPool::Lease::Lease(HttpClientPool &pool, const std::string &origin,
+			     std::unique_ptr<httplib::Client> client)
+	: _pool(&pool),
+	  _origin(origin),
+	  _client(std::move(client))
+{
+}
+
+HttpClientPool::Lease::Lease(Lease &&other) noexcept
+	: _pool(other._pool),
+	  _origin(std::move(other._origin)),
+	  _client(std::move(other._client)),
+	  _discard(other._discard)
+{
+}
+
+HttpClientPool::Lease::~Lease()
+{
+	if (!_client || _discard) {
+		return;
+	}
+	_pool->Release(_origin, std::move(_client));
+}
+
+HttpClientPool::HttpClientPool(size_t maxIdleClientsPerOrigin,
+			       size_t maxIdleClients)
+	: _maxIdleClientsPerOrigin(maxIdleClientsPerOrigin),
+	  _maxIdleClients(maxIdleClients)
+{
+}
+
+HttpClientPool::~HttpClientPool() = default;
+
+HttpClientPool::Lease HttpClientPool::Acquire(const std::string &origin)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _idleClients.find(origin);
+		if (it != _idleClients.end() && !it->second.empty()) {
+			auto client = std::move(it->second.back());
+			it->second.pop_back();
+			--_idleClientCount;
+			return Lease(*this, origin, std::move(client));
+		}
+	}
+
+	// Creating a client does not connect yet, so there is no need to hold
+	// the lock here
+	auto client = std::make_unique<httplib::Client>(origin);
+	client->set_keep_alive(true);
+	return Lease(*this, origin, std::move(client));
+}
+
+void HttpClientPool::Release(const std::string &origin,
+			     std::unique_ptr<httplib::Client> client)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto &clients = _idleClients[origin];
+	if (clients.size() >= _maxIdleClientsPerOrigin ||
+	    _idleClientCount >= _maxIdleClients) {
+		// Close the connection without holding the lock
+		lock.unlock();
+		client.reset();
+		return;
+	}
+	clients.emplace_back(std::move(client));
+	++_idleClientCount;
+}
+
+void HttpClientPool::Clear()
+{
+	std::unordered_map<std::string,
+			   std::vector<std::unique_ptr<httplib::Client>>>
+		clients;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::swap(clients, _idleClients);
+		_idleClientCount = 0;
+	}
+}
+
+size_t HttpClientPool::IdleClientCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _idleClientCount;
+}
+
+HttpClientPool &GetHttpClientPool()
+{
+	static HttpClientPool pool;
+	return pool;
+}
+
+} // namespace advss
@@ -0,0 +1,66 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace httplib {
+class Client;
+}
+
+namespace advss {
+
+// Keeps the connections of previously used clients open, so repeated requests
+// to the same origin, like "http://localhost:8080", do not have to pay for
+// DNS lookups, TCP and TLS handshakes each time.
+// A client cannot be used by multiple threads at once, so each request
+// borrows a client exclusively until the returned lease is destroyed.
+class HttpClientPool {
+public:
+	class Lease {
+	public:
+		Lease(HttpClientPool &, const std::string &origin,
+		      std::unique_ptr<httplib::Client>);
+		Lease(Lease &&) noexcept;
+		~Lease();
+		Lease(const Lease &) = delete;
+		Lease &operator=(const Lease &) = delete;
+
+		httplib::Client &operator*() const { return *_client; }
+		httplib::Client *operator->() const { return _client.get(); }
+		// The client will be closed instead of being returned to the
+		// pool, e.g. as its connection might be in an unknown state
+		void Discard() { _discard = true; }
+
+	private:
+		HttpClientPool *_pool;
+		std::string _origin;
+		std::unique_ptr<httplib::Client> _client;
+		bool _discard = false;
+	};
+
+	HttpClientPool(size_t maxIdleClientsPerOrigin = 4,
+		       size_t maxIdleClients = 64);
+	~HttpClientPool();
+
+	Lease Acquire(const std::string &origin);
+	void Clear();
+	size_t IdleClientCount() const;
+
+private:
+	void Release(const std::string &origin,
+		     std::unique_ptr<httplib::Client>);
+
+	const size_t _maxIdleClientsPerOrigin;
+	const size_t _maxIdleClients;
+	mutable std::mutex _mutex;
+	std::unordered_map<std::string,
+			   std::vector<std::unique_ptr<httplib::Client>>>
+		_idleClients;
+	size_t _idleClientCount = 0;
+};
+
+HttpClientPool &GetHttpClientPool();
+
+} // namespace advss
@@ -0,0 +1,47 @@
+#include "http-pending-response.hpp"
+
+namespace advss {
+
+void HttpPendingResponse::Set(int status, const std::string &body)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_response) {
+			return;
+		}
+		_response = Response{status, body};
+	}
+	_cv.notify_all();
+}
+
+std::optional<HttpPendingResponse::Response>
+HttpPendingResponse::Wait(std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cv.wait_for(lock, timeout, [this]() { return _response.has_value(); });
+	return _response;
+}
+
+HttpResponseHandle::HttpResponseHandle(
+	std::shared_ptr<HttpPendingResponse> response)
+	: _response(std::move(response))
+{
+}
+
+HttpResponseHandle::~HttpResponseHandle()
+{
+	// Ignored if a response was already set
+	_response->Set(_fallbackStatus, "");
+}
+
+void HttpResponseHandle::Set(int status, const std::string &body)
+{
+	_response->Set(status, body);
+}
+
+void HttpResponseHandle::SetFallbackStatus(int status)
+{
+	_fallbackStatus = status;
+}
+
+} // namespace advss
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace advss {
+
+// Allows the macro handling a request to decide what the server responds with
+// while the server keeps the connection open
+class HttpPendingResponse {
+public:
+	struct Response {
+		int status;
+		std::string body;
+	};
+
+	// Only the first response is sent, later ones are ignored
+	void Set(int status, const std::string &body);
+	// Returns std::nullopt if no response was set within the timeout
+	std::optional<Response> Wait(std::chrono::milliseconds timeout);
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::optional<Response> _response;
+};
+
+// Shared by all copies of a request delivered to routes holding the response.
+// If the last copy is discarded before a response was set, e.g. because the
+// request did not match or was removed from a full buffer, the fallback
+// response is sent right away instead of keeping the client waiting.
+class HttpResponseHandle {
+public:
+	explicit HttpResponseHandle(std::shared_ptr<HttpPendingResponse>);
+	~HttpResponseHandle();
+
+	void Set(int status, const std::string &body);
+	void SetFallbackStatus(int status);
+
+private:
+	std::shared_ptr<HttpPendingResponse> _response;
+	std::atomic_int _fallbackStatus{503};
+};
+
+} // namespace advss
@@ -0,0 +1,195 @@
+#include "http-route-table.hpp"
+
+#include <algorithm>
+
+namespace advss {
+
+static std::vector<std::string_view> splitPath(std::string_view path)
+{
+	std::vector<std::string_view> segments;
+	size_t start = 0;
+	while (true) {
+		const auto end = path.find('/', start);
+		if (end == std::string_view::npos) {
+			segments.emplace_back(path.substr(start));
+			return segments;
+		}
+		segments.emplace_back(path.substr(start, end - start));
+		start = end + 1;
+	}
+}
+
+static bool isParameter(std::string_view segment)
+{
+	return segment.size() >= 2 && segment.front() == '{' &&
+	       segment.back() == '}';
+}
+
+static std::string getParameterName(std::string_view segment)
+{
+	return std::string(segment.substr(1, segment.size() - 2));
+}
+
+size_t HttpRouteTable::Add(const std::string &method,
+			   const std::string &pathTemplate,
+			   bool matchParameters)
+{
+	Route route;
+	route.method = method;
+	route.matchParameters = matchParameters;
+	for (const auto segment : splitPath(pathTemplate)) {
+		route.segments.emplace_back(segment);
+		if (matchParameters && isParameter(segment)) {
+			route.parameterNames.emplace_back(
+				getParameterName(segment));
+		}
+	}
+
+	const auto id = _nextId++;
+	_routes.emplace(id, std::move(route));
+	_outdated = true;
+	return id;
+}
+
+void HttpRouteTable::Remove(size_t id)
+{
+	_routes.erase(id);
+	_outdated = true;
+}
+
+void HttpRouteTable::Clear()
+{
+	_routes.clear();
+	_outdated = true;
+}
+
+void HttpRouteTable::Build()
+{
+	_nodes.assign(1, Node());
+	for (const auto &[id, route] : _routes) {
+		size_t node = 0;
+		for (const auto &segment : route.segments) {
+			if (route.matchParameters && isParameter(segment)) {
+				if (_nodes[node].parameter == 0) {
+					_nodes[node].parameter = _nodes.size();
+					_nodes.emplace_back();
+				}
+				node = _nodes[node].parameter;
+				continue;
+			}
+
+			auto it = _nodes[node].literals.find(segment);
+			if (it != _nodes[node].literals.end()) {
+				node = it->second;
+				continue;
+			}
+			const auto next = _nodes.size();
+			_nodes[node].literals.emplace(segment, next);
+			_nodes.emplace_back();
+			node = next;
+		}
+		_nodes[node].routes.emplace_back(id);
+	}
+	_outdated = false;
+}
+
+void HttpRouteTable::Find(size_t node,
+			  const std::vector<std::string_view> &segments,
+			  size_t depth, std::vector<std::string_view> &values,
+			  const std::string &method,
+			  std::vector<Match> &result) const
+{
+	if (depth == segments.size()) {
+		for (const auto id : _nodes[node].routes) {
+			const auto &route = _routes.at(id);
+			if (!route.method.empty() && route.method != method) {
+				continue;
+			}
+			Match match{id, {}};
+			for (size_t i = 0; i < route.parameterNames.size();
+			     i++) {
+				match.parameters[route.parameterNames[i]] =
+					std::string(values[i]);
+			}
+			result.emplace_back(std::move(match));
+		}
+		return;
+	}
+
+	const auto &segment = segments[depth];
+	const auto &literals = _nodes[node].literals;
+	// Avoid constructing a std::string if there are no literals to check
+	if (!literals.empty()) {
+		auto it = literals.find(std::string(segment));
+		if (it != literals.end()) {
+			Find(it->second, segments, depth + 1, values, method,
+			     result);
+		}
+	}
+	if (_nodes[node].parameter != 0) {
+		values.emplace_back(segment);
+		Find(_nodes[node].parameter, segments, depth + 1, values,
+		     method, result);
+		values.pop_back();
+	}
+}
+
+std::vector<HttpRouteTable::Match>
+HttpRouteTable::Find(const std::string &method, const std::string &path)
+{
+	if (_outdated) {
+		Build();
+	}
+
+	std::vector<Match> result;
+	std::vector<std::string_view> values;
+	Find(0, splitPath(path), 0, values, method, result);
+	std::sort(result.begin(), result.end(),
+		  [](const Match &a, const Match &b) { return a.id < b.id; });
+	return result;
+}
+
+std::vector<std::string>
+HttpRouteTable::GetParameterNames(const std::string &pathTemplate)
+{
+	std::vector<std::string> names;
+	for (const auto segment : splitPath(pathTemplate)) {
+		if (!isParameter(segment)) {
+			continue;
+		}
+		auto name = getParameterName(segment);
+		if (name.empty() ||
+		    std::find(names.begin(), names.end(), name) !=
+			    names.end()) {
+			continue;
+		}
+		names.emplace_back(std::move(name));
+	}
+	return names;
+}
+
+bool HttpRouteTable::MatchPath(const std::string &pathTemplate,
+			       const std::string &path, Parameters *parameters)
+{
+	const auto templateSegments = splitPath(pathTemplate);
+	const auto segments = splitPath(path);
+	if (templateSegments.size() != segments.size()) {
+		return false;
+	}
+
+	Parameters values;
+	for (size_t i = 0; i < segments.size(); i++) {
+		if (isParameter(templateSegments[i])) {
+			values[getParameterName(templateSegments[i])] =
+				std::string(segments[i]);
+		} else if (templateSegments[i] != segments[i]) {
+			return false;
+		}
+	}
+	if (parameters) {
+		*parameters = std::move(values);
+	}
+	return true;
+}
+
+} // namespace advss
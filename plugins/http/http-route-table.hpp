@@ -0,0 +1,71 @@
+#pragma once
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Maps requests to routes like "/users/{id}/name", so a request only has to be
+// compared with the routes sharing its path segments instead of every route.
+// Segments enclosed in braces match any single path segment, whose value is
+// reported as a parameter of the given name.
+class HttpRouteTable {
+public:
+	using Parameters = std::map<std::string, std::string>;
+
+	struct Match {
+		size_t id;
+		Parameters parameters;
+	};
+
+	// An empty method matches requests of any method.
+	// If parameters are disabled, segments enclosed in braces are matched
+	// literally like any other segment.
+	size_t Add(const std::string &method, const std::string &pathTemplate,
+		   bool matchParameters = true);
+	void Remove(size_t id);
+	void Clear();
+	size_t Size() const { return _routes.size(); }
+
+	// Returns the matching routes ordered by id
+	std::vector<Match> Find(const std::string &method,
+				const std::string &path);
+
+	// Returns the parameter names in the order of their first occurrence
+	static std::vector<std::string>
+	GetParameterNames(const std::string &pathTemplate);
+	// Matches a path against a single template without building a table
+	static bool MatchPath(const std::string &pathTemplate,
+			      const std::string &path,
+			      Parameters *parameters = nullptr);
+
+private:
+	struct Route {
+		std::string method;
+		std::vector<std::string> segments;
+		bool matchParameters;
+		// Name of each parameter segment in order of appearance
+		std::vector<std::string> parameterNames;
+	};
+
+	struct Node {
+		std::unordered_map<std::string, size_t> literals;
+		// Child matching any segment or 0 if there is none
+		size_t parameter = 0;
+		std::vector<size_t> routes;
+	};
+
+	void Build();
+	void Find(size_t node, const std::vector<std::string_view> &segments,
+		  size_t depth, std::vector<std::string_view> &values,
+		  const std::string &method, std::vector<Match> &result) const;
+
+	size_t _nextId = 0;
+	std::unordered_map<size_t, Route> _routes;
+	bool _outdated = true;
+	std::vector<Node> _nodes;
+};
+
+} // namespace advss
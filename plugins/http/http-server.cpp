@@ -8,6 +8,8 @@
 #include <obs-data.h>
 #include <httplib.h>
 
+#include <algorithm>
+
 #undef DispatchMessage
 
 Q_DECLARE_METATYPE(advss::HttpServer *);
@@ -108,13 +110,129 @@ static void loadHttpServers(obs_data_t *obj)
 }
 
 struct HttpServer::Impl {
+	struct RouteDispatchResult {
+		bool delivered = false;
+		// Set if a matching route holds the response
+		std::shared_ptr<HttpPendingResponse> response;
+		std::chrono::milliseconds timeout{0};
+		// Set if the response could not be held as too many requests
+		// are already waiting for their response
+		bool rejected = false;
+	};
+
+	RouteDispatchResult DispatchToRoutes(const HttpRequest &request);
+	std::shared_ptr<HttpPendingResponse> HoldResponse();
+	void ReleaseResponse(const std::shared_ptr<HttpPendingResponse> &);
+	void CancelHeldResponses();
+
 	std::unique_ptr<httplib::Server> server;
 	std::thread thread;
 	std::mutex mutex;
 	std::atomic_bool listening{false};
 	MessageDispatcher<HttpRequest> dispatcher;
+
+	struct RouteClient {
+		std::weak_ptr<MessageBuffer<HttpRequest>> buffer;
+		std::chrono::milliseconds responseTimeout;
+	};
+
+	std::mutex routeMutex;
+	HttpRouteTable routes;
+	std::unordered_map<size_t, RouteClient> routeClients;
+
+	std::mutex responseMutex;
+	std::vector<std::shared_ptr<HttpPendingResponse>> heldResponses;
+	size_t maxHeldResponses = 0;
+	bool stopping = false;
 };
 
+HttpServer::Impl::RouteDispatchResult
+HttpServer::Impl::DispatchToRoutes(const HttpRequest &request)
+{
+	RouteDispatchResult result;
+	std::lock_guard<std::mutex> lock(routeMutex);
+	if (routes.Size() == 0) {
+		return result;
+	}
+
+	std::shared_ptr<const HttpRequest> sharedRequest;
+	std::shared_ptr<HttpResponseHandle> responseHandle;
+	for (auto &match : routes.Find(request.method, request.path)) {
+		const auto &client = routeClients[match.id];
+		auto buffer = client.buffer.lock();
+		if (!buffer) {
+			routes.Remove(match.id);
+			routeClients.erase(match.id);
+			continue;
+		}
+
+		const bool holdResponse = client.responseTimeout.count() > 0;
+		if (holdResponse && !result.response) {
+			result.response = HoldResponse();
+			result.rejected = !result.response;
+			if (result.response) {
+				responseHandle =
+					std::make_shared<HttpResponseHandle>(
+						result.response);
+			}
+		}
+		if (holdResponse && result.rejected) {
+			continue;
+		}
+
+		if (match.parameters.empty() && !holdResponse) {
+			if (!sharedRequest) {
+				sharedRequest =
+					std::make_shared<const HttpRequest>(
+						request);
+			}
+			buffer->AppendMessage(sharedRequest);
+		} else {
+			auto routedRequest = request;
+			routedRequest.parameters = std::move(match.parameters);
+			if (holdResponse) {
+				routedRequest.response = responseHandle;
+				result.timeout = std::max(
+					result.timeout, client.responseTimeout);
+			}
+			buffer->AppendMessage(std::move(routedRequest));
+		}
+		result.delivered = true;
+	}
+	return result;
+}
+
+std::shared_ptr<HttpPendingResponse> HttpServer::Impl::HoldResponse()
+{
+	std::lock_guard<std::mutex> lock(responseMutex);
+	if (stopping || heldResponses.size() >= maxHeldResponses) {
+		return {};
+	}
+	auto response = std::make_shared<HttpPendingResponse>();
+	heldResponses.emplace_back(response);
+	return response;
+}
+
+void HttpServer::Impl::ReleaseResponse(
+	const std::shared_ptr<HttpPendingResponse> &response)
+{
+	std::lock_guard<std::mutex> lock(responseMutex);
+	auto it = std::find(heldResponses.begin(), heldResponses.end(),
+			    response);
+	if (it != heldResponses.end()) {
+		heldResponses.erase(it);
+	}
+}
+
+void HttpServer::Impl::CancelHeldResponses()
+{
+	std::lock_guard<std::mutex> lock(responseMutex);
+	stopping = true;
+	for (const auto &response : heldResponses) {
+		response->Set(503, "");
+	}
+}
+
 HttpServer::HttpServer() : _impl(std::make_unique<Impl>()) {}
 
 HttpServer::HttpServer(const HttpServer &other)
@@ -123,6 +241,8 @@ HttpServer::HttpServer(const HttpServer &other)
 {
 	_port = other._port;
 	_startOnLoad = other._startOnLoad;
+	_workerThreads = other._workerThreads;
+	_maxHeldResponses = other._maxHeldResponses;
 }
 
 HttpServer &HttpServer::operator=(const HttpServer &other)
@@ -132,6 +252,8 @@ HttpServer &HttpServer::operator=(const HttpServer &other)
 		_name = other._name;
 		_port = other._port;
 		_startOnLoad = other._startOnLoad;
+		_workerThreads = other._workerThreads;
+		_maxHeldResponses = other._maxHeldResponses;
 	}
 	return *this;
 }
@@ -150,6 +272,7 @@ void HttpServer::Start()
 {
 	std::lock_guard<std::mutex> lock(_impl->mutex);
 
+	_impl->CancelHeldResponses();
 	if (_impl->server) {
 		_impl->server->stop();
 	}
@@ -160,6 +283,17 @@ void HttpServer::Start()
 	_impl->server = std::make_unique<httplib::Server>();
 	_impl->listening.store(false);
 
+	const int workerThreads = std::max(_workerThreads, 2);
+	_impl->server->new_task_queue = [workerThreads]() {
+		return new httplib::ThreadPool(workerThreads);
+	};
+	{
+		std::lock_guard<std::mutex> lock(_impl->responseMutex);
+		_impl->maxHeldResponses =
+			std::clamp(_maxHeldResponses, 1, workerThreads - 1);
+		_impl->stopping = false;
+	}
+
 	auto handleRequest = [this](const httplib::Request &req,
 				    httplib::Response &res) {
 		HttpRequest request;
@@ -169,8 +303,29 @@ void HttpServer::Start()
 		for (const auto &[name, value] : req.headers) {
 			request.headers.emplace(name, value);
 		}
-		_impl->dispatcher.DispatchMessage(request);
-		res.status = 200;
+		const auto result = _impl->DispatchToRoutes(request);
+		if (result.delivered) {
+			WakeUpMainLoop();
+		}
+		_impl->dispatcher.DispatchMessage(std::move(request));
+
+		if (result.rejected) {
+			res.status = 503;
+			return;
+		}
+		if (!result.response) {
+			res.status = 200;
+			return;
+		}
+
+		auto response = result.response->Wait(result.timeout);
+		_impl->ReleaseResponse(result.response);
+		if (!response) {
+			res.status = 504;
+			return;
+		}
+		res.status = response->status;
+		res.set_content(response->body, "text/plain");
 	};
 
 	_impl->server->Get(".*", handleRequest);
@@ -206,6 +361,8 @@ void HttpServer::Stop()
 		return;
 	}
 	std::lock_guard<std::mutex> lock(_impl->mutex);
+	// Requests waiting for a response would delay stopping the server
+	_impl->CancelHeldResponses();
 	if (_impl->server) {
 		_impl->server->stop();
 	}
@@ -216,9 +373,63 @@ void HttpServer::Stop()
 	_impl->listening.store(false);
 }
 
-HttpRequestBuffer HttpServer::RegisterForRequests()
+HttpRequestBuffer
+HttpServer::RegisterForRequests(const HttpRequestFilter &filter)
 {
-	return _impl->dispatcher.RegisterClient();
+	return _impl->dispatcher.RegisterClient(filter);
+}
+
+HttpRequestBuffer
+HttpServer::RegisterRoute(const std::string &method,
+			  const std::string &pathTemplate,
+			  std::chrono::milliseconds responseTimeout,
+			  bool matchParameters)
+{
+	std::lock_guard<std::mutex> lock(_impl->routeMutex);
+	auto &clients = _impl->routeClients;
+	for (auto it = clients.begin(); it != clients.end();) {
+		if (it->second.buffer.expired()) {
+			_impl->routes.Remove(it->first);
+			it = clients.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto buffer = std::make_shared<MessageBuffer<HttpRequest>>();
+	const auto id =
+		_impl->routes.Add(method, pathTemplate, matchParameters);
+	clients[id] = {buffer, responseTimeout};
+	return buffer;
+}
+
+bool HttpServer::UpdateRoute(const HttpRequestBuffer &buffer,
+			     const std::string &method,
+			     const std::string &pathTemplate,
+			     std::chrono::milliseconds responseTimeout,
+			     bool matchParameters)
+{
+	if (!buffer) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_impl->routeMutex);
+	auto &clients = _impl->routeClients;
+	auto it = std::find_if(clients.begin(), clients.end(),
+			       [&buffer](const auto &client) {
+				       return client.second.buffer.lock() ==
+					      buffer;
+			       });
+	if (it == clients.end()) {
+		return false;
+	}
+
+	_impl->routes.Remove(it->first);
+	clients.erase(it);
+	const auto id =
+		_impl->routes.Add(method, pathTemplate, matchParameters);
+	clients[id] = {buffer, responseTimeout};
+	return true;
 }
 
 void HttpServer::Load(obs_data_t *obj)
@@ -226,6 +437,13 @@ void HttpServer::Load(obs_data_t *obj)
 	Item::Load(obj);
 	_port = (int)obs_data_get_int(obj, "port");
 	_startOnLoad = obs_data_get_bool(obj, "startOnLoad");
+	if (obs_data_has_user_value(obj, "workerThreads")) {
+		_workerThreads = (int)obs_data_get_int(obj, "workerThreads");
+	}
+	if (obs_data_has_user_value(obj, "maxHeldResponses")) {
+		_maxHeldResponses =
+			(int)obs_data_get_int(obj, "maxHeldResponses");
+	}
 	if (_startOnLoad) {
 		Start();
 	}
@@ -236,26 +454,20 @@ void HttpServer::Save(obs_data_t *obj) const
 	Item::Save(obj);
 	obs_data_set_int(obj, "port", _port);
 	obs_data_set_bool(obj, "startOnLoad", _startOnLoad);
+	obs_data_set_int(obj, "workerThreads", _workerThreads);
+	obs_data_set_int(obj, "maxHeldResponses", _maxHeldResponses);
 }
 
 HttpServer *GetHttpServerByName(const std::string &name)
 {
-	for (auto &s : httpServers) {
-		if (s->Name() == name) {
-			return dynamic_cast<HttpServer *>(s.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<HttpServer *>(
+		GetItemByName(httpServers, name).get());
 }
 
 std::weak_ptr<HttpServer> GetWeakHttpServerByName(const std::string &name)
 {
-	for (const auto &s : httpServers) {
-		if (s->Name() == name) {
-			return std::dynamic_pointer_cast<HttpServer>(s);
-		}
-	}
-	return {};
+	return std::dynamic_pointer_cast<HttpServer>(
+		GetItemByName(httpServers, name));
 }
 
 std::weak_ptr<HttpServer> GetWeakHttpServerByQString(const QString &name)
@@ -299,12 +511,27 @@ HttpServerSettingsDialog::HttpServerSettingsDialog(QWidget *parent,
 			     parent),
 	  _port(new QSpinBox()),
 	  _startOnLoad(new QCheckBox()),
+	  _workerThreads(new QSpinBox()),
+	  _maxHeldResponses(new QSpinBox()),
 	  _layout(new QGridLayout())
 {
 	_port->setMinimum(1);
 	_port->setMaximum(65535);
 	_port->setValue(settings._port);
 	_startOnLoad->setChecked(settings._startOnLoad);
+	_workerThreads->setMinimum(2);
+	_workerThreads->setMaximum(64);
+	_workerThreads->setValue(settings._workerThreads);
+	_maxHeldResponses->setMinimum(1);
+	_maxHeldResponses->setMaximum(_workerThreads->value() - 1);
+	_maxHeldResponses->setValue(settings._maxHeldResponses);
+	_maxHeldResponses->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.httpServer.maxHeldResponses.tooltip"));
+	QWidget::connect(_workerThreads,
+			 QOverload<int>::of(&QSpinBox::valueChanged), this,
+			 [this](int value) {
+				 _maxHeldResponses->setMaximum(value - 1);
+			 });
 
 	int row = 0;
 	_layout->addWidget(
@@ -325,6 +552,18 @@ HttpServerSettingsDialog::HttpServerSettingsDialog(QWidget *parent,
 			   row, 0);
 	_layout->addWidget(_startOnLoad, row, 1);
 	++row;
+	_layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.httpServer.workerThreads")),
+		row, 0);
+	_layout->addWidget(_workerThreads, row, 1);
+	++row;
+	_layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.httpServer.maxHeldResponses")),
+		row, 0);
+	_layout->addWidget(_maxHeldResponses, row, 1);
+	++row;
 	_layout->addWidget(_buttonbox, row, 0, 1, -1);
 	setLayout(_layout);
 
@@ -342,6 +581,8 @@ bool HttpServerSettingsDialog::AskForSettings(QWidget *parent,
 	settings._name = dialog._name->text().toStdString();
 	settings._port = dialog._port->value();
 	settings._startOnLoad = dialog._startOnLoad->isChecked();
+	settings._workerThreads = dialog._workerThreads->value();
+	settings._maxHeldResponses = dialog._maxHeldResponses->value();
 	settings.Start();
 	return true;
 }
@@ -397,6 +638,13 @@ void HttpServerSelection::SetServer(const std::weak_ptr<HttpServer> &server)
 HttpServerSignalManager::HttpServerSignalManager(QObject *parent)
 	: QObject(parent)
 {
+	// Keep the name index used for lookups up to date
+	const auto invalidateIndex = []() {
+		InvalidateItemNameIndex(httpServers);
+	};
+	connect(this, &HttpServerSignalManager::Add, this, invalidateIndex);
+	connect(this, &HttpServerSignalManager::Rename, this, invalidateIndex);
+	connect(this, &HttpServerSignalManager::Remove, this, invalidateIndex);
 }
 
 HttpServerSignalManager *HttpServerSignalManager::Instance()
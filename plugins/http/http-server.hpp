@@ -1,8 +1,11 @@
 #pragma once
+#include "http-pending-response.hpp"
+#include "http-route-table.hpp"
 #include "item-selection-helpers.hpp"
 #include "message-buffer.hpp"
 #include "message-dispatcher.hpp"
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,9 +21,14 @@ struct HttpRequest {
 	std::string path;
 	std::string body;
 	std::map<std::string, std::string> headers;
+	// Only set for requests delivered via RegisterRoute()
+	HttpRouteTable::Parameters parameters;
+	// Only set for requests delivered to routes which hold the response
+	std::shared_ptr<HttpResponseHandle> response;
 };
 
 using HttpRequestBuffer = std::shared_ptr<MessageBuffer<HttpRequest>>;
+using HttpRequestFilter = MessageDispatcher<HttpRequest>::Filter;
 
 class HttpServerSelection;
 class HttpServerSettingsDialog;
@@ -40,7 +48,26 @@ public:
 	void Load(obs_data_t *obj);
 	void Save(obs_data_t *obj) const;
 
-	HttpRequestBuffer RegisterForRequests();
+	HttpRequestBuffer
+	RegisterForRequests(const HttpRequestFilter &filter = {});
+	// Only requests matching the method and path template are added to the
+	// returned buffer, see HttpRouteTable for the supported syntax.
+	// If a response timeout is given, the server waits up to that long for
+	// the response to be set via HttpRequest::response before answering.
+	HttpRequestBuffer RegisterRoute(
+		const std::string &method, const std::string &pathTemplate,
+		std::chrono::milliseconds responseTimeout =
+			std::chrono::milliseconds(0),
+		bool matchParameters = true);
+	// Changes the settings of the route the buffer was registered with,
+	// so the requests which were already received are kept.
+	// Returns false if the buffer is not registered as a route.
+	bool UpdateRoute(const HttpRequestBuffer &buffer,
+			 const std::string &method,
+			 const std::string &pathTemplate,
+			 std::chrono::milliseconds responseTimeout =
+				 std::chrono::milliseconds(0),
+			 bool matchParameters = true);
 	int GetPort() const { return _port; }
 	bool IsListening() const;
 
@@ -50,6 +77,10 @@ public:
 private:
 	int _port = 16384;
 	bool _startOnLoad = true;
+	int _workerThreads = 8;
+	// Requests waiting for a response each block a worker thread, so their
+	// number is limited to always leave workers for the remaining requests
+	int _maxHeldResponses = 4;
 
 	struct Impl;
 	std::unique_ptr<Impl> _impl;
@@ -68,6 +99,8 @@ public:
 private:
 	QSpinBox *_port;
 	QCheckBox *_startOnLoad;
+	QSpinBox *_workerThreads;
+	QSpinBox *_maxHeldResponses;
 	QGridLayout *_layout;
 };
 
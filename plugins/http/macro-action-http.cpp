@@ -1,5 +1,7 @@
 #include "macro-action-http.hpp"
+#include "http-client-pool.hpp"
 #include "layout-helpers.hpp"
+#include "thread-pool.hpp"
 
 #include <httplib.h>
 
@@ -44,17 +46,32 @@ static httplib::Params getParams(const StringList &strings)
 	return params;
 }
 
-static void setTimeout(httplib::Client &client, const Duration &timeout)
+static void setTimeout(httplib::Client &client,
+		       std::chrono::milliseconds timeout)
 {
-	const time_t seconds = timeout.Seconds();
-	const time_t usecs = timeout.Milliseconds() - (seconds * 1000);
-	client.set_read_timeout(seconds, usecs);
-	client.set_write_timeout(seconds, usecs);
+	const auto seconds =
+		std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	const time_t usecs =
+		std::chrono::duration_cast<std::chrono::microseconds>(
+			timeout - seconds)
+			.count();
+	client.set_read_timeout(seconds.count(), usecs);
+	client.set_write_timeout(seconds.count(), usecs);
+}
+
+void MacroActionHttp::SetAsync(bool async)
+{
+	_async = async;
+	SetupTempVars();
 }
 
 void MacroActionHttp::SetupTempVars()
 {
 	MacroAction::SetupTempVars();
+	// The response is not known yet once the action is done
+	if (_async) {
+		return;
+	}
 	AddTempvar("status",
 		   obs_module_text("AdvSceneSwitcher.tempVar.http.status"));
 	AddTempvar("body",
@@ -110,63 +127,128 @@ static URLInfo getURLInfo(const std::string &input, bool keepParams)
 	return {host, path};
 }
 
+namespace {
+
+struct OutgoingRequest {
+	std::string origin;
+	std::string path;
+	httplib::Params params;
+	httplib::Headers headers;
+	MacroActionHttp::Method method;
+	std::string body;
+	std::string contentType;
+	std::chrono::milliseconds timeout;
+};
+
+} // namespace
+
+static httplib::Result sendRequest(const OutgoingRequest &request)
+{
+	auto client = GetHttpClientPool().Acquire(request.origin);
+	setTimeout(*client, request.timeout);
+
+	httplib::Result response;
+	const auto &path = request.path;
+	const auto &params = request.params;
+	const auto &headers = request.headers;
+	switch (request.method) {
+	case MacroActionHttp::Method::GET:
+		response = client->Get(path, params, headers);
+		break;
+	case MacroActionHttp::Method::POST: {
+		const auto pathWithParam =
+			httplib::append_query_params(path, params);
+		response = client->Post(pathWithParam, headers, request.body,
+					request.contentType);
+		break;
+	}
+	case MacroActionHttp::Method::PUT: {
+		const auto pathWithParam =
+			httplib::append_query_params(path, params);
+		response = client->Put(pathWithParam, headers, request.body,
+				       request.contentType);
+		break;
+	}
+	case MacroActionHttp::Method::PATCH: {
+		const auto pathWithParam =
+			httplib::append_query_params(path, params);
+		response = client->Patch(pathWithParam, headers, request.body,
+					 request.contentType);
+		break;
+	}
+	case MacroActionHttp::Method::DELETE: {
+		const auto pathWithParam =
+			httplib::append_query_params(path, params);
+		response = client->Delete(pathWithParam, headers, request.body,
+					  request.contentType);
+		break;
+	}
+	default:
+		break;
+	}
+
+	// Do not reuse connections which might be in an unknown state
+	if (!response) {
+		client.Discard();
+	}
+	if (VerboseLoggingEnabled() && !response) {
+		blog(LOG_INFO, "HTTP action error: %s",
+		     httplib::to_string(response.error()).c_str());
+	}
+	return response;
+}
+
+static ThreadPool &getRequestThreadPool()
+{
+	// Queued requests use the client pool, so it has to be constructed
+	// first to be destroyed only after this thread pool
+	GetHttpClientPool();
+	static ThreadPool pool("http request", 4, 256);
+	return pool;
+}
+
 bool MacroActionHttp::PerformAction()
 {
 	// Capture all config while holding the segment lock
 	const auto [host, path] = getURLInfo(_url, !_setParams);
-	httplib::Client cli(host);
-	setTimeout(cli, _timeout);
-	const auto params = _setParams ? getParams(_params) : httplib::Params();
-	const auto headers = _setHeaders ? getHeaders(_headers)
-					 : httplib::Headers();
-	const auto method = _method;
-	const std::string body = _body;
-	const std::string contentType = _contentType;
+	OutgoingRequest request;
+	request.origin = host;
+	request.path = path;
+	request.params = _setParams ? getParams(_params) : httplib::Params();
+	request.headers = _setHeaders ? getHeaders(_headers)
+				      : httplib::Headers();
+	request.method = _method;
+	request.body = _body;
+	request.contentType = _contentType;
+	request.timeout = std::chrono::milliseconds(
+		(long long)_timeout.Milliseconds());
+	const auto responseVariable = _setResponseVariable
+					      ? _responseVariable
+					      : std::weak_ptr<Variable>();
+
+	if (_async) {
+		auto task = [request, responseVariable]() {
+			const auto response = sendRequest(request);
+			auto variable = responseVariable.lock();
+			if (variable) {
+				variable->SetValue(response ? response->body
+							    : "");
+			}
+		};
+		if (!getRequestThreadPool().Submit(task).valid()) {
+			blog(LOG_WARNING,
+			     "HTTP request queue is full - "
+			     "dropping request to \"%s\"",
+			     request.origin.c_str());
+		}
+		return true;
+	}
 
 	// Release the segment lock for the blocking network call
 	httplib::Result response;
 	{
 		SuspendLock suspendLock(*this);
-		switch (method) {
-		case MacroActionHttp::Method::GET:
-			response = cli.Get(path, params, headers);
-			break;
-		case MacroActionHttp::Method::POST: {
-			const auto pathWithParam =
-				httplib::append_query_params(path, params);
-			response = cli.Post(pathWithParam, headers, body,
-					    contentType);
-			break;
-		}
-		case MacroActionHttp::Method::PUT: {
-			const auto pathWithParam =
-				httplib::append_query_params(path, params);
-			response = cli.Put(pathWithParam, headers, body,
-					   contentType);
-			break;
-		}
-		case MacroActionHttp::Method::PATCH: {
-			const auto pathWithParam =
-				httplib::append_query_params(path, params);
-			response = cli.Patch(pathWithParam, headers, body,
-					     contentType);
-			break;
-		}
-		case MacroActionHttp::Method::DELETE: {
-			const auto pathWithParam =
-				httplib::append_query_params(path, params);
-			response = cli.Delete(pathWithParam, headers, body,
-					      contentType);
-			break;
-		}
-		default:
-			break;
-		}
-	}
-
-	if (VerboseLoggingEnabled() && !response) {
-		blog(LOG_INFO, "HTTP action error: %s",
-		     httplib::to_string(response.error()).c_str());
+		response = sendRequest(request);
 	}
 
 	SetTempVarValue("status",
@@ -174,6 +256,9 @@ bool MacroActionHttp::PerformAction()
 	SetTempVarValue("body", response ? response->body : "");
 	SetTempVarValue("error",
 			response ? "" : httplib::to_string(response.error()));
+	if (auto variable = responseVariable.lock()) {
+		variable->SetValue(response ? response->body : "");
+	}
 
 	return true;
 }
@@ -220,12 +305,12 @@ void MacroActionHttp::LogAction() const
 	      "with body \"%s\" "
 	      "with headers \"%s\" "
 	      "with parameters \"%s\" "
-	      "with timeout \"%s\"",
+	      "with timeout \"%s\"%s",
 	      methodToString(_method).data(), _url.c_str(),
 	      _contentType.c_str(), _body.c_str(),
 	      _setHeaders ? stringListToString(_headers).c_str() : "-",
 	      _setParams ? stringListToString(_params).c_str() : "-",
-	      _timeout.ToString().c_str());
+	      _timeout.ToString().c_str(), _async ? " (async)" : "");
 }
 
 bool MacroActionHttp::Save(obs_data_t *obj) const
@@ -240,6 +325,10 @@ bool MacroActionHttp::Save(obs_data_t *obj) const
 	_params.Save(obj, "params", "param");
 	obs_data_set_int(obj, "method", static_cast<int>(_method));
 	_timeout.Save(obj);
+	obs_data_set_bool(obj, "async", _async);
+	obs_data_set_bool(obj, "setResponseVariable", _setResponseVariable);
+	obs_data_set_string(obj, "responseVariable",
+			    GetWeakVariableName(_responseVariable).c_str());
 	return true;
 }
 
@@ -260,6 +349,10 @@ bool MacroActionHttp::Load(obs_data_t *obj)
 	_params.Load(obj, "params", "param");
 	_method = static_cast<Method>(obs_data_get_int(obj, "method"));
 	_timeout.Load(obj);
+	_setResponseVariable = obs_data_get_bool(obj, "setResponseVariable");
+	_responseVariable = GetWeakVariableByName(
+		obs_data_get_string(obj, "responseVariable"));
+	SetAsync(obs_data_get_bool(obj, "async"));
 	return true;
 }
 
@@ -336,8 +429,15 @@ MacroActionHttpEdit::MacroActionHttpEdit(
 		  obs_module_text(
 			  "AdvSceneSwitcher.action.http.addParam.value"))),
 	  _paramListLayout(new QVBoxLayout()),
-	  _timeout(new DurationSelection(this, false))
+	  _timeout(new DurationSelection(this, false)),
+	  _async(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.action.http.async"))),
+	  _setResponseVariable(new QCheckBox()),
+	  _responseVariable(new VariableSelection(this))
 {
+	_async->setToolTip(
+		obs_module_text("AdvSceneSwitcher.action.http.async.tooltip"));
+
 	populateMethodSelection(_methods);
 
 	SetWidgetSignalConnections();
@@ -364,6 +464,9 @@ void MacroActionHttpEdit::UpdateEntryData()
 	_methods->setCurrentIndex(
 		_methods->findData(static_cast<int>(_entryData->_method)));
 	_timeout->SetDuration(_entryData->_timeout);
+	_async->setChecked(_entryData->IsAsync());
+	_setResponseVariable->setChecked(_entryData->_setResponseVariable);
+	_responseVariable->SetVariable(_entryData->_responseVariable);
 	SetWidgetVisibility();
 }
 
@@ -433,6 +536,25 @@ void MacroActionHttpEdit::ParamsChanged(const StringList &params)
 	updateGeometry();
 }
 
+void MacroActionHttpEdit::AsyncChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetAsync(value);
+}
+
+void MacroActionHttpEdit::SetResponseVariableChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_setResponseVariable = value;
+	SetWidgetVisibility();
+}
+
+void MacroActionHttpEdit::ResponseVariableChanged(const QString &name)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_responseVariable = GetWeakVariableByQString(name);
+}
+
 void MacroActionHttpEdit::SetWidgetSignalConnections()
 {
 	QWidget::connect(_url, SIGNAL(editingFinished()), this,
@@ -455,6 +577,13 @@ void MacroActionHttpEdit::SetWidgetSignalConnections()
 			 SLOT(ParamsChanged(const StringList &)));
 	QWidget::connect(_timeout, SIGNAL(DurationChanged(const Duration &)),
 			 this, SLOT(TimeoutChanged(const Duration &)));
+	QWidget::connect(_async, SIGNAL(stateChanged(int)), this,
+			 SLOT(AsyncChanged(int)));
+	QWidget::connect(_setResponseVariable, SIGNAL(stateChanged(int)),
+			 this, SLOT(SetResponseVariableChanged(int)));
+	QWidget::connect(_responseVariable,
+			 SIGNAL(SelectionChanged(const QString &)), this,
+			 SLOT(ResponseVariableChanged(const QString &)));
 }
 
 void MacroActionHttpEdit::SetWidgetLayout()
@@ -462,7 +591,8 @@ void MacroActionHttpEdit::SetWidgetLayout()
 	const std::unordered_map<std::string, QWidget *> widgets = {
 		{"{{url}}", _url},         {"{{contentType}}", _contentType},
 		{"{{method}}", _methods},  {"{{body}}", _body},
-		{"{{timeout}}", _timeout},
+		{"{{timeout}}", _timeout}, {"{{variable}}", _responseVariable},
+		{"{{setVariable}}", _setResponseVariable},
 	};
 
 	auto actionLayout = new QHBoxLayout;
@@ -491,6 +621,11 @@ void MacroActionHttpEdit::SetWidgetLayout()
 		obs_module_text("AdvSceneSwitcher.action.http.params")));
 	_paramListLayout->addWidget(_paramList);
 
+	auto responseVariableLayout = new QHBoxLayout;
+	PlaceWidgets(obs_module_text(
+			     "AdvSceneSwitcher.action.http.layout.variable"),
+		     responseVariableLayout, widgets);
+
 	auto layout = new QVBoxLayout;
 	layout->addLayout(actionLayout);
 	layout->addWidget(_setParams);
@@ -500,6 +635,8 @@ void MacroActionHttpEdit::SetWidgetLayout()
 	layout->addLayout(_contentTypeLayout);
 	layout->addLayout(_bodyLayout);
 	layout->addLayout(timeoutLayout);
+	layout->addWidget(_async);
+	layout->addLayout(responseVariableLayout);
 	setLayout(layout);
 }
 
@@ -511,6 +648,7 @@ void MacroActionHttpEdit::SetWidgetVisibility()
 			 _entryData->_method != MacroActionHttp::Method::GET);
 	SetLayoutVisible(_bodyLayout,
 			 _entryData->_method != MacroActionHttp::Method::GET);
+	_responseVariable->setEnabled(_entryData->_setResponseVariable);
 
 	adjustSize();
 	updateGeometry();
@@ -4,6 +4,7 @@
 #include "variable-text-edit.hpp"
 #include "variable-line-edit.hpp"
 #include "duration-control.hpp"
+#include "variable.hpp"
 
 #include <QLineEdit>
 #include <QComboBox>
@@ -41,10 +42,19 @@ public:
 	StringList _params;
 	Method _method = Method::GET;
 	Duration _timeout = Duration(1.0);
+	bool _setResponseVariable = false;
+	std::weak_ptr<Variable> _responseVariable;
+
+	void SetAsync(bool async);
+	bool IsAsync() const { return _async; }
 
 private:
 	void SetupTempVars();
 
+	// Queue the request instead of waiting for the response, so the
+	// remaining actions of the macro are not delayed
+	bool _async = false;
+
 	static bool _registered;
 	static const std::string id;
 };
@@ -75,6 +85,9 @@ private slots:
 	void HeadersChanged(const StringList &);
 	void SetParamsChanged(int);
 	void ParamsChanged(const StringList &);
+	void AsyncChanged(int);
+	void SetResponseVariableChanged(int);
+	void ResponseVariableChanged(const QString &);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -96,6 +109,9 @@ private:
 	KeyValueListEdit *_paramList;
 	QVBoxLayout *_paramListLayout;
 	DurationSelection *_timeout;
+	QCheckBox *_async;
+	QCheckBox *_setResponseVariable;
+	VariableSelection *_responseVariable;
 
 	std::shared_ptr<MacroActionHttp> _entryData;
 	bool _loading = true;
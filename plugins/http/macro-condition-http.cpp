@@ -2,6 +2,8 @@
 #include "layout-helpers.hpp"
 #include "macro-helpers.hpp"
 
+#include <QString>
+
 #undef DELETE
 
 namespace advss {
@@ -50,12 +52,132 @@ static std::string_view methodToString(MacroConditionHttp::Method method)
 void MacroConditionHttp::SetServer(const std::string &name)
 {
 	_server = GetWeakHttpServerByName(name);
+	// Requests received by the previous server are discarded
+	_requestBuffer.reset();
+	UpdateRequestSubscription();
+}
+
+void MacroConditionHttp::UpdateRequestSubscription()
+{
+	SetupTempVars();
+
 	auto server = _server.lock();
 	if (!server) {
 		_requestBuffer.reset();
 		return;
 	}
-	_requestBuffer = server->RegisterForRequests();
+
+	const auto &path = _path.UnresolvedValue();
+	const bool wasRouted = _isRouted;
+	_isRouted = !_pathRegex.Enabled() &&
+		    path.find("${") == std::string::npos;
+	const auto method = std::string(methodToString(_method));
+	std::chrono::milliseconds responseTimeout(0);
+	if (_holdResponse) {
+		responseTimeout = std::chrono::milliseconds(
+			(long long)_responseTimeout.Milliseconds());
+	}
+
+	// Keep the existing registration if possible, so requests which were
+	// already received are not discarded while the settings are edited
+	if (_requestBuffer && _isRouted == wasRouted) {
+		if (!_isRouted) {
+			_requestFilter.Set(CreateRequestFilter());
+			return;
+		}
+		if (server->UpdateRoute(_requestBuffer, method, path,
+					responseTimeout, _pathParameters)) {
+			return;
+		}
+	}
+
+	const auto previousBuffer = _requestBuffer;
+	if (_isRouted) {
+		_requestBuffer = server->RegisterRoute(
+			method, path, responseTimeout, _pathParameters);
+	} else {
+		_requestFilter.Set(CreateRequestFilter());
+		_requestBuffer =
+			server->RegisterForRequests(_requestFilter.Get());
+	}
+	if (!previousBuffer) {
+		return;
+	}
+	for (const auto &request : previousBuffer->ConsumeAll()) {
+		_requestBuffer->AppendMessage(request);
+	}
+}
+
+HttpRequestFilter MacroConditionHttp::CreateRequestFilter() const
+{
+	// The filter runs on the server thread, so it only works with copies of
+	// the settings and skips the path check if the path contains variables
+	const auto method = _method;
+	const auto path = _path.UnresolvedValue();
+	const bool checkPath = path.find("${") == std::string::npos;
+	const auto regex = _pathRegex;
+	const bool pathParameters = _pathParameters;
+	return [method, path, checkPath, regex,
+		pathParameters](const HttpRequest &request) {
+		if (method != Method::ANY &&
+		    request.method != methodToString(method)) {
+			return false;
+		}
+		if (!checkPath) {
+			return true;
+		}
+		if (regex.Enabled()) {
+			return regex.Matches(request.path, path);
+		}
+		return pathParameters
+			       ? HttpRouteTable::MatchPath(path, request.path)
+			       : request.path == path;
+	};
+}
+
+bool MacroConditionHttp::MethodAndPathMatch(
+	const HttpRequest &request,
+	HttpRouteTable::Parameters &parameters) const
+{
+	if (_method != Method::ANY &&
+	    request.method != methodToString(_method)) {
+		return false;
+	}
+	if (_pathRegex.Enabled()) {
+		return _pathRegex.Matches(request.path, _path);
+	}
+	if (!_pathParameters) {
+		return request.path == std::string(_path);
+	}
+	return HttpRouteTable::MatchPath(_path, request.path, &parameters);
+}
+
+void MacroConditionHttp::RespondAfterActions(const HttpRequest &request)
+{
+	if (!request.response) {
+		return;
+	}
+
+	// The response body is resolved only once the actions are done, so it
+	// can contain the values of variables modified by those actions
+	auto response = request.response;
+	auto body = _responseBody;
+	AddMacroActionsDoneCallback(
+		GetMacro(), [response, body](bool actionsRun) {
+			// Let the client know that the request was received,
+			// but no actions were run, e.g. due to the action
+			// trigger mode of the macro
+			if (!actionsRun) {
+				response->Set(409, "");
+				return;
+			}
+			response->Set(200, body);
+		});
+}
+
+bool MacroConditionHttp::HasPendingMessages() const
+{
+	return _requestBuffer && !_requestBuffer->Empty();
 }
 
 bool MacroConditionHttp::CheckCondition()
@@ -68,47 +190,38 @@ bool MacroConditionHttp::CheckCondition()
 		MacroWasPausedSince(GetMacro(), _lastCheck);
 	_lastCheck = std::chrono::high_resolution_clock::now();
 	if (macroWasPausedSinceLastCheck) {
+		// Held requests which are cleared are answered with the
+		// fallback status once they are discarded
 		_requestBuffer->Clear();
 		return false;
 	}
 
-	while (!_requestBuffer->Empty()) {
-		auto request = _requestBuffer->ConsumeMessage();
-		if (!request) {
-			continue;
-		}
-
+	while (auto request = _requestBuffer->ConsumeMessage()) {
 		SetTempVarValue("method", request->method);
 		SetTempVarValue("path", request->path);
 		SetTempVarValue("body", request->body);
 
-		if (_method != Method::ANY &&
-		    request->method != methodToString(_method)) {
+		auto parameters = request->parameters;
+		if (!_isRouted && !MethodAndPathMatch(*request, parameters)) {
 			continue;
 		}
 
-		const std::string pathPattern = std::string(_path);
-		if (_pathRegex.Enabled()) {
-			if (!_pathRegex.Matches(request->path, _path)) {
-				continue;
-			}
-		} else {
-			if (request->path != pathPattern) {
-				continue;
-			}
-		}
-
 		const std::string bodyPattern = std::string(_body);
-		if (_bodyRegex.Enabled()) {
-			if (!_bodyRegex.Matches(request->body, _body)) {
-				continue;
-			}
-		} else {
-			if (request->body != bodyPattern) {
-				continue;
+		const bool bodyMatches =
+			_bodyRegex.Enabled()
+				? _bodyRegex.Matches(request->body, _body)
+				: request->body == bodyPattern;
+		if (!bodyMatches) {
+			if (request->response) {
+				request->response->SetFallbackStatus(404);
 			}
+			continue;
 		}
 
+		for (const auto &[name, value] : parameters) {
+			SetTempVarValue(name, value);
+		}
+		RespondAfterActions(*request);
 		if (_clearBufferOnMatch) {
 			_requestBuffer->Clear();
 		}
@@ -124,9 +237,13 @@ bool MacroConditionHttp::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "method", static_cast<int>(_method));
 	_path.Save(obj, "path");
 	_pathRegex.Save(obj, "pathRegex");
+	obs_data_set_bool(obj, "pathParameters", _pathParameters);
 	_body.Save(obj, "body");
 	_bodyRegex.Save(obj, "bodyRegex");
 	obs_data_set_bool(obj, "clearBufferOnMatch", _clearBufferOnMatch);
+	obs_data_set_bool(obj, "holdResponse", _holdResponse);
+	_responseTimeout.Save(obj, "responseTimeout");
+	_responseBody.Save(obj, "responseBody");
 	auto server = _server.lock();
 	obs_data_set_string(obj, "server",
 			    server ? server->Name().c_str() : "");
@@ -139,12 +256,20 @@ bool MacroConditionHttp::Load(obs_data_t *obj)
 	_method = static_cast<Method>(obs_data_get_int(obj, "method"));
 	_path.Load(obj, "path");
 	_pathRegex.Load(obj, "pathRegex");
+	// Conditions created before path parameters were supported matched
+	// paths containing braces literally
+	_pathParameters = obs_data_get_bool(obj, "pathParameters");
 	_body.Load(obj, "body");
 	_bodyRegex.Load(obj, "bodyRegex");
 	_clearBufferOnMatch = obs_data_get_bool(obj, "clearBufferOnMatch");
 	if (!obs_data_has_user_value(obj, "clearBufferOnMatch")) {
 		_clearBufferOnMatch = true;
 	}
+	_holdResponse = obs_data_get_bool(obj, "holdResponse");
+	if (obs_data_has_user_value(obj, "responseTimeout")) {
+		_responseTimeout.Load(obj, "responseTimeout");
+	}
+	_responseBody.Load(obj, "responseBody");
 	SetServer(obs_data_get_string(obj, "server"));
 	return true;
 }
@@ -170,6 +295,25 @@ void MacroConditionHttp::SetupTempVars()
 		   obs_module_text("AdvSceneSwitcher.tempVar.http.body"),
 		   obs_module_text(
 			   "AdvSceneSwitcher.tempVar.http.body.description"));
+
+	if (_pathRegex.Enabled() || !_pathParameters) {
+		return;
+	}
+	const QString nameFormat =
+		obs_module_text("AdvSceneSwitcher.tempVar.http.parameter");
+	for (const auto &parameter :
+	     HttpRouteTable::GetParameterNames(_path.UnresolvedValue())) {
+		if (parameter == "method" || parameter == "path" ||
+		    parameter == "body") {
+			continue;
+		}
+		AddTempvar(
+			parameter,
+			nameFormat.arg(QString::fromStdString(parameter))
+				.toStdString(),
+			obs_module_text(
+				"AdvSceneSwitcher.tempVar.http.parameter.description"));
+	}
 }
 
 static void populateMethodSelection(QComboBox *list)
@@ -187,11 +331,23 @@ MacroConditionHttpEdit::MacroConditionHttpEdit(
 	  _server(new HttpServerSelection(this)),
 	  _path(new VariableLineEdit(this)),
 	  _pathRegex(new RegexConfigWidget(this)),
+	  _pathParameters(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.http.pathParameters"))),
 	  _body(new VariableTextEdit(this)),
 	  _bodyRegex(new RegexConfigWidget(this)),
 	  _clearBufferOnMatch(new QCheckBox(
-		  obs_module_text("AdvSceneSwitcher.clearBufferOnMatch")))
+		  obs_module_text("AdvSceneSwitcher.clearBufferOnMatch"))),
+	  _holdResponse(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.http.holdResponse"))),
+	  _responseSettings(new QWidget(this)),
+	  _responseTimeout(new DurationSelection(this, false)),
+	  _responseBody(new VariableTextEdit(this))
 {
+	_pathParameters->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.http.pathParameters.tooltip"));
+	_holdResponse->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.http.holdResponse.tooltip"));
+
 	populateMethodSelection(_method);
 
 	QWidget::connect(_method, SIGNAL(currentIndexChanged(int)), this,
@@ -203,6 +359,8 @@ MacroConditionHttpEdit::MacroConditionHttpEdit(
 	QWidget::connect(_pathRegex,
 			 SIGNAL(RegexConfigChanged(const RegexConfig &)), this,
 			 SLOT(PathRegexChanged(const RegexConfig &)));
+	QWidget::connect(_pathParameters, SIGNAL(stateChanged(int)), this,
+			 SLOT(PathParametersChanged(int)));
 	QWidget::connect(_body, SIGNAL(textChanged()), this,
 			 SLOT(BodyChanged()));
 	QWidget::connect(_bodyRegex,
@@ -210,6 +368,13 @@ MacroConditionHttpEdit::MacroConditionHttpEdit(
 			 SLOT(BodyRegexChanged(const RegexConfig &)));
 	QWidget::connect(_clearBufferOnMatch, SIGNAL(stateChanged(int)), this,
 			 SLOT(ClearBufferOnMatchChanged(int)));
+	QWidget::connect(_holdResponse, SIGNAL(stateChanged(int)), this,
+			 SLOT(HoldResponseChanged(int)));
+	QWidget::connect(_responseTimeout,
+			 SIGNAL(DurationChanged(const Duration &)), this,
+			 SLOT(ResponseTimeoutChanged(const Duration &)));
+	QWidget::connect(_responseBody, SIGNAL(textChanged()), this,
+			 SLOT(ResponseBodyChanged()));
 
 	auto topLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.http.layout"),
@@ -228,11 +393,30 @@ MacroConditionHttpEdit::MacroConditionHttpEdit(
 		bodyLayout, {{"{{body}}", _body}, {"{{regex}}", _bodyRegex}},
 		false);
 
+	auto responseBodyLayout = new QHBoxLayout;
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.http.layout.responseBody"),
+		responseBodyLayout, {{"{{body}}", _responseBody}}, false);
+	auto responseTimeoutLayout = new QHBoxLayout;
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.http.layout.responseTimeout"),
+		responseTimeoutLayout, {{"{{timeout}}", _responseTimeout}});
+	auto responseLayout = new QVBoxLayout;
+	responseLayout->setContentsMargins(0, 0, 0, 0);
+	responseLayout->addLayout(responseBodyLayout);
+	responseLayout->addLayout(responseTimeoutLayout);
+	_responseSettings->setLayout(responseLayout);
+
 	auto mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(topLayout);
 	mainLayout->addLayout(pathLayout);
+	mainLayout->addWidget(_pathParameters);
 	mainLayout->addLayout(bodyLayout);
 	mainLayout->addWidget(_clearBufferOnMatch);
+	mainLayout->addWidget(_holdResponse);
+	mainLayout->addWidget(_responseSettings);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -251,10 +435,23 @@ void MacroConditionHttpEdit::UpdateEntryData()
 	_server->SetServer(_entryData->GetServer());
 	_path->setText(_entryData->_path);
 	_pathRegex->SetRegexConfig(_entryData->_pathRegex);
+	_pathParameters->setChecked(_entryData->_pathParameters);
 	_body->setPlainText(_entryData->_body);
 	_bodyRegex->SetRegexConfig(_entryData->_bodyRegex);
 	_clearBufferOnMatch->setChecked(_entryData->_clearBufferOnMatch);
+	_holdResponse->setChecked(_entryData->_holdResponse);
+	_responseTimeout->SetDuration(_entryData->_responseTimeout);
+	_responseBody->setPlainText(_entryData->_responseBody);
+	SetWidgetVisibility();
+}
 
+void MacroConditionHttpEdit::SetWidgetVisibility()
+{
+	_pathParameters->setVisible(!_entryData->_pathRegex.Enabled());
+	// Responses can only be held for requests delivered via a route
+	_holdResponse->setEnabled(!_entryData->_pathRegex.Enabled());
+	_responseSettings->setVisible(_entryData->_holdResponse &&
+				      !_entryData->_pathRegex.Enabled());
 	adjustSize();
 	updateGeometry();
 }
@@ -264,6 +461,7 @@ void MacroConditionHttpEdit::MethodChanged(int idx)
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_method = static_cast<MacroConditionHttp::Method>(
 		_method->itemData(idx).toInt());
+	_entryData->UpdateRequestSubscription();
 }
 
 void MacroConditionHttpEdit::ServerChanged(const QString &name)
@@ -278,14 +476,22 @@ void MacroConditionHttpEdit::PathChanged()
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_path = _path->text().toStdString();
+	_entryData->UpdateRequestSubscription();
 }
 
 void MacroConditionHttpEdit::PathRegexChanged(const RegexConfig &conf)
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_pathRegex = conf;
-	adjustSize();
-	updateGeometry();
+	_entryData->UpdateRequestSubscription();
+	SetWidgetVisibility();
+}
+
+void MacroConditionHttpEdit::PathParametersChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_pathParameters = value;
+	_entryData->UpdateRequestSubscription();
 }
 
 void MacroConditionHttpEdit::BodyChanged()
@@ -310,4 +516,28 @@ void MacroConditionHttpEdit::ClearBufferOnMatchChanged(int value)
 	_entryData->_clearBufferOnMatch = value;
 }
 
+void MacroConditionHttpEdit::HoldResponseChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_holdResponse = value;
+	_entryData->UpdateRequestSubscription();
+	SetWidgetVisibility();
+}
+
+void MacroConditionHttpEdit::ResponseTimeoutChanged(const Duration &timeout)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_responseTimeout = timeout;
+	_entryData->UpdateRequestSubscription();
+}
+
+void MacroConditionHttpEdit::ResponseBodyChanged()
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_responseBody =
+		_responseBody->toPlainText().toUtf8().constData();
+	adjustSize();
+	updateGeometry();
+}
+
 } // namespace advss
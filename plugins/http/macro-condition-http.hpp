@@ -1,5 +1,6 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "duration-control.hpp"
 #include "http-server.hpp"
 #include "variable-line-edit.hpp"
 #include "variable-text-edit.hpp"
@@ -14,6 +15,7 @@ class MacroConditionHttp : public MacroCondition {
 public:
 	MacroConditionHttp(Macro *m) : MacroCondition(m, true) {}
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc() const;
@@ -34,19 +36,35 @@ public:
 
 	void SetServer(const std::string &name);
 	std::weak_ptr<HttpServer> GetServer() const { return _server; }
+	// Has to be called whenever the method or path settings change.
+	// Requests which were already received are kept.
+	void UpdateRequestSubscription();
 
 	StringVariable _path = ".*";
 	StringVariable _body = ".*";
 	RegexConfig _pathRegex = RegexConfig::PartialMatchRegexConfig(true);
+	// Match path segments like "{id}" as parameters instead of literally
+	bool _pathParameters = true;
 	RegexConfig _bodyRegex = RegexConfig::PartialMatchRegexConfig(true);
 	Method _method = Method::ANY;
 	bool _clearBufferOnMatch = true;
+	// Only supported for requests delivered via a route
+	bool _holdResponse = false;
+	Duration _responseTimeout = Duration(10.0);
+	StringVariable _responseBody = "";
 
 private:
 	void SetupTempVars();
+	HttpRequestFilter CreateRequestFilter() const;
+	bool MethodAndPathMatch(const HttpRequest &,
+				HttpRouteTable::Parameters &) const;
+	void RespondAfterActions(const HttpRequest &);
 
 	std::weak_ptr<HttpServer> _server;
 	HttpRequestBuffer _requestBuffer;
+	ReplaceableMessageFilter<HttpRequest> _requestFilter;
+	// Requests delivered via a route already match the method and path
+	bool _isRouted = false;
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
 
 	static bool _registered;
@@ -73,9 +91,13 @@ private slots:
 	void ServerChanged(const QString &);
 	void PathChanged();
 	void PathRegexChanged(const RegexConfig &);
+	void PathParametersChanged(int);
 	void BodyChanged();
 	void BodyRegexChanged(const RegexConfig &);
 	void ClearBufferOnMatchChanged(int);
+	void HoldResponseChanged(int);
+	void ResponseTimeoutChanged(const Duration &);
+	void ResponseBodyChanged();
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -84,9 +106,16 @@ private:
 	HttpServerSelection *_server;
 	VariableLineEdit *_path;
 	RegexConfigWidget *_pathRegex;
+	QCheckBox *_pathParameters;
 	VariableTextEdit *_body;
 	RegexConfigWidget *_bodyRegex;
 	QCheckBox *_clearBufferOnMatch;
+	QCheckBox *_holdResponse;
+	QWidget *_responseSettings;
+	DurationSelection *_responseTimeout;
+	VariableTextEdit *_responseBody;
+
+	void SetWidgetVisibility();
 
 	std::shared_ptr<MacroConditionHttp> _entryData;
 	bool _loading = true;
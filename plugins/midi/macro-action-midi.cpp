@@ -200,20 +200,14 @@ void MacroActionMidiEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<MidiMessage> message;
-	while (!_messageBuffer->Empty()) {
-		message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-	}
-
-	if (!message) {
+	const auto messages = _messageBuffer->ConsumeAll();
+	if (messages.empty()) {
 		return;
 	}
+	const auto &message = *messages.back();
 
-	_message->SetMessage(*message);
-	_entryData->_message = *message;
+	_message->SetMessage(message);
+	_entryData->_message = message;
 }
 
 } // namespace advss
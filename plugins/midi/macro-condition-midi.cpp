@@ -12,6 +12,11 @@ bool MacroConditionMidi::_registered = MacroConditionFactory::Register(
 	{MacroConditionMidi::Create, MacroConditionMidiEdit::Create,
 	 "AdvSceneSwitcher.condition.midi"});
 
+bool MacroConditionMidi::HasPendingMessages() const
+{
+	return _messageBuffer && !_messageBuffer->Empty();
+}
+
 bool MacroConditionMidi::CheckCondition()
 {
 	if (!_messageBuffer) {
@@ -26,11 +31,7 @@ bool MacroConditionMidi::CheckCondition()
 		return false;
 	}
 
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
+	while (auto message = _messageBuffer->ConsumeMessage()) {
 		if (message->Matches(_message)) {
 			SetVariableValues(*message);
 			if (_clearBufferOnMatch) {
@@ -58,7 +59,7 @@ bool MacroConditionMidi::Load(obs_data_t *obj)
 	MacroCondition::Load(obj);
 	_message.Load(obj);
 	_device.Load(obj);
-	_messageBuffer = _device.RegisterForMidiMessages();
+	RegisterForMessages();
 	_clearBufferOnMatch = obs_data_get_bool(obj, "clearBufferOnMatch");
 	if (!obs_data_has_user_value(obj, "version")) {
 		_clearBufferOnMatch = true;
@@ -74,7 +75,18 @@ std::string MacroConditionMidi::GetShortDesc() const
 void MacroConditionMidi::SetDevice(const MidiDevice &dev)
 {
 	_device = dev;
-	_messageBuffer = dev.RegisterForMidiMessages();
+	RegisterForMessages();
+}
+
+void MacroConditionMidi::RegisterForMessages()
+{
+	UpdateMessageFilter();
+	_messageBuffer = _device.RegisterForMidiMessages(_messageFilter.Get());
+}
+
+void MacroConditionMidi::UpdateMessageFilter()
+{
+	_messageFilter.Set(_message.CreateFilter());
 }
 
 void MacroConditionMidi::SetupTempVars()
@@ -199,6 +211,7 @@ void MacroConditionMidiEdit::MidiMessageChanged(const MidiMessage &message)
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_message = message;
+	_entryData->UpdateMessageFilter();
 }
 
 void MacroConditionMidiEdit::ClearBufferOnMatchChanged(int value)
@@ -250,20 +263,14 @@ void MacroConditionMidiEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<MidiMessage> message;
-	while (!_messageBuffer->Empty()) {
-		message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-	}
-
-	if (!message) {
+	const auto messages = _messageBuffer->ConsumeAll();
+	if (messages.empty()) {
 		return;
 	}
+	const auto &message = *messages.back();
 
-	_message->SetMessage(*message);
-	_entryData->_message = *message;
+	_message->SetMessage(message);
+	_entryData->_message = message;
 }
 
 } // namespace advss
@@ -12,6 +12,7 @@ class MacroConditionMidi : public MacroCondition {
 public:
 	MacroConditionMidi(Macro *m) : MacroCondition(m, true) {}
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc() const;
@@ -23,15 +24,20 @@ public:
 
 	void SetDevice(const MidiDevice &dev);
 	const MidiDevice &GetDevice() const { return _device; }
+	// Has to be called whenever the message settings change.
+	// Messages which were already received are kept.
+	void UpdateMessageFilter();
 	MidiMessage _message;
 	bool _clearBufferOnMatch = true;
 
 private:
 	void SetupTempVars();
 	void SetVariableValues(const MidiMessage &);
+	void RegisterForMessages();
 
 	MidiDevice _device;
 	MidiMessageBuffer _messageBuffer;
+	ReplaceableMessageFilter<MidiMessage> _messageFilter;
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
 	static bool _registered;
 	static const std::string id;
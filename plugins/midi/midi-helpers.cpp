@@ -282,6 +282,24 @@ bool MidiMessage::Matches(const MidiMessage &m) const
 	return channelMatch && noteMatch && valueMatch && typeMatch;
 }
 
+MidiMessageFilter MidiMessage::CreateFilter() const
+{
+	if (_channel.IsFixedType() && _note.IsFixedType() &&
+	    _value.IsFixedType()) {
+		return [pattern = *this](const MidiMessage &message) {
+			return message.Matches(pattern);
+		};
+	}
+
+	// Variables can only be resolved when checking the condition
+	if (_typeIsOptional) {
+		return {};
+	}
+	return [type = _type](const MidiMessage &message) {
+		return message._typeIsOptional || message._type == type;
+	};
+}
+
 MidiDeviceInstance *
 MidiDeviceInstance::GetDeviceAndOpen(MidiDeviceType type,
 				     const std::string &name)
@@ -645,9 +663,10 @@ bool MidiDeviceInstance::SendMessge(const MidiMessage &m)
 	return false;
 }
 
-MidiMessageBuffer MidiDeviceInstance::RegisterForMidiMessages()
+MidiMessageBuffer
+MidiDeviceInstance::RegisterForMidiMessages(const MidiMessageFilter &filter)
 {
-	return _dispatcher.RegisterClient();
+	return _dispatcher.RegisterClient(filter);
 }
 
 void MidiDeviceInstance::ReceiveMidiMessage(libremidi::message &&msg)
@@ -657,13 +676,14 @@ void MidiDeviceInstance::ReceiveMidiMessage(libremidi::message &&msg)
 	      MidiMessage::ToString(msg).c_str());
 }
 
-[[nodiscard]] MidiMessageBuffer MidiDevice::RegisterForMidiMessages() const
+[[nodiscard]] MidiMessageBuffer
+MidiDevice::RegisterForMidiMessages(const MidiMessageFilter &filter) const
 {
 	if (_type == MidiDeviceType::OUTPUT || _name.empty() || !_dev) {
 		return {};
 	}
 
-	return _dev->RegisterForMidiMessages();
+	return _dev->RegisterForMidiMessages(filter);
 }
 
 std::string MidiDevice::Name() const
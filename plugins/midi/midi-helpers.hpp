@@ -14,6 +14,7 @@ namespace advss {
 class MidiMessage;
 using MidiMessageBuffer = std::shared_ptr<MessageBuffer<MidiMessage>>;
 using MidiMessageDispatcher = MessageDispatcher<MidiMessage>;
+using MidiMessageFilter = MidiMessageDispatcher::Filter;
 
 // Based on https://github.com/nhielost/obs-midi-mg MMGMessage
 class MidiMessage {
@@ -25,6 +26,9 @@ public:
 	void Load(obs_data_t *obj);
 
 	bool Matches(const MidiMessage &) const;
+	// Returns a filter for messages matching this one, which does not
+	// depend on any variables and thus can be evaluated on any thread
+	MidiMessageFilter CreateFilter() const;
 
 	static std::string ToString(const libremidi::message &msg);
 	static std::string MidiTypeToString(libremidi::message_type type);
@@ -81,7 +85,8 @@ private:
 	~MidiDeviceInstance() = default;
 	bool IsOpened() const;
 	bool SendMessge(const MidiMessage &);
-	[[nodiscard]] MidiMessageBuffer RegisterForMidiMessages();
+	[[nodiscard]] MidiMessageBuffer
+	RegisterForMidiMessages(const MidiMessageFilter &filter);
 	void ReceiveMidiMessage(libremidi::message &&);
 
 	static std::map<std::pair<MidiDeviceType, std::string>,
@@ -110,7 +115,8 @@ public:
 	void Load(obs_data_t *obj);
 
 	bool SendMessge(const MidiMessage &) const;
-	[[nodiscard]] MidiMessageBuffer RegisterForMidiMessages() const;
+	[[nodiscard]] MidiMessageBuffer
+	RegisterForMidiMessages(const MidiMessageFilter &filter = {}) const;
 
 	std::string Name() const;
 
@@ -12,6 +12,11 @@ bool MacroConditionMqtt::_registered = MacroConditionFactory::Register(
 	{MacroConditionMqtt::Create, MacroConditionMqttEdit::Create,
 	 "AdvSceneSwitcher.condition.mqtt"});
 
+bool MacroConditionMqtt::HasPendingMessages() const
+{
+	return _messageBuffer && !_messageBuffer->Empty();
+}
+
 bool MacroConditionMqtt::CheckCondition()
 {
 	if (!_messageBuffer) {
@@ -30,15 +35,10 @@ bool MacroConditionMqtt::CheckCondition()
 		if (_regex.Enabled()) {
 			return _regex.Matches(message, _message);
 		}
-		return message != std::string(_message);
+		return message == std::string(_message);
 	};
 
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-
+	while (auto message = _messageBuffer->ConsumeMessage()) {
 		if (!messageMatches(*message)) {
 			continue;
 		}
@@ -82,11 +82,33 @@ std::string MacroConditionMqtt::GetShortDesc() const
 void MacroConditionMqtt::SetConnection(const std::string &name)
 {
 	_connection = GetWeakMqttConnectionByName(name);
+	UpdateMessageFilter();
 	auto connection = _connection.lock();
 	if (!connection) {
 		return;
 	}
-	_messageBuffer = connection->RegisterForEvents();
+	_messageBuffer = connection->RegisterForEvents(_messageFilter.Get());
+}
+
+void MacroConditionMqtt::UpdateMessageFilter()
+{
+	_messageFilter.Set(CreateMessageFilter());
+}
+
+MqttMessageFilter MacroConditionMqtt::CreateMessageFilter() const
+{
+	// The filter runs on the MQTT client thread, so it only works with
+	// copies of the settings
+	const auto pattern = _message.UnresolvedValue();
+	if (pattern.find("${") != std::string::npos) {
+		// Variables can only be resolved when checking the condition
+		return {};
+	}
+	const auto regex = _regex;
+	return [pattern, regex](const std::string &message) {
+		return regex.Enabled() ? regex.Matches(message, pattern)
+				       : message == pattern;
+	};
 }
 
 std::weak_ptr<MqttConnection> MacroConditionMqtt::GetConnection() const
@@ -183,6 +205,7 @@ void MacroConditionMqttEdit::MqttMessageChanged()
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_message = _message->toPlainText().toStdString();
+	_entryData->UpdateMessageFilter();
 }
 
 void MacroConditionMqttEdit::ClearBufferOnMatchChanged(int value)
@@ -195,6 +218,7 @@ void MacroConditionMqttEdit::RegexChanged(const RegexConfig &conf)
 {
 	GUARD_LOADING_AND_LOCK();
 	_entryData->_regex = conf;
+	_entryData->UpdateMessageFilter();
 
 	adjustSize();
 	updateGeometry();
@@ -248,21 +272,15 @@ void MacroConditionMqttEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<std::string> message;
-	while (!_messageBuffer->Empty()) {
-		message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-	}
-
-	if (!message) {
+	const auto messages = _messageBuffer->ConsumeAll();
+	if (messages.empty()) {
 		return;
 	}
+	const auto &message = *messages.back();
 
 	const QSignalBlocker blocker(_message);
-	_message->setPlainText(*message);
-	_entryData->_message = *message;
+	_message->setPlainText(message);
+	_entryData->_message = message;
 }
 
 } // namespace advss
@@ -14,6 +14,7 @@ class MacroConditionMqtt : public MacroCondition {
 public:
 	MacroConditionMqtt(Macro *m) : MacroCondition(m, true) {}
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetShortDesc() const;
@@ -25,6 +26,9 @@ public:
 
 	void SetConnection(const std::string &);
 	std::weak_ptr<MqttConnection> GetConnection() const;
+	// Has to be called whenever the message or regex settings change.
+	// Messages which were already received are kept.
+	void UpdateMessageFilter();
 
 	StringVariable _message;
 	RegexConfig _regex;
@@ -32,9 +36,11 @@ public:
 
 private:
 	void SetupTempVars();
+	MqttMessageFilter CreateMessageFilter() const;
 
 	std::weak_ptr<MqttConnection> _connection;
 	MqttMessageBuffer _messageBuffer;
+	ReplaceableMessageFilter<std::string> _messageFilter;
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
 	static bool _registered;
 	static const std::string id;
@@ -308,9 +308,10 @@ void MqttConnection::Save(obs_data_t *data) const
 	obs_data_set_array(data, "qos", array);
 }
 
-MqttMessageBuffer MqttConnection::RegisterForEvents()
+MqttMessageBuffer
+MqttConnection::RegisterForEvents(const MqttMessageFilter &filter)
 {
-	return _dispatcher.RegisterClient();
+	return _dispatcher.RegisterClient(filter);
 }
 
 QString MqttConnection::GetStatus() const
@@ -613,6 +614,15 @@ void MqttConnectionSelection::SetConnection(
 MqttConnectionSignalManager::MqttConnectionSignalManager(QObject *parent)
 	: QObject(parent)
 {
+	// Keep the name index used for lookups up to date
+	const auto invalidateIndex = []() {
+		InvalidateItemNameIndex(GetMqttConnections());
+	};
+	connect(this, &MqttConnectionSignalManager::Add, this, invalidateIndex);
+	connect(this, &MqttConnectionSignalManager::Rename, this,
+		invalidateIndex);
+	connect(this, &MqttConnectionSignalManager::Remove, this,
+		invalidateIndex);
 	QWidget::connect(this, SIGNAL(Add(const QString &)), this,
 			 SLOT(OpenNewConnection(const QString &)));
 }
@@ -649,26 +659,15 @@ MqttConnection *GetMqttConnectionByName(const QString &name)
 
 MqttConnection *GetMqttConnectionByName(const std::string &name)
 {
-	for (const auto &connection : GetMqttConnections()) {
-		if (connection->Name() == name) {
-			return dynamic_cast<MqttConnection *>(connection.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<MqttConnection *>(
+		GetItemByName(GetMqttConnections(), name).get());
 }
 
 std::weak_ptr<MqttConnection>
 GetWeakMqttConnectionByName(const std::string &name)
 {
-	for (const auto &connection : GetMqttConnections()) {
-		if (connection->Name() == name) {
-			std::weak_ptr<MqttConnection> weak =
-				std::dynamic_pointer_cast<MqttConnection>(
-					connection);
-			return weak;
-		}
-	}
-	return std::weak_ptr<MqttConnection>();
+	return std::dynamic_pointer_cast<MqttConnection>(
+		GetItemByName(GetMqttConnections(), name));
 }
 
 std::weak_ptr<MqttConnection>
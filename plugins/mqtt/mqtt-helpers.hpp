@@ -20,6 +20,7 @@ namespace advss {
 
 using MqttMessageBuffer = std::shared_ptr<MessageBuffer<std::string>>;
 using MqttMessageDispatcher = MessageDispatcher<std::string>;
+using MqttMessageFilter = MqttMessageDispatcher::Filter;
 
 class MqttConnection : public Item {
 public:
@@ -42,7 +43,8 @@ public:
 			 int qos, bool retained);
 	void Load(obs_data_t *data);
 	void Save(obs_data_t *data) const;
-	MqttMessageBuffer RegisterForEvents();
+	MqttMessageBuffer
+	RegisterForEvents(const MqttMessageFilter &filter = {});
 	bool ConnectOnStartup() const { return _connectOnStart; }
 	QString GetURI() const { return QString::fromStdString(_uri); }
 	int GetTopicSubscriptionCount() const { return _topics.size(); }
@@ -155,16 +155,17 @@ void MacroConditionSpeech::RebuildRecognizer()
 	});
 }
 
+bool MacroConditionSpeech::HasPendingMessages() const
+{
+	return _messageBuffer && !_messageBuffer->Empty();
+}
+
 bool MacroConditionSpeech::CheckCondition()
 {
 	std::string lastTranscript;
 	bool anyReceived = false;
 
-	while (!_messageBuffer->Empty()) {
-		auto msg = _messageBuffer->ConsumeMessage();
-		if (!msg) {
-			continue;
-		}
+	while (auto msg = _messageBuffer->ConsumeMessage()) {
 		lastTranscript = *msg;
 		anyReceived = true;
 	}
@@ -26,6 +26,7 @@ public:
 	~MacroConditionSpeech();
 
 	bool CheckCondition() override;
+	bool HasPendingMessages() const override;
 	bool Save(obs_data_t *obj) const override;
 	bool Load(obs_data_t *obj) override;
 	std::string GetShortDesc() const override;
@@ -105,14 +105,14 @@ bool MacroConditionStreamdeck::MessageMatches(const StreamDeckMessage &message)
 	return keyStateMatches && positionMatches && dataMatches;
 }
 
-bool MacroConditionStreamdeck::CheckCondition()
+bool MacroConditionStreamdeck::HasPendingMessages() const
 {
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
+	return _messageBuffer && !_messageBuffer->Empty();
+}
 
+bool MacroConditionStreamdeck::CheckCondition()
+{
+	while (auto message = _messageBuffer->ConsumeMessage()) {
 		if (!message->keyDown) {
 			_lastMatchingKeyIsStillPressed = false;
 		}
@@ -384,11 +384,7 @@ void MacroConditionStreamdeckEdit::ListenClicked()
 		}
 
 		StreamDeckMessage lastMessageInBuffer;
-		while (!_messageBuffer->Empty()) {
-			auto message = _messageBuffer->ConsumeMessage();
-			if (!message) {
-				continue;
-			}
+		while (auto message = _messageBuffer->ConsumeMessage()) {
 			lastMessageInBuffer = *message;
 		}
 
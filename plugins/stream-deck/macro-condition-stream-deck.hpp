@@ -26,6 +26,7 @@ class MacroConditionStreamdeck : public MacroCondition {
 public:
 	MacroConditionStreamdeck(Macro *m);
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	std::string GetId() const { return id; };
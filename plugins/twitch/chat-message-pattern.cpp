@@ -1,12 +1,120 @@
 #include "chat-message-pattern.hpp"
 
 #include <log-helper.hpp>
+#include <multi-pattern-matcher.hpp>
 #include <obs-module-helper.hpp>
 #include <QComboBox>
 #include <ui-helpers.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
 namespace advss {
 
+namespace {
+
+// All chat conditions check the same incoming messages, so the message
+// patterns of all of them are evaluated in a single pass per message and the
+// results are shared
+class SharedMessageMatcher {
+public:
+	static SharedMessageMatcher &Instance();
+
+	bool Matches(const ChatMessagePattern *owner,
+		     const std::string &pattern, const RegexConfig &regex,
+		     const IRCMessage &message);
+	void Remove(const ChatMessagePattern *owner);
+
+private:
+	struct Registration {
+		size_t id;
+		std::string pattern;
+		RegexConfig regex;
+		uint64_t generation;
+	};
+
+	struct Result {
+		std::string messageId;
+		std::string message;
+		uint64_t generation;
+		std::vector<size_t> matches;
+	};
+
+	static constexpr size_t _maxResults = 64;
+
+	std::mutex _mutex;
+	MultiPatternMatcher _matcher;
+	std::unordered_map<const ChatMessagePattern *, Registration>
+		_registrations;
+	uint64_t _generation = 0;
+	std::deque<Result> _results;
+};
+
+} // namespace
+
+SharedMessageMatcher &SharedMessageMatcher::Instance()
+{
+	static SharedMessageMatcher matcher;
+	return matcher;
+}
+
+bool SharedMessageMatcher::Matches(const ChatMessagePattern *owner,
+				   const std::string &pattern,
+				   const RegexConfig &regex,
+				   const IRCMessage &message)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _registrations.find(owner);
+	const bool isRegistered = it != _registrations.end();
+	if (!isRegistered || it->second.pattern != pattern ||
+	    it->second.regex != regex) {
+		if (isRegistered) {
+			_matcher.Remove(it->second.id);
+		}
+		Registration registration{_matcher.Add(pattern, regex),
+					  pattern, regex, ++_generation};
+		it = _registrations.insert_or_assign(owner, registration).first;
+	}
+	const auto &registration = it->second;
+
+	auto isSameMessage = [&message](const Result &result) {
+		return result.messageId == message.properties.id &&
+		       result.message == message.message;
+	};
+	auto result = std::find_if(_results.begin(), _results.end(),
+				   isSameMessage);
+	if (result == _results.end() ||
+	    result->generation < registration.generation) {
+		if (result != _results.end()) {
+			_results.erase(result);
+		}
+		_results.push_back({message.properties.id, message.message,
+				    _generation,
+				    _matcher.Match(message.message)});
+		if (_results.size() > _maxResults) {
+			_results.pop_front();
+		}
+		result = std::prev(_results.end());
+	}
+
+	return std::binary_search(result->matches.begin(),
+				  result->matches.end(), registration.id);
+}
+
+void SharedMessageMatcher::Remove(const ChatMessagePattern *owner)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _registrations.find(owner);
+	if (it == _registrations.end()) {
+		return;
+	}
+	_matcher.Remove(it->second.id);
+	_registrations.erase(it);
+}
+
 const std::vector<ChatMessageProperty::PropertyInfo> ChatMessageProperty::_supportedProperties = {
 	{"firstMessage",
 	 "AdvSceneSwitcher.condition.twitch.type.chat.properties.firstMessage",
@@ -524,12 +632,23 @@ void ChatMessagePattern::Load(obs_data_t *obj)
 	}
 }
 
+ChatMessagePattern::~ChatMessagePattern()
+{
+	SharedMessageMatcher::Instance().Remove(this);
+}
+
 bool ChatMessagePattern::Matches(const IRCMessage &chatMessage) const
 {
-	const bool messageMatch =
-		!_regex.Enabled()
-			? chatMessage.message == std::string(_message)
-			: _regex.Matches(chatMessage.message, _message);
+	bool messageMatch = false;
+	if (chatMessage.properties.id.empty()) {
+		messageMatch =
+			!_regex.Enabled()
+				? chatMessage.message == std::string(_message)
+				: _regex.Matches(chatMessage.message, _message);
+	} else {
+		messageMatch = SharedMessageMatcher::Instance().Matches(
+			this, _message, _regex, chatMessage);
+	}
 	if (!messageMatch) {
 		return false;
 	}
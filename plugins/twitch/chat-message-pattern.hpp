@@ -40,6 +40,11 @@ private:
 
 class ChatMessagePattern {
 public:
+	ChatMessagePattern() = default;
+	ChatMessagePattern(const ChatMessagePattern &) = default;
+	ChatMessagePattern &operator=(const ChatMessagePattern &) = default;
+	~ChatMessagePattern();
+
 	void Save(obs_data_t *obj) const;
 	void Load(obs_data_t *obj);
 
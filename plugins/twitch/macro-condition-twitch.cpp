@@ -282,11 +282,7 @@ bool MacroConditionTwitch::CheckChannelLiveEvents()
 		return false;
 	}
 
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
+	while (auto event = _eventBuffer->ConsumeMessage()) {
 		if (_subscriptionID != event->id) {
 			continue;
 		}
@@ -408,11 +404,7 @@ bool MacroConditionTwitch::HandleMatchingSubscriptionEvents(
 		return false;
 	}
 
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
+	while (auto event = _eventBuffer->ConsumeMessage()) {
 		if (_subscriptionID != event->id) {
 			continue;
 		}
@@ -579,12 +571,7 @@ bool MacroConditionTwitch::ChatConnectionIsSetup(TwitchToken &token)
 bool MacroConditionTwitch::HandleChatEvents(
 	const std::function<bool(const IRCMessage &)> &matchCb)
 {
-	while (!_chatBuffer->Empty()) {
-		auto message = _chatBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-
+	while (auto message = _chatBuffer->ConsumeMessage()) {
 		if (!matchCb(*message)) {
 			continue;
 		}
@@ -681,6 +668,12 @@ void MacroConditionTwitch::HandleMacroPause()
 	}
 }
 
+bool MacroConditionTwitch::HasPendingMessages() const
+{
+	return (_eventBuffer && !_eventBuffer->Empty()) ||
+	       (_chatBuffer && !_chatBuffer->Empty());
+}
+
 bool MacroConditionTwitch::CheckCondition()
 {
 	SetVariableValue("");
@@ -98,6 +98,7 @@ public:
 	bool IsUsingEventSubCondition();
 
 	bool CheckCondition();
+	bool HasPendingMessages() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 	bool ConditionIsSupportedByToken();
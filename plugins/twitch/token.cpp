@@ -419,24 +419,14 @@ TwitchToken *GetTwitchTokenByName(const QString &name)
 
 TwitchToken *GetTwitchTokenByName(const std::string &name)
 {
-	for (auto &t : twitchTokens) {
-		if (t->Name() == name) {
-			return dynamic_cast<TwitchToken *>(t.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<TwitchToken *>(
+		GetItemByName(twitchTokens, name).get());
 }
 
 std::weak_ptr<TwitchToken> GetWeakTwitchTokenByName(const std::string &name)
 {
-	for (const auto &t : twitchTokens) {
-		if (t->Name() == name) {
-			std::weak_ptr<TwitchToken> wp =
-				std::dynamic_pointer_cast<TwitchToken>(t);
-			return wp;
-		}
-	}
-	return std::weak_ptr<TwitchToken>();
+	return std::dynamic_pointer_cast<TwitchToken>(
+		GetItemByName(twitchTokens, name));
 }
 
 std::weak_ptr<TwitchToken> GetWeakTwitchTokenByQString(const QString &name)
@@ -1009,6 +999,19 @@ void TokenGrabberThread::Stop()
 	wait();
 }
 
+TwitchConnectionSignalManager::TwitchConnectionSignalManager(QObject *parent)
+	: QObject(parent)
+{
+	// Keep the name index used for lookups up to date
+	const auto invalidateIndex = []() {
+		InvalidateItemNameIndex(twitchTokens);
+	};
+	connect(this, &TwitchConnectionSignalManager::Add, this,
+		invalidateIndex);
+	connect(this, &TwitchConnectionSignalManager::Remove, this,
+		invalidateIndex);
+}
+
 TwitchConnectionSignalManager *TwitchConnectionSignalManager::Instance()
 {
 	static TwitchConnectionSignalManager manager;
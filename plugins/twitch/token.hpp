@@ -152,6 +152,7 @@ public:
 class TwitchConnectionSignalManager : public QObject {
 	Q_OBJECT
 public:
+	TwitchConnectionSignalManager(QObject *parent = nullptr);
 	static TwitchConnectionSignalManager *Instance();
 
 private:
@@ -103,18 +103,25 @@ bool MacroConditionVideo::CheckCondition()
 
 	if (!FileInputIsUpToDate()) {
 		LoadImageFromFile();
+		// Compare the current frame against the new image
+		_lastFrame.reset();
+	}
+
+	if (_continuousCapture) {
+		return CheckLatestFrame();
 	}
 
 	if (_blockUntilScreenshotDone) {
 		GetScreenshot(true);
 	}
 
-	if (_screenshotData.IsDone()) {
+	if (ScreenshotIsDone()) {
+		_screenshot = _frame.get()->image;
 		match = Compare();
 		_lastMatchResult = match;
 
 		if (!requiresFileInput(_condition)) {
-			_matchImage = std::move(_screenshotData.GetImage());
+			_matchImage = _screenshot;
 		}
 		_getNextScreenshot = true;
 	} else {
@@ -137,12 +144,15 @@ bool MacroConditionVideo::Save(obs_data_t *obj) const
 	obs_data_set_bool(obj, "blockUntilScreenshotDone",
 			  _blockUntilScreenshotDone);
 	_brightnessThreshold.Save(obj, "brightnessThreshold");
+	obs_data_set_int(obj, "brightnessSampleStep", _brightnessSampleStep);
 	_patternMatchParameters.Save(obj);
 	_cascadeMatchParameters.Save(obj);
 	_ocrParameters.Save(obj);
 	_colorParameters.Save(obj);
 	obs_data_set_bool(obj, "throttleEnabled", _throttleEnabled);
 	obs_data_set_int(obj, "throttleCount", _throttleCount);
+	obs_data_set_bool(obj, "continuousCapture", _continuousCapture);
+	obs_data_set_int(obj, "captureRate", _captureRate);
 	_areaParameters.Save(obj);
 	return true;
 }
@@ -163,12 +173,20 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 	} else {
 		_brightnessThreshold.Load(obj, "brightnessThreshold");
 	}
+	if (obs_data_has_user_value(obj, "brightnessSampleStep")) {
+		_brightnessSampleStep =
+			obs_data_get_int(obj, "brightnessSampleStep");
+	}
 	_patternMatchParameters.Load(obj);
 	_cascadeMatchParameters.Load(obj);
 	_ocrParameters.Load(obj);
 	_colorParameters.Load(obj);
 	_throttleEnabled = obs_data_get_bool(obj, "throttleEnabled");
 	_throttleCount = obs_data_get_int(obj, "throttleCount");
+	if (obs_data_has_user_value(obj, "captureRate")) {
+		_captureRate = obs_data_get_int(obj, "captureRate");
+	}
+	SetContinuousCapture(obs_data_get_bool(obj, "continuousCapture"));
 	_areaParameters.Load(obj);
 	if (requiresFileInput(_condition)) {
 		(void)LoadImageFromFile();
@@ -182,22 +200,84 @@ std::string MacroConditionVideo::GetShortDesc() const
 	return _video.ToString();
 }
 
-void MacroConditionVideo::GetScreenshot(bool blocking)
+QRect MacroConditionVideo::GetCaptureArea() const
 {
-	auto source = obs_weak_source_get_source(_video.GetVideo());
-	_screenshotData.~Screenshot();
-	QRect screenshotArea;
+	QRect area;
 	if (_areaParameters.enable && _condition != VideoCondition::NO_IMAGE) {
-		screenshotArea.setRect(_areaParameters.area.x,
-				       _areaParameters.area.y,
-				       _areaParameters.area.width,
-				       _areaParameters.area.height);
+		area.setRect(_areaParameters.area.x, _areaParameters.area.y,
+			     _areaParameters.area.width,
+			     _areaParameters.area.height);
 	}
-	const int timeout = GetIntervalValue() < 300 ? 300 : GetIntervalValue();
-	new (&_screenshotData)
-		Screenshot(source, screenshotArea, blocking, timeout);
-	obs_source_release(source);
+	return area;
+}
+
+void MacroConditionVideo::GetScreenshot(bool blocking)
+{
+	// Conditions checked during the same interval can share their frames
+	const auto maxAge = std::chrono::milliseconds(GetIntervalValue() / 2);
+	_frame = GetFrameProvider().Request(_video.GetVideo(),
+					    GetCaptureArea(), maxAge);
 	_getNextScreenshot = false;
+	if (!blocking) {
+		return;
+	}
+
+	const int timeout = GetIntervalValue() < 300 ? 300 : GetIntervalValue();
+	if (_frame.wait_for(std::chrono::milliseconds(timeout)) ==
+	    std::future_status::timeout) {
+		blog(LOG_WARNING, "Failed to get screenshot in time for %s",
+		     _video.ToString().c_str());
+	}
+}
+
+bool MacroConditionVideo::ScreenshotIsDone() const
+{
+	return _frame.valid() && _frame.wait_for(std::chrono::seconds(0)) ==
+					 std::future_status::ready;
+}
+
+void MacroConditionVideo::UpdateFrameSubscription()
+{
+	const auto source = _video.GetVideo();
+	const auto area = GetCaptureArea();
+	if (_frameSubscription && source == _subscribedSource &&
+	    area == _subscribedArea && _captureRate == _subscribedRate) {
+		return;
+	}
+
+	const auto interval = std::chrono::milliseconds(
+		1000 / std::max(_captureRate, 1));
+	_frameSubscription =
+		GetFrameProvider().Subscribe(source, area, interval);
+	_subscribedSource = source;
+	_subscribedArea = area;
+	_subscribedRate = _captureRate;
+	_lastFrame.reset();
+}
+
+bool MacroConditionVideo::CheckLatestFrame()
+{
+	UpdateFrameSubscription();
+	const auto frame = _frameSubscription->GetLatestFrame();
+	if (!frame) {
+		return _lastMatchResult;
+	}
+
+	const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::high_resolution_clock::now() - frame->time);
+	SetTempVarValue("frameAge", std::to_string(age.count()));
+
+	// Nothing can have changed since the last check
+	if (frame == _lastFrame) {
+		return _lastMatchResult;
+	}
+	_lastFrame = frame;
+	_screenshot = frame->image;
+	_lastMatchResult = Compare();
+	if (!requiresFileInput(_condition)) {
+		_matchImage = _screenshot;
+	}
+	return _lastMatchResult;
 }
 
 bool MacroConditionVideo::LoadImageFromFile()
@@ -244,11 +324,21 @@ void MacroConditionVideo::SetCondition(VideoCondition condition)
 	SetupTempVars();
 }
 
+void MacroConditionVideo::SetContinuousCapture(bool enable)
+{
+	_continuousCapture = enable;
+	if (!enable) {
+		_frameSubscription.reset();
+		_lastFrame.reset();
+	}
+	SetupTempVars();
+}
+
 bool MacroConditionVideo::ScreenshotContainsPattern()
 {
 	cv::Mat result;
 	double bestMatchValue =
-		MatchPattern(_screenshotData.GetImage(), _patternImageData,
+		MatchPattern(_screenshot, _patternImageData,
 			     _patternMatchParameters.threshold, result,
 			     _patternMatchParameters.useAlphaAsMask,
 			     _patternMatchParameters.matchMode);
@@ -312,13 +402,13 @@ bool MacroConditionVideo::FileInputIsUpToDate() const
 bool MacroConditionVideo::OutputChanged()
 {
 	if (!_patternMatchParameters.useForChangedCheck) {
-		return _screenshotData.GetImage() != _matchImage;
+		return _screenshot != _matchImage;
 	}
 
 	cv::Mat result;
 	_patternImageData = CreatePatternData(_matchImage);
 	double bestMatchValue =
-		MatchPattern(_screenshotData.GetImage(), _patternImageData,
+		MatchPattern(_screenshot, _patternImageData,
 			     _patternMatchParameters.threshold, result,
 			     _patternMatchParameters.useAlphaAsMask,
 			     _patternMatchParameters.matchMode);
@@ -335,7 +425,7 @@ bool MacroConditionVideo::ScreenshotContainsObject()
 	if (!detector) {
 		return false;
 	}
-	auto objects = detector->Detect(_screenshotData.GetImage());
+	auto objects = detector->Detect(_screenshot);
 	const auto count = objects.size();
 	SetTempVarValue("objectCount", std::to_string(count));
 	return count > 0;
@@ -344,7 +434,7 @@ bool MacroConditionVideo::ScreenshotContainsObject()
 bool MacroConditionVideo::CheckBrightnessThreshold()
 {
 	_currentBrightness =
-		GetAvgBrightness(_screenshotData.GetImage()) / 255.;
+		GetAvgBrightness(_screenshot, _brightnessSampleStep) / 255.;
 	SetTempVarValue("brightness", std::to_string(_currentBrightness));
 	return _currentBrightness > _brightnessThreshold;
 }
@@ -356,8 +446,7 @@ bool MacroConditionVideo::CheckOCR()
 		return false;
 	}
 
-	auto text = RunOCR(ocr, _screenshotData.GetImage(),
-			   _ocrParameters.color.GetValue(),
+	auto text = RunOCR(ocr, _screenshot, _ocrParameters.color.GetValue(),
 			   _ocrParameters.colorThreshold);
 	if (!text) {
 		return false;
@@ -374,18 +463,19 @@ bool MacroConditionVideo::CheckOCR()
 bool MacroConditionVideo::CheckColor()
 {
 	const bool ret = ContainsPixelsInColorRange(
-		_screenshotData.GetImage(), _colorParameters.color.GetValue(),
+		_screenshot, _colorParameters.color.GetValue(),
 		_colorParameters.colorThreshold,
 		_colorParameters.matchThreshold);
 
 	SetTempVarValue("color", [&]() {
-		return GetAverageColor(_screenshotData.GetImage())
+		return GetAverageColor(_screenshot)
 			.name(QColor::HexArgb)
 			.toStdString();
 	});
 
 	SetTempVarValue("dominantColor", [&]() {
-		return GetDominantColor(_screenshotData.GetImage(), 3)
+		return GetDominantColor(_screenshot, 3,
+					_colorParameters.dominantColorSamples)
 			.name(QColor::HexArgb)
 			.toStdString();
 	});
@@ -401,15 +491,15 @@ bool MacroConditionVideo::Compare()
 
 	switch (_condition) {
 	case VideoCondition::MATCH:
-		return _screenshotData.GetImage() == _matchImage;
+		return _screenshot == _matchImage;
 	case VideoCondition::DIFFER:
-		return _screenshotData.GetImage() != _matchImage;
+		return _screenshot != _matchImage;
 	case VideoCondition::HAS_CHANGED:
 		return OutputChanged();
 	case VideoCondition::HAS_NOT_CHANGED:
 		return !OutputChanged();
 	case VideoCondition::NO_IMAGE:
-		return _screenshotData.GetImage().isNull();
+		return _screenshot.isNull();
 	case VideoCondition::PATTERN:
 		return ScreenshotContainsPattern();
 	case VideoCondition::OBJECT_CASCADE:
@@ -429,6 +519,14 @@ bool MacroConditionVideo::Compare()
 void MacroConditionVideo::SetupTempVars()
 {
 	MacroCondition::SetupTempVars();
+	if (_continuousCapture) {
+		AddTempvar(
+			"frameAge",
+			obs_module_text(
+				"AdvSceneSwitcher.tempVar.video.frameAge"),
+			obs_module_text(
+				"AdvSceneSwitcher.tempVar.video.frameAge.description"));
+	}
 	switch (_condition) {
 	case VideoCondition::HAS_CHANGED:
 	case VideoCondition::HAS_NOT_CHANGED:
@@ -620,6 +718,9 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	  _throttleControlLayout(new QHBoxLayout),
 	  _throttleEnable(new QCheckBox()),
 	  _throttleCount(new QSpinBox()),
+	  _continuousCaptureLayout(new QHBoxLayout),
+	  _continuousCapture(new QCheckBox()),
+	  _captureRate(new QSpinBox()),
 	  _keepActive(new QCheckBox(
 		  obs_module_text("AdvSceneSwitcher.keepSourceActive"))),
 	  _keepActiveHelp(new HelpIcon(
@@ -639,6 +740,11 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	_throttleCount->setMaximum(10 * GetIntervalValue());
 	_throttleCount->setSingleStep(GetIntervalValue());
 
+	_continuousCapture->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.continuousCapture.tooltip"));
+	_captureRate->setMinimum(1);
+	_captureRate->setMaximum(60);
+
 	_brightness->setSizePolicy(QSizePolicy::MinimumExpanding,
 				   QSizePolicy::Preferred);
 	_ocr->setSizePolicy(QSizePolicy::MinimumExpanding,
@@ -681,6 +787,10 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			 SLOT(ThrottleEnableChanged(int)));
 	QWidget::connect(_throttleCount, SIGNAL(valueChanged(int)), this,
 			 SLOT(ThrottleCountChanged(int)));
+	QWidget::connect(_continuousCapture, SIGNAL(stateChanged(int)), this,
+			 SLOT(ContinuousCaptureChanged(int)));
+	QWidget::connect(_captureRate, SIGNAL(valueChanged(int)), this,
+			 SLOT(CaptureRateChanged(int)));
 	QWidget::connect(_keepActive, SIGNAL(stateChanged(int)), this,
 			 SLOT(KeepActiveChanged(int)));
 	QWidget::connect(_showMatch, SIGNAL(clicked()), this,
@@ -703,6 +813,7 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 
 	_patternMatchModeLayout->setContentsMargins(0, 0, 0, 0);
 	_throttleControlLayout->setContentsMargins(0, 0, 0, 0);
+	_continuousCaptureLayout->setContentsMargins(0, 0, 0, 0);
 
 	QHBoxLayout *entryLine1Layout = new QHBoxLayout;
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
@@ -714,6 +825,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		{"{{imagePath}}", _imagePath},
 		{"{{throttleEnable}}", _throttleEnable},
 		{"{{throttleCount}}", _throttleCount},
+		{"{{continuousCapture}}", _continuousCapture},
+		{"{{captureRate}}", _captureRate},
 		{"{{patternMatchingModes}}", _patternMatchMode},
 	};
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.video.layout"),
@@ -726,6 +839,10 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		obs_module_text(
 			"AdvSceneSwitcher.condition.video.layout.throttle"),
 		_throttleControlLayout, widgetPlaceholders);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.layout.continuousCapture"),
+		_continuousCaptureLayout, widgetPlaceholders);
 
 	QHBoxLayout *keepActiveLayout = new QHBoxLayout;
 	keepActiveLayout->addWidget(_keepActive);
@@ -748,6 +865,7 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	mainLayout->addLayout(_throttleControlLayout);
 	mainLayout->addWidget(_area);
 	mainLayout->addLayout(keepActiveLayout);
+	mainLayout->addLayout(_continuousCaptureLayout);
 	mainLayout->addWidget(_reduceLatency);
 	mainLayout->addLayout(showMatchLayout);
 	setLayout(mainLayout);
@@ -916,6 +1034,7 @@ void MacroConditionVideoEdit::ImageBrowseButtonClicked()
 void MacroConditionVideoEdit::UsePatternForChangedCheckChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_patternMatchParameters.useForChangedCheck = value;
 	_entryData->SetupTempVars();
 	SetWidgetVisibility();
@@ -925,6 +1044,7 @@ void MacroConditionVideoEdit::PatternThresholdChanged(
 	const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_patternMatchParameters.threshold = value;
 	_previewDialog.PatternMatchParametersChanged(
 		_entryData->_patternMatchParameters);
@@ -939,6 +1059,7 @@ void MacroConditionVideoEdit::ReduceLatencyChanged(int value)
 void MacroConditionVideoEdit::UseAlphaAsMaskChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_patternMatchParameters.useAlphaAsMask = value;
 	_entryData->LoadImageFromFile();
 	_previewDialog.PatternMatchParametersChanged(
@@ -948,6 +1069,7 @@ void MacroConditionVideoEdit::UseAlphaAsMaskChanged(int value)
 void MacroConditionVideoEdit::PatternMatchModeChanged(int idx)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_patternMatchParameters.matchMode =
 		static_cast<cv::TemplateMatchModes>(
 			_patternMatchMode->itemData(idx).toInt());
@@ -968,6 +1090,20 @@ void MacroConditionVideoEdit::ThrottleCountChanged(int value)
 	_entryData->_throttleCount = value / GetIntervalValue();
 }
 
+void MacroConditionVideoEdit::ContinuousCaptureChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetContinuousCapture(value);
+	_captureRate->setEnabled(value);
+	SetWidgetVisibility();
+}
+
+void MacroConditionVideoEdit::CaptureRateChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_captureRate = value;
+}
+
 void MacroConditionVideoEdit::KeepActiveChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
@@ -1063,6 +1199,10 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 	if (_entryData->_blockUntilScreenshotDone) {
 		_reduceLatency->hide();
 	}
+	// Frames are never waited for in continuous capture mode
+	if (_entryData->GetContinuousCapture()) {
+		_reduceLatency->hide();
+	}
 
 	Resize();
 }
@@ -1112,6 +1252,9 @@ void MacroConditionVideoEdit::UpdateEntryData()
 	_throttleCount->setValue(_entryData->_throttleCount *
 				 GetIntervalValue());
 	_keepActive->setChecked(_entryData->_keepActive);
+	_continuousCapture->setChecked(_entryData->GetContinuousCapture());
+	_captureRate->setValue(_entryData->_captureRate);
+	_captureRate->setEnabled(_entryData->GetContinuousCapture());
 	UpdatePreviewTooltip();
 	SetupPreviewDialogParams();
 	SetWidgetVisibility();
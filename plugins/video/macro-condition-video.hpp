@@ -8,7 +8,7 @@
 #include "section.hpp"
 #include "macro-condition-edit.hpp"
 #include "file-selection.hpp"
-#include "screenshot-helper.hpp"
+#include "frame-provider.hpp"
 #include "slider-spinbox.hpp"
 #include "source-helpers.hpp"
 #include "variable-color-button.hpp"
@@ -48,7 +48,12 @@ public:
 	QImage GetMatchImage() const { return _matchImage; };
 	void GetScreenshot(bool blocking = false);
 	bool LoadImageFromFile();
-	void ResetLastMatch() { _lastMatchResult = false; }
+	void ResetLastMatch()
+	{
+		_lastMatchResult = false;
+		ResetLastFrame();
+	}
+	void ResetLastFrame() { _lastFrame.reset(); }
 	double GetCurrentBrightness() const { return _currentBrightness; }
 	void SetPageSegMode(tesseract::PageSegMode);
 	bool SetLanguageCode(const std::string &);
@@ -56,6 +61,8 @@ public:
 
 	void SetCondition(VideoCondition);
 	VideoCondition GetCondition() const { return _condition; }
+	void SetContinuousCapture(bool);
+	bool GetContinuousCapture() const { return _continuousCapture; }
 	void SetupTempVars();
 
 	VideoInput _video;
@@ -72,6 +79,9 @@ public:
 	// superfluous with "short circuit" evaluation.
 	bool _blockUntilScreenshotDone = true;
 	NumberVariable<double> _brightnessThreshold = 0.5;
+	// Only every n-th pixel of every n-th row is used to estimate the
+	// brightness
+	int _brightnessSampleStep = 1;
 	PatternMatchParameters _patternMatchParameters;
 	CascadeClassifierParameters _cascadeMatchParameters;
 	OCRParameters _ocrParameters;
@@ -81,6 +91,8 @@ public:
 	// superfluous with "short circuit" evaluation.
 	bool _throttleEnabled = false;
 	int _throttleCount = 3;
+	// Frames per second captured in continuous capture mode
+	int _captureRate = 10;
 
 signals:
 	void InputFileChanged();
@@ -90,6 +102,10 @@ private:
 	void UpdateActiveKeeper();
 
 	bool OutputChanged();
+	bool ScreenshotIsDone() const;
+	QRect GetCaptureArea() const;
+	bool CheckLatestFrame();
+	void UpdateFrameSubscription();
 	bool ScreenshotContainsPattern();
 	bool ScreenshotContainsObject();
 	bool CheckBrightnessThreshold();
@@ -99,11 +115,20 @@ private:
 	bool CheckShouldBeSkipped();
 
 	VideoCondition _condition = VideoCondition::MATCH;
+	// Evaluate the newest continuously captured frame instead of
+	// requesting a frame during each check
+	bool _continuousCapture = false;
 
 	SourceActiveKeeper _activeKeeper;
 	OBSWeakSource _lastActiveKeeperSource;
 	bool _getNextScreenshot = true;
-	Screenshot _screenshotData;
+	std::shared_future<VideoFramePtr> _frame;
+	QImage _screenshot;
+	std::shared_ptr<FrameSubscription> _frameSubscription;
+	OBSWeakSource _subscribedSource;
+	QRect _subscribedArea;
+	int _subscribedRate = 0;
+	VideoFramePtr _lastFrame;
 	QImage _matchImage;
 	PatternImageData _patternImageData;
 
@@ -128,10 +153,12 @@ public:
 
 private slots:
 	void BrightnessThresholdChanged(const NumberVariable<double> &);
+	void SampleStepChanged(int);
 	void UpdateCurrentBrightness();
 
 private:
 	SliderSpinBox *_threshold;
+	QSpinBox *_sampleStep;
 	QLabel *_current;
 	QTimer _timer;
 
@@ -216,11 +243,13 @@ private slots:
 	void ColorChanged(const ColorVariable &);
 	void MatchThresholdChanged(const NumberVariable<double> &);
 	void ColorThresholdChanged(const NumberVariable<double> &);
+	void DominantColorSamplesChanged(int);
 
 private:
 	SliderSpinBox *_matchThreshold;
 	SliderSpinBox *_colorThreshold;
 	VariableColorButton *_colorButton;
+	QSpinBox *_dominantColorSamples;
 
 	std::shared_ptr<MacroConditionVideo> _entryData;
 	bool _loading = true;
@@ -288,6 +317,8 @@ private slots:
 
 	void ThrottleEnableChanged(int value);
 	void ThrottleCountChanged(int value);
+	void ContinuousCaptureChanged(int value);
+	void CaptureRateChanged(int value);
 	void ShowMatchClicked();
 	void KeepActiveChanged(int value);
 
@@ -331,6 +362,10 @@ private:
 	QCheckBox *_throttleEnable;
 	QSpinBox *_throttleCount;
 
+	QHBoxLayout *_continuousCaptureLayout;
+	QCheckBox *_continuousCapture;
+	QSpinBox *_captureRate;
+
 	QCheckBox *_keepActive;
 	HelpIcon *_keepActiveHelp;
 
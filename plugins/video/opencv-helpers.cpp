@@ -1,6 +1,9 @@
 #include "opencv-helpers.hpp"
 #include "log-helper.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace advss {
 
 PatternImageData CreatePatternData(const QImage &pattern)
@@ -134,55 +137,74 @@ double MatchPattern(QImage &img, QImage &pattern, double threshold,
 			    matchColor);
 }
 
-uchar GetAvgBrightness(QImage &img)
+// The brightness of a pixel is its HSV value, which is the maximum of its
+// red, green and blue values.
+// Only every "sampleStep"th pixel of every "sampleStep"th row is considered.
+uchar GetAvgBrightness(const QImage &img, int sampleStep)
 {
 	if (img.isNull()) {
 		return 0;
 	}
 
-	auto image = QImageToMat(img);
-	cv::Mat hsvImage, rgbImage;
-	cv::cvtColor(image, rgbImage, cv::COLOR_RGBA2RGB);
-	cv::cvtColor(rgbImage, hsvImage, cv::COLOR_RGB2HSV);
-	long long brightnessSum = 0;
-	for (int i = 0; i < hsvImage.rows; ++i) {
-		for (int j = 0; j < hsvImage.cols; ++j) {
-			brightnessSum += hsvImage.at<cv::Vec3b>(i, j)[2];
+	const auto image = QImageToMat(img);
+	const int step = std::max(sampleStep, 1);
+	if (step == 1) {
+		// The interleaved channels prevent the loop below from being
+		// vectorized, while the per channel operations of OpenCV are.
+		// The planes are reused to avoid allocating them every frame.
+		thread_local std::vector<cv::Mat> planes;
+		thread_local cv::Mat brightness;
+		cv::split(image, planes);
+		cv::max(planes[0], planes[1], brightness);
+		cv::max(brightness, planes[2], brightness);
+		const auto brightnessSum =
+			static_cast<unsigned long long>(cv::sum(brightness)[0]);
+		return brightnessSum / image.total();
+	}
+
+	const int channels = image.channels();
+	unsigned long long brightnessSum = 0;
+	unsigned long long sampleCount = 0;
+	for (int row = 0; row < image.rows; row += step) {
+		const uchar *data = image.ptr<uchar>(row);
+		for (int col = 0; col < image.cols; col += step) {
+			const uchar *pixel = data + col * channels;
+			brightnessSum +=
+				std::max({pixel[0], pixel[1], pixel[2]});
+			++sampleCount;
 		}
 	}
-	return brightnessSum / (hsvImage.rows * hsvImage.cols);
+	return brightnessSum / sampleCount;
 }
 
-static bool colorIsSimilar(const QColor &color1, const QColor &color2,
-			   int maxDiff)
+// Marks all pixels whose red, green and blue values each differ by at most
+// "maxDiff" from the given color with 255 in the single channel "mask".
+// The alpha channel is ignored.
+static void getColorMask(const cv::Mat &image, const QColor &color, int maxDiff,
+			 cv::Mat &mask)
 {
-	const int diffRed = std::abs(color1.red() - color2.red());
-	const int diffGreen = std::abs(color1.green() - color2.green());
-	const int diffBlue = std::abs(color1.blue() - color2.blue());
-
-	return diffRed <= maxDiff && diffGreen <= maxDiff &&
-	       diffBlue <= maxDiff;
+	const cv::Scalar lower(std::max(color.red() - maxDiff, 0),
+			       std::max(color.green() - maxDiff, 0),
+			       std::max(color.blue() - maxDiff, 0), 0);
+	const cv::Scalar upper(std::min(color.red() + maxDiff, 255),
+			       std::min(color.green() + maxDiff, 255),
+			       std::min(color.blue() + maxDiff, 255), 255);
+	cv::inRange(image, lower, upper, mask);
 }
 
 cv::Mat PreprocessForOCR(const QImage &image, const QColor &textColor,
 			 double colorDiff)
 {
-	auto mat = QImageToMat(image);
+	if (image.isNull()) {
+		return cv::Mat();
+	}
 
 	// Tesseract works best when matching black text on a white background,
 	// so everything that matches the text color will be displayed black
 	// while the rest of the image should be white.
-	const int diff = colorDiff * 255;
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			if (colorIsSimilar(image.pixelColor(x, y), textColor,
-					   diff)) {
-				mat.at<cv::Vec4b>(y, x) = {0, 0, 0, 255};
-			} else {
-				mat.at<cv::Vec4b>(y, x) = {255, 255, 255, 255};
-			}
-		}
-	}
+	cv::Mat mat;
+	getColorMask(QImageToMat(image), textColor, colorDiff * 255, mat);
+	cv::bitwise_not(mat, mat);
 
 	// Scale image up if selected area is very small.
 	// Results will probably still be unsatisfying.
@@ -197,10 +219,7 @@ cv::Mat PreprocessForOCR(const QImage &image, const QColor &textColor,
 			   cv::Size(mat.cols * scale, mat.rows * scale),
 			   cv::INTER_CUBIC);
 	}
-
-	cv::Mat result;
-	mat.copyTo(result);
-	return result;
+	return mat;
 }
 
 std::optional<std::string> RunOCR(tesseract::TessBaseAPI *ocr,
@@ -214,9 +233,7 @@ std::optional<std::string> RunOCR(tesseract::TessBaseAPI *ocr,
 	}
 
 #ifdef OCR_SUPPORT
-	auto mat = PreprocessForOCR(image, color, colorDiff);
-	cv::Mat gray;
-	cv::cvtColor(mat, gray, cv::COLOR_RGBA2GRAY);
+	auto gray = PreprocessForOCR(image, color, colorDiff);
 	ocr->SetImage(gray.data, gray.cols, gray.rows, 1, gray.step);
 	ocr->Recognize(0);
 	std::unique_ptr<char[]> detectedText(ocr->GetUTF8Text());
@@ -235,22 +252,36 @@ bool ContainsPixelsInColorRange(const QImage &image, const QColor &color,
 				double colorDeviationThreshold,
 				double totalPixelMatchThreshold)
 {
-	int totalPixels = image.width() * image.height();
-	int matchingPixels = 0;
-	int maxColorDiff = static_cast<int>(colorDeviationThreshold * 255.0);
-
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			if (colorIsSimilar(image.pixelColor(x, y), color,
-					   maxColorDiff)) {
-				matchingPixels++;
-			}
-		}
+	if (image.isNull()) {
+		return false;
 	}
 
-	double matchPercentage =
-		static_cast<double>(matchingPixels) / totalPixels;
-	return matchPercentage >= totalPixelMatchThreshold;
+	const auto mat = QImageToMat(image);
+	const int maxColorDiff =
+		static_cast<int>(colorDeviationThreshold * 255.0);
+	const double requiredPixels =
+		totalPixelMatchThreshold * mat.rows * mat.cols;
+
+	// Check the image in bands of rows, so the check can stop as soon as
+	// the result is known
+	constexpr int bandHeight = 64;
+	cv::Mat mask;
+	long long matchingPixels = 0;
+	for (int row = 0; row < mat.rows; row += bandHeight) {
+		const int end = std::min(row + bandHeight, mat.rows);
+		getColorMask(mat.rowRange(row, end), color, maxColorDiff, mask);
+		matchingPixels += cv::countNonZero(mask);
+
+		const long long remainingPixels =
+			static_cast<long long>(mat.rows - end) * mat.cols;
+		if (matchingPixels >= requiredPixels) {
+			return true;
+		}
+		if (matchingPixels + remainingPixels < requiredPixels) {
+			return false;
+		}
+	}
+	return false;
 }
 
 QColor GetAverageColor(const QImage &img)
@@ -268,23 +299,49 @@ QColor GetAverageColor(const QImage &img)
 	return QColor(averageRed, averageGreen, averageBlue);
 }
 
-QColor GetDominantColor(const QImage &img, int k)
+// Returns the values of every "step"th pixel of every "step"th row as one
+// row of floats per pixel
+static cv::Mat getColorSamples(const cv::Mat &image, int step)
+{
+	const int channels = image.channels();
+	const int rows = (image.rows + step - 1) / step;
+	const int cols = (image.cols + step - 1) / step;
+	cv::Mat samples(rows * cols, channels, CV_32F);
+	int sample = 0;
+	for (int row = 0; row < image.rows; row += step) {
+		const uchar *data = image.ptr<uchar>(row);
+		for (int col = 0; col < image.cols; col += step) {
+			const uchar *pixel = data + col * channels;
+			float *values = samples.ptr<float>(sample++);
+			for (int channel = 0; channel < channels; channel++) {
+				values[channel] = pixel[channel];
+			}
+		}
+	}
+	return samples;
+}
+
+QColor GetDominantColor(const QImage &img, int k, int maxSamples)
 {
 	if (img.isNull()) {
 		return QColor();
 	}
 
-	auto image = QImageToMat(img);
-	cv::Mat reshapedImage = image.reshape(1, image.rows * image.cols);
-	reshapedImage.convertTo(reshapedImage, CV_32F);
-
-	cv::mean(reshapedImage);
+	const auto image = QImageToMat(img);
+	const double pixelCount = static_cast<double>(image.rows) * image.cols;
+	int step = 1;
+	if (maxSamples > 0 && pixelCount > maxSamples) {
+		step = static_cast<int>(std::ceil(std::sqrt(pixelCount /
+							    maxSamples)));
+	}
+	const auto samples = getColorSamples(image, step);
+	k = std::min(k, samples.rows);
 
 	// Apply k-means clustering to group similar colors
 	cv::TermCriteria criteria(
 		cv::TermCriteria::EPS + cv::TermCriteria::MAX_ITER, 100, 0.2);
 	cv::Mat labels, centers;
-	cv::kmeans(reshapedImage, k, labels, criteria, 3, cv::KMEANS_PP_CENTERS,
+	cv::kmeans(samples, k, labels, criteria, 3, cv::KMEANS_PP_CENTERS,
 		   centers);
 
 	// Find the dominant color
@@ -72,7 +72,7 @@ double MatchPattern(QImage &img, QImage &pattern, double threshold,
 		    cv::Mat &result, bool useAlphaAsMask,
 		    cv::TemplateMatchModes matchMode);
 int CountPatternMatches(const cv::Mat &result, const cv::Size &patternSize);
-uchar GetAvgBrightness(QImage &img);
+uchar GetAvgBrightness(const QImage &img, int sampleStep = 1);
 cv::Mat PreprocessForOCR(const QImage &image, const QColor &color,
 			 double colorDiff);
 std::optional<std::string> RunOCR(tesseract::TessBaseAPI *, const QImage &,
@@ -81,7 +81,9 @@ bool ContainsPixelsInColorRange(const QImage &image, const QColor &color,
 				double colorDeviationThreshold,
 				double totalPixelMatchThreshold);
 QColor GetAverageColor(const QImage &img);
-QColor GetDominantColor(const QImage &image, int k);
+// Only up to "maxSamples" pixels, evenly spread across the image, are
+// clustered to find the dominant color. A value of 0 will use all pixels.
+QColor GetDominantColor(const QImage &image, int k, int maxSamples = 0);
 cv::Mat QImageToMat(const QImage &img);
 QImage MatToQImage(const cv::Mat &mat);
 
@@ -492,6 +492,7 @@ bool ColorParameters::Save(obs_data_t *obj) const
 	color.Save(data, "color");
 	colorThreshold.Save(data, "colorThreshold");
 	matchThreshold.Save(data, "matchThreshold");
+	obs_data_set_int(data, "dominantColorSamples", dominantColorSamples);
 	obs_data_set_obj(obj, "colorData", data);
 	obs_data_release(data);
 	return true;
@@ -503,6 +504,9 @@ bool ColorParameters::Load(obs_data_t *obj)
 	color.Load(data, "color");
 	colorThreshold.Load(data, "colorThreshold");
 	matchThreshold.Load(data, "matchThreshold");
+	// Conditions saved before the dominant color could be estimated from
+	// a subset of the pixels keep using all of them
+	dominantColorSamples = obs_data_get_int(data, "dominantColorSamples");
 	obs_data_release(data);
 	return true;
 }
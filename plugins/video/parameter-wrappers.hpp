@@ -162,6 +162,9 @@ public:
 	ColorVariable color;
 	DoubleVariable colorThreshold = 0.1;
 	DoubleVariable matchThreshold = 0.8;
+	// Number of pixels used to estimate the dominant color.
+	// A value of 0 will use all pixels.
+	int dominantColorSamples = 10000;
 };
 
 class AreaParameters {
@@ -65,6 +65,7 @@ void AreaEdit::SelectAreaClicked()
 void AreaEdit::CheckAreaEnableChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_areaParameters.enable = value;
 	SetWidgetVisibility();
 	_previewDialog->AreaParametersChanged(_entryData->_areaParameters);
@@ -74,6 +75,7 @@ void AreaEdit::CheckAreaEnableChanged(int value)
 void AreaEdit::CheckAreaChanged(Area value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_areaParameters.area = value;
 	_previewDialog->AreaParametersChanged(_entryData->_areaParameters);
 }
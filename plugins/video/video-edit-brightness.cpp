@@ -1,5 +1,7 @@
 #include "macro-condition-video.hpp"
+#include "layout-helpers.hpp"
 
+#include <QSpinBox>
 #include <QTimer>
 #include <QVBoxLayout>
 
@@ -14,12 +16,26 @@ BrightnessEdit::BrightnessEdit(QWidget *parent,
 			  "AdvSceneSwitcher.condition.video.brightnessThreshold"),
 		  obs_module_text(
 			  "AdvSceneSwitcher.condition.video.brightnessThresholdDescription"))),
+	  _sampleStep(new QSpinBox()),
 	  _current(new QLabel),
 	  _entryData(data)
 {
+	_sampleStep->setMinimum(1);
+	_sampleStep->setMaximum(32);
+	_sampleStep->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.brightnessSampleStep.tooltip"));
+
+	auto sampleStepLayout = new QHBoxLayout;
+	sampleStepLayout->setContentsMargins(0, 0, 0, 0);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.layout.brightnessSampleStep"),
+		sampleStepLayout, {{"{{sampleStep}}", _sampleStep}});
+
 	auto layout = new QVBoxLayout;
 	layout->setContentsMargins(0, 0, 0, 0);
 	layout->addWidget(_threshold);
+	layout->addLayout(sampleStepLayout);
 	layout->addWidget(_current);
 	setLayout(layout);
 
@@ -29,11 +45,14 @@ BrightnessEdit::BrightnessEdit(QWidget *parent,
 		this,
 		SLOT(BrightnessThresholdChanged(
 			const NumberVariable<double> &)));
+	QWidget::connect(_sampleStep, SIGNAL(valueChanged(int)), this,
+			 SLOT(SampleStepChanged(int)));
 	QWidget::connect(&_timer, &QTimer::timeout, this,
 			 &BrightnessEdit::UpdateCurrentBrightness);
 	_timer.start(1000);
 
 	_threshold->SetDoubleValue(_entryData->_brightnessThreshold);
+	_sampleStep->setValue(_entryData->_brightnessSampleStep);
 	_loading = false;
 }
 
@@ -47,7 +66,15 @@ void BrightnessEdit::UpdateCurrentBrightness()
 void BrightnessEdit::BrightnessThresholdChanged(const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_brightnessThreshold = value;
 }
 
+void BrightnessEdit::SampleStepChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
+	_entryData->_brightnessSampleStep = value;
+}
+
 } // namespace advss
@@ -2,6 +2,7 @@
 #include "layout-helpers.hpp"
 #include "plugin-state-helpers.hpp"
 
+#include <QSpinBox>
 #include <QVBoxLayout>
 
 namespace advss {
@@ -27,8 +28,17 @@ ColorEdit::ColorEdit(QWidget *parent,
 		  this,
 		  obs_module_text(
 			  "AdvSceneSwitcher.condition.video.selectColor"))),
+	  _dominantColorSamples(new QSpinBox()),
 	  _entryData(data)
 {
+	_dominantColorSamples->setMinimum(0);
+	_dominantColorSamples->setMaximum(1000000);
+	_dominantColorSamples->setSingleStep(1000);
+	_dominantColorSamples->setSpecialValueText(obs_module_text(
+		"AdvSceneSwitcher.condition.video.dominantColorSamples.all"));
+	_dominantColorSamples->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.dominantColorSamples.tooltip"));
+
 	QWidget::connect(_colorButton,
 			 SIGNAL(ColorVariableChanged(const ColorVariable &)),
 			 this, SLOT(ColorChanged(const ColorVariable &)));
@@ -42,9 +52,12 @@ ColorEdit::ColorEdit(QWidget *parent,
 		SIGNAL(DoubleValueChanged(const NumberVariable<double> &)),
 		this,
 		SLOT(ColorThresholdChanged(const NumberVariable<double> &)));
+	QWidget::connect(_dominantColorSamples, SIGNAL(valueChanged(int)),
+			 this, SLOT(DominantColorSamplesChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{color}}", _colorButton},
+		{"{{dominantColorSamples}}", _dominantColorSamples},
 	};
 
 	auto colorLayout = new QHBoxLayout;
@@ -52,11 +65,19 @@ ColorEdit::ColorEdit(QWidget *parent,
 			     "AdvSceneSwitcher.condition.video.layout.color"),
 		     colorLayout, widgetPlaceholders);
 
+	auto dominantColorLayout = new QHBoxLayout;
+	dominantColorLayout->setContentsMargins(0, 0, 0, 0);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.layout.dominantColorSamples"),
+		dominantColorLayout, widgetPlaceholders);
+
 	auto layout = new QVBoxLayout;
 	layout->setContentsMargins(0, 0, 0, 0);
 	layout->addLayout(colorLayout);
 	layout->addWidget(_colorThreshold);
 	layout->addWidget(_matchThreshold);
+	layout->addLayout(dominantColorLayout);
 	setLayout(layout);
 
 	_matchThreshold->SetDoubleValue(
@@ -64,25 +85,37 @@ ColorEdit::ColorEdit(QWidget *parent,
 	_colorThreshold->SetDoubleValue(
 		_entryData->_colorParameters.colorThreshold);
 	_colorButton->SetValue(_entryData->_colorParameters.color);
+	_dominantColorSamples->setValue(
+		_entryData->_colorParameters.dominantColorSamples);
 	_loading = false;
 }
 
 void ColorEdit::ColorChanged(const ColorVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_colorParameters.color = value;
 }
 
 void ColorEdit::MatchThresholdChanged(const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_colorParameters.matchThreshold = value;
 }
 
 void ColorEdit::ColorThresholdChanged(const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_colorParameters.colorThreshold = value;
 }
 
+void ColorEdit::DominantColorSamplesChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
+	_entryData->_colorParameters.dominantColorSamples = value;
+}
+
 } // namespace advss
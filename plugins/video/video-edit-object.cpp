@@ -104,6 +104,7 @@ void CascadeClassifierEdit::ObjectScaleThresholdChanged(
 	const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_cascadeMatchParameters.scaleFactor = value;
 	_previewDialog->CascadeClassifierParametersChanged(
 		_entryData->_cascadeMatchParameters);
@@ -112,6 +113,7 @@ void CascadeClassifierEdit::ObjectScaleThresholdChanged(
 void CascadeClassifierEdit::MinNeighborsChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_cascadeMatchParameters.minNeighbors = value;
 	_previewDialog->CascadeClassifierParametersChanged(
 		_entryData->_cascadeMatchParameters);
@@ -120,6 +122,7 @@ void CascadeClassifierEdit::MinNeighborsChanged(int value)
 void CascadeClassifierEdit::MinSizeChanged(advss::Size value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_cascadeMatchParameters.minSize = value;
 	_previewDialog->CascadeClassifierParametersChanged(
 		_entryData->_cascadeMatchParameters);
@@ -128,6 +131,7 @@ void CascadeClassifierEdit::MinSizeChanged(advss::Size value)
 void CascadeClassifierEdit::MaxSizeChanged(advss::Size value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_cascadeMatchParameters.maxSize = value;
 	_previewDialog->CascadeClassifierParametersChanged(
 		_entryData->_cascadeMatchParameters);
@@ -145,6 +149,7 @@ void CascadeClassifierEdit::ModelPathChanged(const QString &text)
 		std::string path = text.toStdString();
 		dataLoaded =
 			_entryData->_cascadeMatchParameters.SetModelPath(path);
+		_entryData->ResetLastFrame();
 	}
 	if (!dataLoaded) {
 		DisplayMessage(obs_module_text(
@@ -130,6 +130,7 @@ OCREdit::OCREdit(QWidget *parent, PreviewDialog *previewDialog,
 	});
 	QWidget::connect(_reloadConfig, &QPushButton::clicked, [this](bool) {
 		GUARD_LOADING_AND_LOCK();
+		_entryData->ResetLastFrame();
 		_entryData->_ocrParameters.EnableCustomConfig(true);
 		_previewDialog->OCRParametersChanged(
 			_entryData->_ocrParameters);
@@ -217,6 +218,7 @@ OCREdit::OCREdit(QWidget *parent, PreviewDialog *previewDialog,
 void OCREdit::ColorChanged(const ColorVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.color = value;
 
 	_previewDialog->OCRParametersChanged(_entryData->_ocrParameters);
@@ -225,6 +227,7 @@ void OCREdit::ColorChanged(const ColorVariable &value)
 void OCREdit::ColorThresholdChanged(const DoubleVariable &value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.colorThreshold = value;
 
 	_previewDialog->OCRParametersChanged(_entryData->_ocrParameters);
@@ -233,6 +236,7 @@ void OCREdit::ColorThresholdChanged(const DoubleVariable &value)
 void OCREdit::MatchTextChanged()
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.text =
 		_matchText->toPlainText().toUtf8().constData();
 
@@ -245,6 +249,7 @@ void OCREdit::MatchTextChanged()
 void OCREdit::RegexChanged(const RegexConfig &conf)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.regex = conf;
 	adjustSize();
 	updateGeometry();
@@ -255,6 +260,7 @@ void OCREdit::RegexChanged(const RegexConfig &conf)
 void OCREdit::PageSegModeChanged(int idx)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->SetPageSegMode(static_cast<tesseract::PageSegMode>(
 		_pageSegMode->itemData(idx).toInt()));
 
@@ -264,6 +270,7 @@ void OCREdit::PageSegModeChanged(int idx)
 void OCREdit::TesseractBaseDirChanged(const QString &path)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	if (!_entryData->SetTesseractBaseDir(path.toStdString())) {
 		const QString message(obs_module_text(
 			"AdvSceneSwitcher.condition.video.ocrLanguageNotFound"));
@@ -283,6 +290,7 @@ void OCREdit::TesseractBaseDirChanged(const QString &path)
 void OCREdit::LanguageChanged()
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	if (!_entryData->SetLanguageCode(_languageCode->text().toStdString())) {
 		const QString message(obs_module_text(
 			"AdvSceneSwitcher.condition.video.ocrLanguageNotFound"));
@@ -303,6 +311,7 @@ void OCREdit::LanguageChanged()
 void OCREdit::UseConfigChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.EnableCustomConfig(value);
 	SetLayoutVisible(_configLayout, value);
 	adjustSize();
@@ -313,6 +322,7 @@ void OCREdit::UseConfigChanged(int value)
 void OCREdit::ConfigFileChanged(const QString &path)
 {
 	GUARD_LOADING_AND_LOCK();
+	_entryData->ResetLastFrame();
 	_entryData->_ocrParameters.SetCustomConfigFile(path.toStdString());
 	_previewDialog->OCRParametersChanged(_entryData->_ocrParameters);
 }
@@ -1,4 +1,5 @@
 #include "platform-funcs.hpp"
+#include "environment-snapshot.hpp"
 #include "selection-helpers.hpp"
 
 #include <QComboBox>
@@ -21,26 +22,31 @@ std::vector<WindowInfo> g_windows;
 void SetStubForegroundProcessName(const std::string &name)
 {
 	g_foregroundProcessName = name;
+	EnvironmentSnapshot::Get().Invalidate();
 }
 
 void SetStubForegroundProcessPath(const std::string &path)
 {
 	g_foregroundProcessPath = path;
+	EnvironmentSnapshot::Get().Invalidate();
 }
 
 void SetStubProcessList(const QStringList &list)
 {
 	g_processList = list;
+	EnvironmentSnapshot::Get().Invalidate();
 }
 
 void SetStubProcessPaths(const QStringList &paths)
 {
 	g_processPathsFromName = paths;
+	EnvironmentSnapshot::Get().Invalidate();
 }
 
 void SetStubWindows(const std::vector<WindowInfo> &windows)
 {
 	g_windows = windows;
+	EnvironmentSnapshot::Get().Invalidate();
 }
 
 // --- platform-funcs.hpp stubs ---
@@ -49,6 +49,7 @@ int GetIntervalValue()
 {
 	return 0;
 }
+void WakeUpMainLoop() {}
 void AddStartStep(std::function<void()>) {}
 void AddStopStep(std::function<void()>) {}
 void RunStartSteps() {}
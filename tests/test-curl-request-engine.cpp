@@ -0,0 +1,331 @@
+#include "catch.hpp"
+
+#include <curl-helper.hpp>
+#include <curl-request-engine.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Minimal HTTP/1.1 server answering each request with a description of the
+// request it received:
+//
+// <method> <path>
+// <header lines>
+//
+// <body>
+//
+// Requests to "/delay/<ms>" are answered after the given delay.
+class StubServer {
+public:
+	StubServer()
+	{
+		_socket = socket(AF_INET, SOCK_STREAM, 0);
+		int reuse = 1;
+		setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse,
+			   sizeof(reuse));
+		sockaddr_in address = {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+		bind(_socket, (sockaddr *)&address, sizeof(address));
+		listen(_socket, 64);
+		socklen_t length = sizeof(address);
+		getsockname(_socket, (sockaddr *)&address, &length);
+		_port = ntohs(address.sin_port);
+		_acceptThread = std::thread(&StubServer::Accept, this);
+	}
+
+	~StubServer()
+	{
+		shutdown(_socket, SHUT_RDWR);
+		close(_socket);
+		_acceptThread.join();
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (int client : _clients) {
+				shutdown(client, SHUT_RDWR);
+			}
+			threads.swap(_threads);
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+	}
+
+	std::string Url(const std::string &path) const
+	{
+		return "http://127.0.0.1:" + std::to_string(_port) + path;
+	}
+
+	int ConnectionCount() const { return _connectionCount; }
+
+private:
+	void Accept()
+	{
+		while (true) {
+			int client = accept(_socket, nullptr, nullptr);
+			if (client < 0) {
+				return;
+			}
+			++_connectionCount;
+			std::lock_guard<std::mutex> lock(_mutex);
+			_clients.push_back(client);
+			_threads.emplace_back(&StubServer::Serve, this, client);
+		}
+	}
+
+	void Serve(int client)
+	{
+		std::string data;
+		char buffer[4096];
+		while (true) {
+			auto headerEnd = data.find("\r\n\r\n");
+			if (headerEnd == std::string::npos) {
+				auto count = recv(client, buffer,
+						  sizeof(buffer), 0);
+				if (count <= 0) {
+					break;
+				}
+				data.append(buffer, count);
+				continue;
+			}
+
+			const auto head = data.substr(0, headerEnd);
+			size_t contentLength = 0;
+			auto pos = head.find("Content-Length: ");
+			if (pos != std::string::npos) {
+				contentLength =
+					std::stoul(head.substr(pos + 16));
+			}
+			const auto requestEnd = headerEnd + 4 + contentLength;
+			if (data.size() < requestEnd) {
+				auto count = recv(client, buffer,
+						  sizeof(buffer), 0);
+				if (count <= 0) {
+					break;
+				}
+				data.append(buffer, count);
+				continue;
+			}
+
+			Respond(client, head,
+				data.substr(headerEnd + 4, contentLength));
+			data.erase(0, requestEnd);
+		}
+		close(client);
+	}
+
+	static void Respond(int client, const std::string &head,
+			    const std::string &body)
+	{
+		std::istringstream lines(head);
+		std::string method, path, line;
+		lines >> method >> path;
+		std::getline(lines, line);
+
+		const std::string delayPrefix = "/delay/";
+		if (path.rfind(delayPrefix, 0) == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(
+				std::stoi(path.substr(delayPrefix.size()))));
+		}
+
+		std::string content = method + " " + path + "\n";
+		while (std::getline(lines, line)) {
+			content += line.substr(0, line.find('\r')) + "\n";
+		}
+		content += "\n" + body;
+
+		const std::string response =
+			"HTTP/1.1 200 OK\r\nContent-Length: " +
+			std::to_string(content.size()) + "\r\n\r\n" + content;
+		send(client, response.data(), response.size(), MSG_NOSIGNAL);
+	}
+
+	int _socket = -1;
+	int _port = 0;
+	std::thread _acceptThread;
+	std::mutex _mutex;
+	std::vector<int> _clients;
+	std::vector<std::thread> _threads;
+	std::atomic_int _connectionCount = 0;
+};
+
+} // namespace
+
+TEST_CASE("Requests are performed", "[curl-request-engine]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl not available - skipping");
+		return;
+	}
+
+	StubServer server;
+	advss::CurlRequestEngine engine;
+
+	advss::CurlRequest request;
+	request.url = server.Url("/test");
+	auto response = engine.Perform(request);
+	REQUIRE(response.code == CURLE_OK);
+	REQUIRE(response.status == 200);
+	REQUIRE(response.error.empty());
+	REQUIRE(response.body.rfind("GET /test\n", 0) == 0);
+
+	request.discardResponseBody = true;
+	response = engine.Perform(request);
+	REQUIRE(response.code == CURLE_OK);
+	REQUIRE(response.body.empty());
+}
+
+TEST_CASE("Options do not leak between requests", "[curl-request-engine]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl not available - skipping");
+		return;
+	}
+
+	StubServer server;
+	// Only allow a single handle, so it is reused by each request
+	advss::CurlRequestEngine engine(1);
+
+	advss::CurlRequest post;
+	post.url = server.Url("/post");
+	post.method = "POST";
+	post.body = "some data";
+	post.headers = {"X-Test: value"};
+	auto response = engine.Perform(post);
+	REQUIRE(response.code == CURLE_OK);
+	REQUIRE(response.body.rfind("POST /post\n", 0) == 0);
+	REQUIRE(response.body.find("X-Test: value") != std::string::npos);
+	REQUIRE(response.body.find("\n\nsome data") != std::string::npos);
+
+	advss::CurlRequest put;
+	put.url = server.Url("/put");
+	put.method = "PUT";
+	put.body = "other data";
+	response = engine.Perform(put);
+	REQUIRE(response.code == CURLE_OK);
+	REQUIRE(response.body.rfind("PUT /put\n", 0) == 0);
+	REQUIRE(response.body.find("X-Test") == std::string::npos);
+	REQUIRE(response.body.find("\n\nother data") != std::string::npos);
+
+	advss::CurlRequest get;
+	get.url = server.Url("/get");
+	response = engine.Perform(get);
+	REQUIRE(response.code == CURLE_OK);
+	REQUIRE(response.body.rfind("GET /get\n", 0) == 0);
+	REQUIRE(response.body.find("X-Test") == std::string::npos);
+	REQUIRE(response.body.find("data") == std::string::npos);
+}
+
+TEST_CASE("Connections and handles are reused", "[curl-request-engine]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl not available - skipping");
+		return;
+	}
+
+	StubServer server;
+	advss::CurlRequestEngine engine;
+
+	advss::CurlRequest request;
+	request.url = server.Url("/test");
+	for (int i = 0; i < 10; i++) {
+		REQUIRE(engine.Perform(request).code == CURLE_OK);
+	}
+	REQUIRE(server.ConnectionCount() == 1);
+	REQUIRE(engine.GetIdleHandleCount() == 1);
+}
+
+TEST_CASE("Requests are performed in parallel", "[curl-request-engine]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl not available - skipping");
+		return;
+	}
+
+	StubServer server;
+	advss::CurlRequestEngine engine(8);
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	int done = 0;
+	int succeeded = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 8; i++) {
+		advss::CurlRequest request;
+		request.url = server.Url("/delay/200");
+		REQUIRE(engine.Submit(
+			request, [&](const advss::CurlResponse &response) {
+				std::lock_guard<std::mutex> lock(mutex);
+				++done;
+				if (response.code == CURLE_OK) {
+					++succeeded;
+				}
+				cv.notify_one();
+			}));
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&]() { return done == 8; });
+	}
+	const auto duration = std::chrono::steady_clock::now() - start;
+
+	REQUIRE(succeeded == 8);
+	// Performing the requests one after another would take 1.6 seconds
+	REQUIRE(duration < std::chrono::milliseconds(1000));
+}
+
+TEST_CASE("Requests are rejected if the queue is full",
+	  "[curl-request-engine]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl not available - skipping");
+		return;
+	}
+
+	StubServer server;
+	std::atomic_int aborted = 0;
+	{
+		advss::CurlRequestEngine engine(1, 2);
+
+		advss::CurlRequest request;
+		request.url = server.Url("/delay/500");
+		auto onDone = [&aborted](const advss::CurlResponse &response) {
+			if (response.code == CURLE_ABORTED_BY_CALLBACK) {
+				++aborted;
+			}
+		};
+
+		int submitted = 0;
+		for (int i = 0; i < 10; i++) {
+			if (engine.Submit(request, onDone)) {
+				++submitted;
+			}
+		}
+		// At most one request can be active in addition to the two
+		// queued requests
+		REQUIRE(submitted >= 2);
+		REQUIRE(submitted <= 3);
+
+		auto response = engine.Perform(request);
+		REQUIRE(response.code == CURLE_FAILED_INIT);
+		REQUIRE_FALSE(response.error.empty());
+	}
+	// Destroying the engine aborts the remaining requests
+	REQUIRE(aborted >= 2);
+}
@@ -0,0 +1,57 @@
+#include "catch.hpp"
+
+#include <frame-provider.hpp>
+
+#include <algorithm>
+
+using advss::MergeOverlappingAreas;
+
+static bool containsArea(const std::vector<QRect> &areas, const QRect &area)
+{
+	return std::find(areas.begin(), areas.end(), area) != areas.end();
+}
+
+TEST_CASE("Disjoint areas are not merged", "[frame-provider]")
+{
+	const std::vector<QRect> areas = {QRect(0, 0, 10, 10),
+					  QRect(10, 0, 10, 10),
+					  QRect(0, 20, 5, 5)};
+	const auto merged = MergeOverlappingAreas(areas);
+	REQUIRE(merged.size() == 3);
+	for (const auto &area : areas) {
+		REQUIRE(containsArea(merged, area));
+	}
+}
+
+TEST_CASE("Overlapping areas are merged", "[frame-provider]")
+{
+	auto merged = MergeOverlappingAreas(
+		{QRect(0, 0, 10, 10), QRect(5, 5, 10, 10)});
+	REQUIRE(merged.size() == 1);
+	REQUIRE(merged[0] == QRect(0, 0, 15, 15));
+
+	merged = MergeOverlappingAreas(
+		{QRect(0, 0, 100, 100), QRect(10, 10, 10, 10)});
+	REQUIRE(merged.size() == 1);
+	REQUIRE(merged[0] == QRect(0, 0, 100, 100));
+
+	merged = MergeOverlappingAreas({QRect(5, 5, 1, 1), QRect(5, 5, 1, 1)});
+	REQUIRE(merged.size() == 1);
+	REQUIRE(merged[0] == QRect(5, 5, 1, 1));
+}
+
+TEST_CASE("Merged areas are merged again", "[frame-provider]")
+{
+	// The third area connects the two previously disjoint areas
+	const auto merged = MergeOverlappingAreas(
+		{QRect(0, 0, 10, 10), QRect(20, 0, 10, 10),
+		 QRect(5, 0, 20, 5), QRect(100, 100, 1, 1)});
+	REQUIRE(merged.size() == 2);
+	REQUIRE(containsArea(merged, QRect(0, 0, 30, 10)));
+	REQUIRE(containsArea(merged, QRect(100, 100, 1, 1)));
+}
+
+TEST_CASE("No areas", "[frame-provider]")
+{
+	REQUIRE(MergeOverlappingAreas({}).empty());
+}
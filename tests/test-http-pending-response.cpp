@@ -0,0 +1,68 @@
+#include "catch.hpp"
+
+#include <http-pending-response.hpp>
+
+#include <thread>
+
+using advss::HttpPendingResponse;
+using advss::HttpResponseHandle;
+
+TEST_CASE("Only the first response is sent", "[http-pending-response]")
+{
+	HttpPendingResponse response;
+	REQUIRE_FALSE(response.Wait(std::chrono::milliseconds(0)));
+
+	response.Set(200, "first");
+	response.Set(404, "second");
+	auto result = response.Wait(std::chrono::milliseconds(0));
+	REQUIRE(result);
+	REQUIRE(result->status == 200);
+	REQUIRE(result->body == "first");
+}
+
+TEST_CASE("Waiting for a response set by another thread",
+	  "[http-pending-response]")
+{
+	HttpPendingResponse response;
+	std::thread thread([&response]() { response.Set(200, "done"); });
+	auto result = response.Wait(std::chrono::seconds(5));
+	thread.join();
+	REQUIRE(result);
+	REQUIRE(result->status == 200);
+	REQUIRE(result->body == "done");
+}
+
+TEST_CASE("Discarded response handles send the fallback status",
+	  "[http-pending-response]")
+{
+	auto response = std::make_shared<HttpPendingResponse>();
+	auto handle = std::make_shared<HttpResponseHandle>(response);
+	auto copy = handle;
+
+	handle.reset();
+	REQUIRE_FALSE(response->Wait(std::chrono::milliseconds(0)));
+	copy.reset();
+	auto result = response->Wait(std::chrono::milliseconds(0));
+	REQUIRE(result);
+	REQUIRE(result->status == 503);
+	REQUIRE(result->body.empty());
+
+	response = std::make_shared<HttpPendingResponse>();
+	handle = std::make_shared<HttpResponseHandle>(response);
+	handle->SetFallbackStatus(404);
+	handle.reset();
+	result = response->Wait(std::chrono::milliseconds(0));
+	REQUIRE(result);
+	REQUIRE(result->status == 404);
+}
+
+TEST_CASE("Responses set via the handle are kept", "[http-pending-response]")
+{
+	auto response = std::make_shared<HttpPendingResponse>();
+	auto handle = std::make_shared<HttpResponseHandle>(response);
+	handle->Set(409, "");
+	handle.reset();
+	auto result = response->Wait(std::chrono::milliseconds(0));
+	REQUIRE(result);
+	REQUIRE(result->status == 409);
+}
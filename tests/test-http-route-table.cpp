@@ -0,0 +1,208 @@
+#include "catch.hpp"
+
+#include <http-route-table.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using advss::HttpRouteTable;
+
+static std::vector<size_t> getIds(const std::vector<HttpRouteTable::Match> &m)
+{
+	std::vector<size_t> ids;
+	for (const auto &match : m) {
+		ids.emplace_back(match.id);
+	}
+	return ids;
+}
+
+TEST_CASE("Literal routes", "[http-route-table]")
+{
+	HttpRouteTable table;
+	const auto root = table.Add("GET", "/");
+	const auto users = table.Add("GET", "/users");
+	const auto anyMethod = table.Add("", "/users");
+	const auto post = table.Add("POST", "/users");
+	REQUIRE(table.Size() == 4);
+
+	REQUIRE(getIds(table.Find("GET", "/")) == std::vector<size_t>{root});
+	REQUIRE(getIds(table.Find("GET", "/users")) ==
+		std::vector<size_t>{users, anyMethod});
+	REQUIRE(getIds(table.Find("POST", "/users")) ==
+		std::vector<size_t>{anyMethod, post});
+	REQUIRE(getIds(table.Find("PUT", "/users")) ==
+		std::vector<size_t>{anyMethod});
+
+	// Paths have to match exactly
+	REQUIRE(table.Find("GET", "/users/").empty());
+	REQUIRE(table.Find("GET", "/Users").empty());
+	REQUIRE(table.Find("GET", "/users/1").empty());
+	REQUIRE(table.Find("GET", "").empty());
+
+	table.Remove(anyMethod);
+	REQUIRE(getIds(table.Find("PUT", "/users")).empty());
+	REQUIRE(getIds(table.Find("GET", "/users")) ==
+		std::vector<size_t>{users});
+
+	table.Clear();
+	REQUIRE(table.Size() == 0);
+	REQUIRE(table.Find("GET", "/").empty());
+}
+
+TEST_CASE("Routes with parameters", "[http-route-table]")
+{
+	HttpRouteTable table;
+	const auto user = table.Add("GET", "/users/{id}");
+	const auto userName = table.Add("GET", "/users/{id}/name");
+	const auto me = table.Add("GET", "/users/me");
+	const auto other = table.Add("GET", "/users/{user}");
+	const auto nested = table.Add("", "/{a}/{b}/{c}");
+
+	auto matches = table.Find("GET", "/users/42");
+	REQUIRE(getIds(matches) == std::vector<size_t>{user, other});
+	REQUIRE(matches[0].parameters ==
+		HttpRouteTable::Parameters{{"id", "42"}});
+	REQUIRE(matches[1].parameters ==
+		HttpRouteTable::Parameters{{"user", "42"}});
+
+	matches = table.Find("GET", "/users/me");
+	REQUIRE(getIds(matches) == std::vector<size_t>{user, me, other});
+	REQUIRE(matches[1].parameters.empty());
+
+	matches = table.Find("GET", "/users/42/name");
+	REQUIRE(getIds(matches) == std::vector<size_t>{userName, nested});
+	REQUIRE(matches[0].parameters ==
+		HttpRouteTable::Parameters{{"id", "42"}});
+	REQUIRE(matches[1].parameters ==
+		HttpRouteTable::Parameters{
+			{"a", "users"}, {"b", "42"}, {"c", "name"}});
+
+	// Parameters match empty segments as well
+	REQUIRE(getIds(table.Find("GET", "/users/")) ==
+		std::vector<size_t>{user, other});
+	REQUIRE(table.Find("GET", "/users/42/name/x").empty());
+}
+
+TEST_CASE("Routes with parameters disabled", "[http-route-table]")
+{
+	HttpRouteTable table;
+	const auto literal = table.Add("GET", "/users/{id}", false);
+	const auto parameter = table.Add("GET", "/users/{id}");
+
+	REQUIRE(getIds(table.Find("GET", "/users/42")) ==
+		std::vector<size_t>{parameter});
+	auto matches = table.Find("GET", "/users/{id}");
+	REQUIRE(getIds(matches) == std::vector<size_t>{literal, parameter});
+	REQUIRE(matches[0].parameters.empty());
+	REQUIRE(matches[1].parameters ==
+		HttpRouteTable::Parameters{{"id", "{id}"}});
+}
+
+TEST_CASE("Match single path template", "[http-route-table]")
+{
+	HttpRouteTable::Parameters parameters;
+	REQUIRE(HttpRouteTable::MatchPath("/a/b", "/a/b"));
+	REQUIRE_FALSE(HttpRouteTable::MatchPath("/a/b", "/a/c"));
+	REQUIRE_FALSE(HttpRouteTable::MatchPath("/a/b", "/a/b/"));
+	REQUIRE(HttpRouteTable::MatchPath("/a/{x}/{y}", "/a/1/2",
+					  &parameters));
+	REQUIRE(parameters == HttpRouteTable::Parameters{{"x", "1"},
+							 {"y", "2"}});
+	REQUIRE_FALSE(HttpRouteTable::MatchPath("/a/{x}", "/b/1", &parameters));
+	// Braces which do not enclose a whole segment are literals
+	REQUIRE(HttpRouteTable::MatchPath("/a{x}", "/a{x}"));
+	REQUIRE_FALSE(HttpRouteTable::MatchPath("/a{x}", "/a1"));
+}
+
+TEST_CASE("Path template parameter names", "[http-route-table]")
+{
+	REQUIRE(HttpRouteTable::GetParameterNames("/users").empty());
+	REQUIRE(HttpRouteTable::GetParameterNames("/{a}/x/{b}/{a}/{}") ==
+		std::vector<std::string>{"a", "b"});
+}
+
+static std::vector<std::string> createRouteTemplates(int count)
+{
+	std::vector<std::string> templates;
+	for (int i = 0; i < count; i++) {
+		switch (i % 3) {
+		case 0:
+			templates.emplace_back("/api/v1/resource" +
+					       std::to_string(i));
+			break;
+		case 1:
+			templates.emplace_back("/api/v1/resource" +
+					       std::to_string(i) + "/{id}");
+			break;
+		default:
+			templates.emplace_back("/api/v1/resource" +
+					       std::to_string(i) +
+					       "/{id}/action/{action}");
+			break;
+		}
+	}
+	return templates;
+}
+
+static std::vector<std::string> createRequestPaths(int routeCount, int count)
+{
+	std::vector<std::string> paths;
+	for (int i = 0; i < count; i++) {
+		const int route = (i * 7) % routeCount;
+		std::string path = "/api/v1/resource" + std::to_string(route);
+		if (route % 3 >= 1) {
+			path += "/" + std::to_string(i);
+		}
+		if (route % 3 == 2) {
+			path += "/action/start";
+		}
+		paths.emplace_back(path);
+	}
+	return paths;
+}
+
+TEST_CASE("HTTP route table load", "[http-route-table][.benchmark]")
+{
+	constexpr int routeCount = 500;
+	constexpr int requestCount = 5000;
+
+	HttpRouteTable table;
+	const auto templates = createRouteTemplates(routeCount);
+	for (const auto &pathTemplate : templates) {
+		table.Add("POST", pathTemplate);
+	}
+	const auto paths = createRequestPaths(routeCount, requestCount);
+
+	// One second worth of requests at 5k requests per second has to be
+	// routed in a fraction of that time
+	const auto start = std::chrono::steady_clock::now();
+	size_t matched = 0;
+	for (const auto &path : paths) {
+		matched += table.Find("POST", path).size();
+	}
+	const auto duration = std::chrono::steady_clock::now() - start;
+	REQUIRE(matched == requestCount);
+	REQUIRE(duration < std::chrono::milliseconds(100));
+
+	BENCHMARK("Route 5000 requests with route table")
+	{
+		size_t count = 0;
+		for (const auto &path : paths) {
+			count += table.Find("POST", path).size();
+		}
+		return count;
+	};
+
+	BENCHMARK("Route 5000 requests by checking each template")
+	{
+		size_t count = 0;
+		for (const auto &path : paths) {
+			for (const auto &pathTemplate : templates) {
+				count += HttpRouteTable::MatchPath(
+					pathTemplate, path);
+			}
+		}
+		return count;
+	};
+}
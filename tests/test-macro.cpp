@@ -1,7 +1,10 @@
 #include "catch.hpp"
 
 #include <macro.hpp>
+#include <macro-helpers.hpp>
 
+#include <atomic>
+#include <future>
 #include <memory>
 
 namespace {
@@ -19,13 +22,16 @@ public:
 	}
 
 	void SetValue(bool value) { _value = value; }
+	void SetPendingMessages(bool pending) { _pendingMessages = pending; }
 	bool CheckCondition() override { return _value; }
+	bool HasPendingMessages() const override { return _pendingMessages; }
 	bool Save(obs_data_t *) const override { return true; }
 	bool Load(obs_data_t *) override { return true; }
 	std::string GetId() const override { return "stub"; }
 
 private:
 	bool _value;
+	bool _pendingMessages = false;
 };
 
 class StubAction : public advss::MacroAction {
@@ -53,6 +59,34 @@ private:
 	int _performCount = 0;
 };
 
+// Blocks until the given future is ready
+class BlockingAction : public advss::MacroAction {
+public:
+	BlockingAction(advss::Macro *m, std::shared_future<void> release)
+		: MacroAction(m),
+		  _release(std::move(release))
+	{
+	}
+
+	bool PerformAction() override
+	{
+		_release.wait();
+		return true;
+	}
+
+	std::shared_ptr<MacroAction> Copy() const override
+	{
+		return std::make_shared<BlockingAction>(*this);
+	}
+
+	bool Save(obs_data_t *) const override { return true; }
+	bool Load(obs_data_t *) override { return true; }
+	std::string GetId() const override { return "blocking"; }
+
+private:
+	std::shared_future<void> _release;
+};
+
 // Helpers to wire up conditions and actions onto a macro
 std::shared_ptr<StubCondition> AddCondition(advss::Macro &m,
 					    bool initialValue = false)
@@ -414,3 +448,180 @@ TEST_CASE("GetActionTriggerMode returns the set mode", "[macro]")
 	REQUIRE(m.GetActionTriggerMode() ==
 		advss::Macro::ActionTriggerMode::ANY_CONDITION_TRIGGERED);
 }
+
+// ---------------------------------------------------------------------------
+// Custom condition check interval
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Conditions are always checked without custom interval", "[macro]")
+{
+	advss::Macro m("test");
+	const auto now = std::chrono::high_resolution_clock::now();
+	m.ScheduleNextConditionCheck(now);
+	REQUIRE(m.ConditionsShouldBeChecked(now));
+}
+
+TEST_CASE("Custom interval delays the next condition check", "[macro]")
+{
+	advss::Macro m("test");
+	m.SetCustomConditionCheckIntervalEnabled(true);
+	m.SetCustomConditionCheckInterval(0.1);
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	REQUIRE(m.ConditionsShouldBeChecked(now));
+
+	m.ScheduleNextConditionCheck(now);
+	REQUIRE(m.NextConditionCheckTime() ==
+		now + std::chrono::milliseconds(100));
+	REQUIRE_FALSE(m.ConditionsShouldBeChecked(now));
+	REQUIRE_FALSE(m.ConditionsShouldBeChecked(
+		now + std::chrono::milliseconds(50)));
+	REQUIRE(m.ConditionsShouldBeChecked(now +
+					    std::chrono::milliseconds(100)));
+}
+
+TEST_CASE("ResetTimers makes conditions due immediately", "[macro]")
+{
+	advss::Macro m("test");
+	m.SetCustomConditionCheckIntervalEnabled(true);
+	m.SetCustomConditionCheckInterval(10.0);
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	m.ScheduleNextConditionCheck(now);
+	REQUIRE_FALSE(m.ConditionsShouldBeChecked(now));
+
+	m.ResetTimers();
+	REQUIRE(m.ConditionsShouldBeChecked(now));
+}
+
+// ---------------------------------------------------------------------------
+// Actions done callbacks
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Actions done callbacks are called once the actions ran", "[macro]")
+{
+	advss::Macro m("test");
+	auto action = AddAction(m);
+
+	int calls = 0;
+	bool actionsRun = false;
+	m.AddActionsDoneCallback([&](bool run) {
+		calls++;
+		actionsRun = run;
+	});
+	m.PerformActions(true);
+	REQUIRE(action->PerformCount() == 1);
+	REQUIRE(calls == 1);
+	REQUIRE(actionsRun);
+
+	// Callbacks only refer to the next action run
+	m.PerformActions(true);
+	REQUIRE(calls == 1);
+}
+
+TEST_CASE("Actions done callbacks are notified of skipped runs", "[macro]")
+{
+	advss::Macro m("test");
+	AddAction(m);
+
+	int calls = 0;
+	bool actionsRun = true;
+	m.AddActionsDoneCallback([&](bool run) {
+		calls++;
+		actionsRun = run;
+	});
+	m.NotifyActionsSkipped();
+	REQUIRE(calls == 1);
+	REQUIRE_FALSE(actionsRun);
+
+	m.PerformActions(true);
+	REQUIRE(calls == 1);
+}
+
+TEST_CASE("CheckMacros notifies callbacks of macros which do not run",
+	  "[macro]")
+{
+	auto &macros = advss::GetTopLevelMacros();
+	macros.clear();
+	auto m = std::make_shared<advss::Macro>("test");
+	macros.emplace_back(m);
+	AddCondition(*m, false);
+	AddAction(*m);
+
+	int calls = 0;
+	bool actionsRun = true;
+	m->AddActionsDoneCallback([&](bool run) {
+		calls++;
+		actionsRun = run;
+	});
+
+	// No macro matched, so no actions are run at all
+	REQUIRE_FALSE(advss::CheckMacros());
+	REQUIRE(calls == 1);
+	REQUIRE_FALSE(actionsRun);
+
+	macros.clear();
+}
+
+TEST_CASE("Actions done callbacks are notified if the macro is still running",
+	  "[macro]")
+{
+	advss::Macro m("test");
+	m.SetRunInParallel(true);
+	std::promise<void> release;
+	m.Actions().push_back(std::make_shared<BlockingAction>(
+		&m, release.get_future().share()));
+
+	std::promise<bool> firstRun;
+	m.AddActionsDoneCallback(
+		[&firstRun](bool run) { firstRun.set_value(run); });
+	m.PerformActions(true);
+
+	std::atomic_int skippedCalls{0};
+	m.AddActionsDoneCallback([&skippedCalls](bool run) {
+		if (!run) {
+			skippedCalls++;
+		}
+	});
+	m.PerformActions(true);
+	const int skippedWhileRunning = skippedCalls;
+
+	release.set_value();
+	REQUIRE(skippedWhileRunning == 1);
+	auto firstRunResult = firstRun.get_future();
+	REQUIRE(firstRunResult.wait_for(std::chrono::seconds(5)) ==
+		std::future_status::ready);
+	REQUIRE(firstRunResult.get());
+	m.Stop();
+}
+
+// ---------------------------------------------------------------------------
+// Partial checks
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Only macros with pending messages are checked on wakeup",
+	  "[macro]")
+{
+	auto &macros = advss::GetTopLevelMacros();
+	macros.clear();
+	auto pending = std::make_shared<advss::Macro>("pending");
+	auto idle = std::make_shared<advss::Macro>("idle");
+	macros.emplace_back(pending);
+	macros.emplace_back(idle);
+	AddCondition(*pending, true)->SetPendingMessages(true);
+	AddCondition(*idle, true);
+	auto pendingAction = AddAction(*pending);
+	auto idleAction = AddAction(*idle);
+	pending->SetActionTriggerMode(advss::Macro::ActionTriggerMode::ALWAYS);
+	idle->SetActionTriggerMode(advss::Macro::ActionTriggerMode::ALWAYS);
+
+	advss::CheckAndRunScheduledMacros(false);
+	REQUIRE(pendingAction->PerformCount() == 0);
+	REQUIRE(idleAction->PerformCount() == 0);
+
+	advss::CheckAndRunScheduledMacros(true);
+	REQUIRE(pendingAction->PerformCount() == 1);
+	REQUIRE(idleAction->PerformCount() == 0);
+
+	macros.clear();
+}
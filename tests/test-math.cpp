@@ -1,6 +1,9 @@
 #include "catch.hpp"
 
 #include <math-helpers.hpp>
+#include <variable-string.hpp>
+
+#include <obs.hpp>
 
 TEST_CASE("Expressions are evaluated successfully", "[math-helpers]")
 {
@@ -94,6 +97,120 @@ TEST_CASE("Invalid expressions are not evaluated", "[math-helpers]")
 	REQUIRE(doubleValuePtr == nullptr);
 }
 
+static std::shared_ptr<advss::Variable>
+addVariable(const std::string &name, const std::string &value)
+{
+	auto variable = std::make_shared<advss::Variable>();
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "name", name.c_str());
+	variable->Load(data);
+	variable->SetValue(value);
+	advss::GetVariables().emplace_back(variable);
+	return variable;
+}
+
+static double evalWithVariables(const advss::StringVariable &expression)
+{
+	auto result = advss::EvalMathExpressionWithVariables(expression);
+	auto *doubleValuePtr = std::get_if<double>(&result);
+	REQUIRE(doubleValuePtr != nullptr);
+	return *doubleValuePtr;
+}
+
+TEST_CASE("Expressions with variables are evaluated", "[math-helpers]")
+{
+	advss::GetVariables().clear();
+	auto a = addVariable("a", "1");
+	auto b = addVariable("b", "text");
+
+	advss::StringVariable expression = "${a} + 1";
+	REQUIRE(evalWithVariables(expression) == 2.0);
+	a->SetValue(5);
+	REQUIRE(evalWithVariables(expression) == 6.0);
+
+	// Variables next to other operands are substituted as text
+	expression = "1${a}";
+	REQUIRE(evalWithVariables(expression) == 15.0);
+
+	// As are non-numeric values
+	expression = "${a} * ${b}";
+	auto result = advss::EvalMathExpressionWithVariables(expression);
+	REQUIRE(std::get_if<double>(&result) == nullptr);
+	b->SetValue("2 + 1");
+	REQUIRE(evalWithVariables(expression) == 11.0);
+	b->SetValue(3);
+	REQUIRE(evalWithVariables(expression) == 15.0);
+
+	// Negative values are substituted as text, so the result does not
+	// depend on whether other variables of the expression can be bound
+	a->SetValue("-2");
+	b->SetValue("2");
+	expression = "${a}^2";
+	REQUIRE(evalWithVariables(expression) == -4.0);
+	expression = "${a}^2 + 1${b}";
+	REQUIRE(evalWithVariables(expression) == 8.0);
+	a->SetValue("2");
+	expression = "${a}^2";
+	REQUIRE(evalWithVariables(expression) == 4.0);
+
+	expression = "${c} + 1";
+	result = advss::EvalMathExpressionWithVariables(expression);
+	REQUIRE(std::get_if<double>(&result) == nullptr);
+	addVariable("c", "2");
+	REQUIRE(evalWithVariables(expression) == 3.0);
+
+	advss::GetVariables().clear();
+}
+
+TEST_CASE("Expressions with variables use the active variable context",
+	  "[math-helpers]")
+{
+	advss::GetVariables().clear();
+	auto a = addVariable("a", "1");
+	advss::StringVariable expression = "${a} + 1";
+	REQUIRE(evalWithVariables(expression) == 2.0);
+
+	advss::VariableContext first = {{"a", "10"}};
+	advss::VariableContext second = {{"a", "20"}};
+	advss::SetActiveVariableContext(&first);
+	REQUIRE(evalWithVariables(expression) == 11.0);
+	advss::SetActiveVariableContext(&second);
+	REQUIRE(evalWithVariables(expression) == 21.0);
+	first["a"] = "30";
+	advss::SetActiveVariableContext(&first);
+	REQUIRE(evalWithVariables(expression) == 31.0);
+	advss::SetActiveVariableContext(nullptr);
+
+	// Values of a context do not replace the cached value of the variable
+	REQUIRE(evalWithVariables(expression) == 2.0);
+
+	advss::GetVariables().clear();
+}
+
+TEST_CASE("Expressions with variables benchmark",
+	  "[math-helpers][.benchmark]")
+{
+	advss::GetVariables().clear();
+	auto value = addVariable("value", "0");
+	addVariable("average", "0");
+	advss::StringVariable expression = "${average} * 0.9 + ${value} * 0.1";
+
+	int count = 0;
+	BENCHMARK("EvalMathExpression")
+	{
+		value->SetValue(++count);
+		return advss::EvalMathExpression(expression);
+	};
+
+	BENCHMARK("EvalMathExpressionWithVariables")
+	{
+		value->SetValue(++count);
+		return advss::EvalMathExpressionWithVariables(expression);
+	};
+
+	advss::GetVariables().clear();
+}
+
 TEST_CASE("IsValidNumber", "[math-helpers]")
 {
 	REQUIRE(advss::IsValidNumber("1"));
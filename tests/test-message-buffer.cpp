@@ -0,0 +1,329 @@
+#include "catch.hpp"
+
+#include <message-buffer.hpp>
+#include <message-dispatcher.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using Buffer = advss::MessageBuffer<int>;
+using Policy = Buffer::OverflowPolicy;
+
+static std::vector<int> consumeAll(Buffer &buffer)
+{
+	std::vector<int> result;
+	for (const auto &message : buffer.ConsumeAll()) {
+		result.emplace_back(*message);
+	}
+	return result;
+}
+
+TEST_CASE("Messages are consumed in order", "[message-buffer]")
+{
+	Buffer buffer(8);
+	REQUIRE(buffer.Empty());
+	REQUIRE_FALSE(buffer.ConsumeMessage());
+
+	for (int i = 0; i < 5; i++) {
+		buffer.AppendMessage(i);
+	}
+	REQUIRE_FALSE(buffer.Empty());
+	for (int i = 0; i < 5; i++) {
+		auto message = buffer.ConsumeMessage();
+		REQUIRE(message);
+		REQUIRE(*message == i);
+	}
+	REQUIRE(buffer.Empty());
+	REQUIRE(buffer.GetDroppedCount() == 0);
+
+	// Wrap around the ring a few times
+	for (int i = 0; i < 100; i++) {
+		buffer.AppendMessage(i);
+		buffer.AppendMessage(i + 1);
+		REQUIRE(*buffer.ConsumeMessage() == i);
+		REQUIRE(*buffer.ConsumeMessage() == i + 1);
+	}
+	REQUIRE(buffer.Empty());
+}
+
+TEST_CASE("Capacity", "[message-buffer]")
+{
+	REQUIRE(Buffer().Capacity() == Buffer::defaultCapacity);
+	REQUIRE(Buffer(8).Capacity() == 8);
+	REQUIRE(Buffer(5).Capacity() == 8);
+	REQUIRE(Buffer(0).Capacity() == 2);
+}
+
+TEST_CASE("Overflow policies", "[message-buffer]")
+{
+	SECTION("Drop oldest")
+	{
+		Buffer buffer(4, Policy::DROP_OLDEST);
+		for (int i = 0; i < 10; i++) {
+			buffer.AppendMessage(i);
+		}
+		REQUIRE(buffer.GetDroppedCount() == 6);
+		REQUIRE(consumeAll(buffer) == std::vector<int>{6, 7, 8, 9});
+	}
+	SECTION("Drop newest")
+	{
+		Buffer buffer(4, Policy::DROP_NEWEST);
+		for (int i = 0; i < 10; i++) {
+			buffer.AppendMessage(i);
+		}
+		REQUIRE(buffer.GetDroppedCount() == 6);
+		REQUIRE(consumeAll(buffer) == std::vector<int>{0, 1, 2, 3});
+	}
+	SECTION("Block")
+	{
+		Buffer buffer(2, Policy::BLOCK, std::chrono::milliseconds(10));
+		buffer.AppendMessage(0);
+		buffer.AppendMessage(1);
+
+		// Gives up as nobody consumes the messages
+		buffer.AppendMessage(2);
+		REQUIRE(buffer.GetDroppedCount() == 1);
+		REQUIRE(consumeAll(buffer) == std::vector<int>{0, 1});
+	}
+}
+
+TEST_CASE("Blocked producers wait for the consumer", "[message-buffer]")
+{
+	Buffer buffer(2, Policy::BLOCK, std::chrono::milliseconds(10000));
+	std::thread producer([&buffer]() {
+		for (int i = 0; i < 100; i++) {
+			buffer.AppendMessage(i);
+		}
+	});
+
+	std::vector<int> messages;
+	while (messages.size() < 100) {
+		if (auto message = buffer.ConsumeMessage()) {
+			messages.emplace_back(*message);
+		}
+	}
+	producer.join();
+
+	REQUIRE(buffer.GetDroppedCount() == 0);
+	for (int i = 0; i < 100; i++) {
+		REQUIRE(messages[i] == i);
+	}
+}
+
+TEST_CASE("Messages are moved into the buffer", "[message-buffer]")
+{
+	advss::MessageBuffer<std::string> buffer(4);
+	std::string message(1000, 'a');
+	buffer.AppendMessage(std::move(message));
+	buffer.AppendMessage("b");
+
+	auto messages = buffer.ConsumeAll();
+	REQUIRE(messages.size() == 2);
+	REQUIRE(*messages[0] == std::string(1000, 'a'));
+	REQUIRE(*messages[1] == "b");
+	REQUIRE(buffer.Empty());
+
+	buffer.AppendMessage("c");
+	buffer.Clear();
+	REQUIRE(buffer.Empty());
+	REQUIRE(buffer.ConsumeAll().empty());
+}
+
+TEST_CASE("Concurrent producers", "[message-buffer]")
+{
+	constexpr int producerCount = 4;
+	constexpr int messageCount = 10000;
+
+	SECTION("No messages are lost or duplicated")
+	{
+		Buffer buffer(64, Policy::BLOCK,
+			      std::chrono::milliseconds(10000));
+		std::vector<std::thread> producers;
+		for (int p = 0; p < producerCount; p++) {
+			producers.emplace_back([&buffer, p]() {
+				for (int i = 0; i < messageCount; i++) {
+					buffer.AppendMessage(p * messageCount +
+							     i);
+				}
+			});
+		}
+
+		std::vector<int> lastFromProducer(producerCount, -1);
+		int received = 0;
+		while (received < producerCount * messageCount) {
+			auto message = buffer.ConsumeMessage();
+			if (!message) {
+				continue;
+			}
+			const int producer = *message / messageCount;
+			const int index = *message % messageCount;
+			// Messages of a single producer keep their order
+			REQUIRE(index > lastFromProducer[producer]);
+			lastFromProducer[producer] = index;
+			received++;
+		}
+		for (auto &producer : producers) {
+			producer.join();
+		}
+		REQUIRE(buffer.Empty());
+		REQUIRE(buffer.GetDroppedCount() == 0);
+	}
+	SECTION("Drop oldest stays bounded")
+	{
+		Buffer buffer(16, Policy::DROP_OLDEST);
+		std::vector<std::thread> producers;
+		for (int p = 0; p < producerCount; p++) {
+			producers.emplace_back([&buffer]() {
+				for (int i = 0; i < messageCount; i++) {
+					buffer.AppendMessage(i);
+				}
+			});
+		}
+		size_t received = 0;
+		for (int i = 0; i < 1000; i++) {
+			received += buffer.ConsumeAll().size();
+		}
+		for (auto &producer : producers) {
+			producer.join();
+		}
+		const auto remaining = buffer.ConsumeAll().size();
+		REQUIRE(remaining <= buffer.Capacity());
+		REQUIRE(received + remaining + buffer.GetDroppedCount() ==
+			producerCount * messageCount);
+	}
+}
+
+TEST_CASE("Dispatcher buffer settings", "[message-buffer]")
+{
+	advss::MessageDispatcher<int> dispatcher;
+	auto buffer = dispatcher.RegisterClient(4, Policy::DROP_NEWEST);
+	REQUIRE(buffer->Capacity() == 4);
+	REQUIRE(buffer->GetOverflowPolicy() == Policy::DROP_NEWEST);
+
+	for (int i = 0; i < 10; i++) {
+		dispatcher.DispatchMessage(i);
+	}
+	REQUIRE(consumeAll(*buffer) == std::vector<int>{0, 1, 2, 3});
+	REQUIRE(buffer->GetDroppedCount() == 6);
+
+	auto defaultBuffer = dispatcher.RegisterClient();
+	REQUIRE(defaultBuffer->Capacity() == Buffer::defaultCapacity);
+	REQUIRE(defaultBuffer->GetOverflowPolicy() == Policy::DROP_OLDEST);
+}
+
+TEST_CASE("Dispatched messages are shared by all clients", "[message-buffer]")
+{
+	advss::MessageDispatcher<std::string> dispatcher;
+	auto first = dispatcher.RegisterClient();
+	auto second = dispatcher.RegisterClient();
+	auto expired = dispatcher.RegisterClient();
+	expired.reset();
+
+	dispatcher.DispatchMessage(std::string(1000, 'a'));
+	auto firstMessage = first->ConsumeMessage();
+	auto secondMessage = second->ConsumeMessage();
+	REQUIRE(firstMessage);
+	REQUIRE(*firstMessage == std::string(1000, 'a'));
+	REQUIRE(firstMessage == secondMessage);
+	REQUIRE(firstMessage.use_count() == 2);
+
+	// Clients expiring during dispatch do not affect the remaining ones
+	first.reset();
+	const std::string message = "b";
+	dispatcher.DispatchMessage(message);
+	dispatcher.DispatchMessage(message);
+	auto messages = second->ConsumeAll();
+	REQUIRE(messages.size() == 2);
+	REQUIRE(*messages[0] == "b");
+	REQUIRE(*messages[1] == "b");
+}
+
+TEST_CASE("Dispatcher client filters", "[message-buffer]")
+{
+	advss::MessageDispatcher<int> dispatcher;
+	auto even = dispatcher.RegisterClient(
+		[](const int &value) { return value % 2 == 0; });
+	auto small = dispatcher.RegisterClient(
+		[](const int &value) { return value < 3; }, 2,
+		Policy::DROP_NEWEST);
+	auto all = dispatcher.RegisterClient();
+	REQUIRE(small->Capacity() == 2);
+
+	for (int i = 0; i < 6; i++) {
+		dispatcher.DispatchMessage(i);
+	}
+	REQUIRE(consumeAll(*even) == std::vector<int>{0, 2, 4});
+	REQUIRE(consumeAll(*small) == std::vector<int>{0, 1});
+	REQUIRE(small->GetDroppedCount() == 1);
+	REQUIRE(consumeAll(*all) == std::vector<int>{0, 1, 2, 3, 4, 5});
+}
+
+TEST_CASE("Dispatcher client filters can be replaced", "[message-buffer]")
+{
+	advss::MessageDispatcher<int> dispatcher;
+	advss::ReplaceableMessageFilter<int> filter;
+	auto buffer = dispatcher.RegisterClient(filter.Get());
+
+	dispatcher.DispatchMessage(1);
+	filter.Set([](const int &value) { return value % 2 == 0; });
+	for (int i = 2; i < 6; i++) {
+		dispatcher.DispatchMessage(i);
+	}
+
+	// Messages buffered before the filter was replaced are kept
+	REQUIRE(consumeAll(*buffer) == std::vector<int>{1, 2, 4});
+}
+
+TEST_CASE("Message buffer benchmark", "[message-buffer][.benchmark]")
+{
+	Buffer buffer(1024);
+	BENCHMARK("Append and consume 1000 messages")
+	{
+		for (int i = 0; i < 1000; i++) {
+			buffer.AppendMessage(i);
+		}
+		int sum = 0;
+		while (auto message = buffer.ConsumeMessage()) {
+			sum += *message;
+		}
+		return sum;
+	};
+
+	BENCHMARK("Append 1000 and consume all")
+	{
+		for (int i = 0; i < 1000; i++) {
+			buffer.AppendMessage(i);
+		}
+		return buffer.ConsumeAll().size();
+	};
+
+	Buffer overflowingBuffer(64);
+	BENCHMARK("Append 1000 messages to a full buffer")
+	{
+		for (int i = 0; i < 1000; i++) {
+			overflowingBuffer.AppendMessage(i);
+		}
+		return overflowingBuffer.GetDroppedCount();
+	};
+}
+
+TEST_CASE("Message dispatcher benchmark", "[message-buffer][.benchmark]")
+{
+	advss::MessageDispatcher<std::string> dispatcher;
+	std::vector<std::shared_ptr<advss::MessageBuffer<std::string>>> clients;
+	for (int i = 0; i < 200; i++) {
+		clients.emplace_back(dispatcher.RegisterClient());
+	}
+	const std::string message(10 * 1024, 'a');
+
+	BENCHMARK("Dispatch 10 KB message to 200 clients")
+	{
+		dispatcher.DispatchMessage(message);
+		size_t size = 0;
+		for (const auto &client : clients) {
+			size += client->ConsumeMessage()->size();
+		}
+		return size;
+	};
+}
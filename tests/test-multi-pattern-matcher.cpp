@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include <multi-pattern-matcher.hpp>
+
+static std::string getLiteral(const std::string &pattern,
+			      QRegularExpression::PatternOptions options =
+				      QRegularExpression::NoPatternOption)
+{
+	auto regex = advss::RegexConfig::PartialMatchRegexConfig(true);
+	regex.SetPatternOptions(options);
+	return advss::MultiPatternMatcher::GetRequiredLiteral(pattern, regex);
+}
+
+TEST_CASE("GetRequiredLiteral", "[multi-pattern-matcher]")
+{
+	REQUIRE(getLiteral("hello") == "hello");
+	REQUIRE(getLiteral("Hello") == "hello");
+	REQUIRE(getLiteral("!roll \\d+") == "!roll ");
+	REQUIRE(getLiteral("ab*cdef") == "cdef");
+	REQUIRE(getLiteral("abc+de") == "abc");
+	REQUIRE(getLiteral("a(bc)*defg") == "defg");
+	REQUIRE(getLiteral("ab[cd]*e") == "ab");
+	REQUIRE(getLiteral("x{2,3}yz") == "yz");
+	REQUIRE(getLiteral("xy{a}z") == "xy{a}z");
+	REQUIRE(getLiteral("\\x41bc") == "bc");
+	REQUIRE(getLiteral("\\.com") == ".com");
+	REQUIRE(getLiteral("hällo") == "hällo");
+	REQUIRE(getLiteral(".*").empty());
+	REQUIRE(getLiteral("a|b").empty());
+	REQUIRE(getLiteral("(?i)abc").empty());
+
+	const auto caseInsensitive = QRegularExpression::CaseInsensitiveOption;
+	REQUIRE(getLiteral("ask me", caseInsensitive) == " me");
+	REQUIRE(getLiteral("hällo", caseInsensitive) == "llo");
+
+	advss::RegexConfig disabled(false);
+	REQUIRE(advss::MultiPatternMatcher::GetRequiredLiteral(
+			"a.*", disabled) == "a.*");
+}
+
+TEST_CASE("MultiPatternMatcher", "[multi-pattern-matcher]")
+{
+	const std::vector<std::pair<std::string, advss::RegexConfig>>
+		patterns = {
+			{"hello", advss::RegexConfig(false)},
+			{"hello", advss::RegexConfig(true)},
+			{"hello", advss::RegexConfig::PartialMatchRegexConfig(
+					  true)},
+			{"!roll \\d+", advss::RegexConfig(true)},
+			{"kappa", advss::RegexConfig::PartialMatchRegexConfig(
+					  true)},
+			{".*", advss::RegexConfig(true)},
+			{"(", advss::RegexConfig(true)},
+		};
+
+	advss::MultiPatternMatcher matcher;
+	for (const auto &[pattern, regex] : patterns) {
+		matcher.Add(pattern, regex);
+	}
+	REQUIRE(matcher.Size() == patterns.size());
+
+	const std::vector<std::string> texts = {
+		"", "hello", "hello world", "HELLO", "!roll 20", "!roll",
+		"Kappa Kappa", "say hello to kappa"};
+	for (const auto &text : texts) {
+		std::vector<size_t> expected;
+		for (size_t id = 0; id < patterns.size(); id++) {
+			const auto &[pattern, regex] = patterns[id];
+			const bool matches = regex.Enabled()
+						     ? regex.Matches(text,
+								     pattern)
+						     : text == pattern;
+			if (matches) {
+				expected.emplace_back(id);
+			}
+		}
+		REQUIRE(matcher.Match(text) == expected);
+	}
+
+	matcher.Remove(5);
+	REQUIRE(matcher.Match("hello") == std::vector<size_t>{0, 1, 2});
+	matcher.Clear();
+	REQUIRE(matcher.Match("hello").empty());
+}
+
+TEST_CASE("MultiPatternMatcher benchmark",
+	  "[multi-pattern-matcher][.benchmark]")
+{
+	// Each condition has its own RegexConfig
+	std::vector<std::pair<std::string, advss::RegexConfig>> patterns;
+	advss::MultiPatternMatcher matcher;
+	auto regex = advss::RegexConfig::PartialMatchRegexConfig(true);
+	regex.SetPatternOptions(QRegularExpression::CaseInsensitiveOption);
+	for (int i = 0; i < 400; i++) {
+		const auto pattern = "!command" + std::to_string(i) + "\\b";
+		patterns.emplace_back(pattern, regex);
+		matcher.Add(pattern, regex);
+	}
+	const std::string message =
+		"just a regular chat message which mentions !command42 once";
+
+	BENCHMARK("Individual patterns")
+	{
+		int matches = 0;
+		for (const auto &[pattern, config] : patterns) {
+			matches += config.Matches(message, pattern);
+		}
+		return matches;
+	};
+
+	BENCHMARK("MultiPatternMatcher")
+	{
+		return matcher.Match(message).size();
+	};
+}
@@ -0,0 +1,194 @@
+#include "catch.hpp"
+
+#include <opencv-helpers.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Fills the image from left to right with vertical stripes of the given
+// colors, each covering the given share of the image width.
+// Each pixel is offset by a random amount of up to "noise".
+QImage createSampleImage(int width, int height,
+			 const std::vector<std::pair<QColor, double>> &stripes,
+			 int noise = 10)
+{
+	QImage image(width, height, QImage::Format_RGBA8888);
+	image.fill(Qt::black);
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> offset(-noise, noise);
+	auto channel = [&](int value) {
+		value = std::clamp(value + offset(rng), 0, 255);
+		return static_cast<uchar>(value);
+	};
+
+	int start = 0;
+	double covered = 0.;
+	for (const auto &[color, share] : stripes) {
+		covered += share;
+		const int end = std::min(width, int(covered * width + 0.5));
+		for (int y = 0; y < height; y++) {
+			uchar *pixel = image.scanLine(y) + start * 4;
+			for (int x = start; x < end; x++, pixel += 4) {
+				pixel[0] = channel(color.red());
+				pixel[1] = channel(color.green());
+				pixel[2] = channel(color.blue());
+				pixel[3] = 255;
+			}
+		}
+		start = end;
+	}
+	return image;
+}
+
+bool colorsAreClose(const QColor &a, const QColor &b, int maxDiff = 8)
+{
+	return std::abs(a.red() - b.red()) <= maxDiff &&
+	       std::abs(a.green() - b.green()) <= maxDiff &&
+	       std::abs(a.blue() - b.blue()) <= maxDiff;
+}
+
+const QColor red(200, 30, 30);
+const QColor green(30, 180, 40);
+const QColor blue(20, 40, 220);
+
+} // namespace
+
+TEST_CASE("GetDominantColor", "[opencv-helpers]")
+{
+	REQUIRE_FALSE(advss::GetDominantColor(QImage(), 3).isValid());
+
+	// Fewer pixels than clusters
+	auto tiny = createSampleImage(2, 1, {{red, 1.}}, 0);
+	REQUIRE(colorsAreClose(advss::GetDominantColor(tiny, 3), red));
+
+	const std::vector<std::vector<std::pair<QColor, double>>> samples = {
+		{{red, 0.6}, {blue, 0.3}, {green, 0.1}},
+		{{blue, 0.2}, {green, 0.5}, {red, 0.3}},
+		{{red, 0.2}, {green, 0.2}, {blue, 0.25}, {red, 0.15},
+		 {green, 0.2}},
+	};
+	const std::vector<QColor> expected = {red, green, green};
+
+	for (size_t i = 0; i < samples.size(); i++) {
+		const auto image = createSampleImage(480, 270, samples[i]);
+		const auto full = advss::GetDominantColor(image, 3, 0);
+		const auto subsampled = advss::GetDominantColor(image, 3, 1000);
+		REQUIRE(colorsAreClose(full, expected[i]));
+		REQUIRE(colorsAreClose(subsampled, full));
+	}
+}
+
+TEST_CASE("Dominant color benchmark", "[opencv-helpers][.benchmark]")
+{
+	const auto large = createSampleImage(
+		3840, 2160, {{red, 0.6}, {blue, 0.3}, {green, 0.1}});
+	REQUIRE(colorsAreClose(advss::GetDominantColor(large, 3, 10000), red));
+
+	BENCHMARK("Dominant color of 4K image using 10000 samples")
+	{
+		return advss::GetDominantColor(large, 3, 10000);
+	};
+}
+
+TEST_CASE("ContainsPixelsInColorRange", "[opencv-helpers]")
+{
+	REQUIRE_FALSE(
+		advss::ContainsPixelsInColorRange(QImage(), red, 0.1, 0.));
+
+	const auto image = createSampleImage(1920, 1080,
+					     {{red, 0.6}, {blue, 0.4}}, 5);
+	REQUIRE(advss::ContainsPixelsInColorRange(image, red, 0.05, 0.55));
+	REQUIRE_FALSE(
+		advss::ContainsPixelsInColorRange(image, red, 0.05, 0.65));
+	REQUIRE(advss::ContainsPixelsInColorRange(image, blue, 0.05, 0.35));
+	REQUIRE_FALSE(
+		advss::ContainsPixelsInColorRange(image, green, 0.05, 0.01));
+	// The noise exceeds the allowed deviation
+	REQUIRE_FALSE(
+		advss::ContainsPixelsInColorRange(image, red, 0., 0.55));
+}
+
+TEST_CASE("PreprocessForOCR", "[opencv-helpers]")
+{
+	REQUIRE(advss::PreprocessForOCR(QImage(), red, 0.1).empty());
+
+	// Pixels matching the text color are black, all others are white
+	const auto image = createSampleImage(1920, 1080,
+					     {{red, 0.6}, {blue, 0.4}}, 5);
+	const auto result = advss::PreprocessForOCR(image, red, 0.05);
+	REQUIRE(result.cols == 1920);
+	REQUIRE(result.rows == 1080);
+	REQUIRE(cv::countNonZero(result) == (1920 - 1152) * 1080);
+
+	// Small images are scaled up
+	const auto small = createSampleImage(100, 50, {{red, 1.}}, 0);
+	const auto scaled = advss::PreprocessForOCR(small, red, 0.05);
+	REQUIRE(scaled.cols == 600);
+	REQUIRE(scaled.rows == 300);
+	REQUIRE(cv::countNonZero(scaled) == 0);
+}
+
+TEST_CASE("Color range checks benchmark", "[opencv-helpers][.benchmark]")
+{
+	const std::vector<std::pair<QColor, double>> stripes = {{red, 0.6},
+								 {blue, 0.4}};
+	const auto fullHd = createSampleImage(1920, 1080, stripes, 5);
+	const auto uhd = createSampleImage(3840, 2160, stripes, 5);
+
+	// Only 40% of the pixels match, so most of the image has to be checked
+	// before the result is known
+	BENCHMARK("ContainsPixelsInColorRange 1080p")
+	{
+		return advss::ContainsPixelsInColorRange(fullHd, blue, 0.05,
+							 0.5);
+	};
+	BENCHMARK("ContainsPixelsInColorRange 4K")
+	{
+		return advss::ContainsPixelsInColorRange(uhd, blue, 0.05, 0.5);
+	};
+	BENCHMARK("PreprocessForOCR 1080p")
+	{
+		return advss::PreprocessForOCR(fullHd, red, 0.05);
+	};
+	BENCHMARK("PreprocessForOCR 4K")
+	{
+		return advss::PreprocessForOCR(uhd, red, 0.05);
+	};
+}
+
+TEST_CASE("GetAvgBrightness", "[opencv-helpers]")
+{
+	REQUIRE(advss::GetAvgBrightness(QImage()) == 0);
+
+	const auto image = createSampleImage(
+		1920, 1080,
+		{{QColor(100, 50, 0), 0.5}, {QColor(0, 0, 200), 0.5}}, 0);
+	REQUIRE(advss::GetAvgBrightness(image) == 150);
+	REQUIRE(advss::GetAvgBrightness(image, 4) == 150);
+}
+
+TEST_CASE("Brightness benchmark", "[opencv-helpers][.benchmark]")
+{
+	const std::vector<std::pair<QColor, double>> stripes = {{red, 0.6},
+								 {blue, 0.4}};
+	const auto fullHd = createSampleImage(1920, 1080, stripes, 5);
+	const auto uhd = createSampleImage(3840, 2160, stripes, 5);
+
+	BENCHMARK("GetAvgBrightness 1080p")
+	{
+		return advss::GetAvgBrightness(fullHd);
+	};
+	BENCHMARK("GetAvgBrightness 4K")
+	{
+		return advss::GetAvgBrightness(uhd);
+	};
+	BENCHMARK("GetAvgBrightness 4K with a sample step of 4")
+	{
+		return advss::GetAvgBrightness(uhd, 4);
+	};
+}
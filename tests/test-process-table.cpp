@@ -0,0 +1,156 @@
+#include "catch.hpp"
+#include "process-table.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+
+using advss::ProcessTable;
+
+static void writeFile(const QString &path, const QString &content)
+{
+	QFile f(path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Text |
+		    QIODevice::Truncate)) {
+		return;
+	}
+	QTextStream(&f) << content;
+}
+
+// Creates a /proc/<pid> like entry containing the stat, comm and exe files
+static void addProcess(const QTemporaryDir &procDir, long pid,
+		       const QString &name, const QString &path,
+		       unsigned long long startTime,
+		       const QString &dirName = {})
+{
+	const QString dir =
+		procDir.filePath(dirName.isEmpty() ? QString::number(pid)
+						   : dirName);
+	QDir().mkpath(dir);
+	writeFile(dir + "/stat",
+		  QString("%1 (%2) S 1 1 1 0 -1 4194304 100 0 0 0 1 1 0 0 20 0 "
+			  "1 0 %3 1000 100")
+			  .arg(pid)
+			  .arg(name)
+			  .arg(startTime));
+	writeFile(dir + "/comm", name + "\n");
+	QFile::link(path, dir + "/exe");
+}
+
+static void removeProcess(const QTemporaryDir &procDir, long pid)
+{
+	QDir(procDir.filePath(QString::number(pid))).removeRecursively();
+}
+
+TEST_CASE("Processes are listed", "[process-table]")
+{
+	QTemporaryDir procDir;
+	addProcess(procDir, 1, "init", "/sbin/init", 1);
+	addProcess(procDir, 42, "obs", "/usr/bin/obs", 100);
+	addProcess(procDir, 43, "obs", "/opt/obs/bin/obs", 110);
+	QDir().mkpath(procDir.filePath("self"));
+
+	ProcessTable table(procDir.path().toStdString());
+	table.Update();
+
+	auto names = table.GetNames();
+	std::sort(names.begin(), names.end());
+	REQUIRE(names == std::vector<std::string>{"init", "obs"});
+
+	auto pids = table.GetPids("obs");
+	std::sort(pids.begin(), pids.end());
+	REQUIRE(pids == std::vector<long>{42, 43});
+	REQUIRE(table.GetPids("unknown").empty());
+
+	REQUIRE(table.GetName(42) == "obs");
+	REQUIRE(table.GetPath(42) == "/usr/bin/obs");
+	REQUIRE(table.GetPath(43) == "/opt/obs/bin/obs");
+	REQUIRE(table.GetName(7).empty());
+	REQUIRE(table.GetReadCount() == 3);
+}
+
+TEST_CASE("Only new processes are read", "[process-table]")
+{
+	QTemporaryDir procDir;
+	addProcess(procDir, 1, "init", "/sbin/init", 1);
+	addProcess(procDir, 42, "obs", "/usr/bin/obs", 100);
+
+	ProcessTable table(procDir.path().toStdString());
+	table.Update();
+	REQUIRE(table.GetReadCount() == 2);
+
+	table.Update();
+	REQUIRE(table.GetReadCount() == 2);
+
+	addProcess(procDir, 50, "game", "/usr/bin/game", 200);
+	table.Update();
+	REQUIRE(table.GetReadCount() == 3);
+	REQUIRE(table.GetName(50) == "game");
+}
+
+TEST_CASE("Exited processes are removed", "[process-table]")
+{
+	QTemporaryDir procDir;
+	addProcess(procDir, 42, "obs", "/usr/bin/obs", 100);
+	addProcess(procDir, 50, "game", "/usr/bin/game", 200);
+
+	ProcessTable table(procDir.path().toStdString());
+	table.Update();
+	REQUIRE(table.GetPids("game") == std::vector<long>{50});
+
+	removeProcess(procDir, 50);
+	table.Update();
+	REQUIRE(table.GetPids("game").empty());
+	REQUIRE(table.GetName(50).empty());
+	REQUIRE(table.GetNames() == std::vector<std::string>{"obs"});
+}
+
+TEST_CASE("Reused pids are detected", "[process-table]")
+{
+	QTemporaryDir procDir;
+	addProcess(procDir, 50, "game", "/usr/bin/game", 200);
+
+	ProcessTable table(procDir.path().toStdString());
+	table.Update();
+	REQUIRE(table.GetName(50) == "game");
+
+	// Create the new entry before removing the old one to make sure it
+	// does not end up with the same inode
+	addProcess(procDir, 50, "editor", "/usr/bin/editor", 300, "tmp");
+	removeProcess(procDir, 50);
+	QDir(procDir.path()).rename("tmp", "50");
+
+	table.Update();
+	REQUIRE(table.GetReadCount() == 2);
+	REQUIRE(table.GetName(50) == "editor");
+	REQUIRE(table.GetPath(50) == "/usr/bin/editor");
+	REQUIRE(table.GetPids("game").empty());
+	REQUIRE(table.GetPids("editor") == std::vector<long>{50});
+}
+
+TEST_CASE("Process table benchmark", "[process-table][.benchmark]")
+{
+	QTemporaryDir procDir;
+	constexpr long processCount = 1000;
+	for (long pid = 1; pid <= processCount; pid++) {
+		addProcess(procDir, pid, QString("proc%1").arg(pid % 100),
+			   QString("/usr/bin/proc%1").arg(pid % 100), pid);
+	}
+
+	BENCHMARK("Full scan")
+	{
+		ProcessTable table(procDir.path().toStdString());
+		table.Update();
+		return table.GetPids("proc42").size();
+	};
+
+	ProcessTable table(procDir.path().toStdString());
+	table.Update();
+	BENCHMARK("Incremental scan")
+	{
+		table.Update();
+		return table.GetPids("proc42").size();
+	};
+}
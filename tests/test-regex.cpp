@@ -80,3 +80,62 @@ TEST_CASE("Matches (PartialMatchRegexConfig)", "[regex-config]")
 	result = regex.Matches(std::string("abc"), "a");
 	REQUIRE(result == true);
 }
+
+TEST_CASE("Matches (cached expression)", "[regex-config]")
+{
+	advss::RegexConfig regex(true);
+	REQUIRE(regex.Matches(std::string("abc"), "a.c"));
+	REQUIRE_FALSE(regex.Matches(std::string("abc"), "a.d"));
+	REQUIRE(regex.Matches(QString("abc"), QString("a.c")));
+	REQUIRE_FALSE(regex.Matches(std::string("ABC"), "a.c"));
+
+	regex.SetPatternOptions(QRegularExpression::CaseInsensitiveOption);
+	REQUIRE(regex.Matches(std::string("ABC"), "a.c"));
+	REQUIRE(regex.Matches(std::string("ABC"), "abc"));
+
+	auto copy = regex;
+	copy.SetPatternOptions(QRegularExpression::NoPatternOption);
+	REQUIRE_FALSE(copy.Matches(std::string("ABC"), "abc"));
+	REQUIRE(regex.Matches(std::string("ABC"), "abc"));
+
+	REQUIRE(regex.GetRegularExpression(std::string("a")).pattern() ==
+		QRegularExpression::anchoredPattern("a"));
+}
+
+TEST_CASE("Matches (literal expression)", "[regex-config]")
+{
+	advss::RegexConfig regex(true);
+	REQUIRE(regex.Matches(std::string("äbc"), "äbc"));
+	REQUIRE_FALSE(regex.Matches(std::string("äbcd"), "äbc"));
+	REQUIRE_FALSE(regex.Matches(std::string("äbc"), "bc"));
+
+	regex = advss::RegexConfig::PartialMatchRegexConfig(true);
+	REQUIRE(regex.Matches(std::string("äbcd"), "bc"));
+	REQUIRE_FALSE(regex.Matches(std::string("äbcd"), "cb"));
+
+	regex.SetPatternOptions(QRegularExpression::CaseInsensitiveOption);
+	REQUIRE(regex.Matches(std::string("äBCD"), "bc"));
+}
+
+TEST_CASE("Matches benchmark", "[regex-config][.benchmark]")
+{
+	const std::string text =
+		"Some window title - Some application (version 1.2.3)";
+	const std::string expression = ".*application \\(version [0-9.]+\\)";
+	advss::RegexConfig regex(true);
+
+	BENCHMARK("Uncached")
+	{
+		return advss::RegexConfig(true).Matches(text, expression);
+	};
+
+	BENCHMARK("Cached")
+	{
+		return regex.Matches(text, expression);
+	};
+
+	BENCHMARK("Cached literal")
+	{
+		return regex.Matches(text, text);
+	};
+}
@@ -0,0 +1,141 @@
+#include "catch.hpp"
+
+#include <thread-pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Submitted tasks are executed", "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 4);
+	std::atomic_int counter = 0;
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 100; i++) {
+		futures.emplace_back(pool.Submit([&counter]() { counter++; }));
+	}
+	for (auto &future : futures) {
+		future.wait();
+	}
+	REQUIRE(counter == 100);
+
+	const auto stats = pool.GetStats();
+	REQUIRE(stats.threadCount == 4);
+	REQUIRE(stats.queued == 0);
+	REQUIRE(stats.executed == 100);
+}
+
+TEST_CASE("Thread count", "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 2);
+	REQUIRE(pool.GetThreadCount() == 2);
+
+	pool.SetThreadCount(3);
+	REQUIRE(pool.GetThreadCount() == 3);
+
+	pool.SetThreadCount(0);
+	REQUIRE(pool.GetThreadCount() == 2);
+
+	advss::ThreadPool defaultPool("test");
+	REQUIRE(defaultPool.GetThreadCount() ==
+		advss::ThreadPool::GetDefaultThreadCount());
+}
+
+TEST_CASE("Pending tasks complete when thread count changes", "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 1);
+	std::atomic_int counter = 0;
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 10; i++) {
+		futures.emplace_back(pool.Submit([&counter]() {
+			std::this_thread::sleep_for(
+				std::chrono::milliseconds(1));
+			counter++;
+		}));
+	}
+	pool.SetThreadCount(2);
+	REQUIRE(pool.GetThreadCount() == 2);
+	for (auto &future : futures) {
+		future.wait();
+	}
+	REQUIRE(counter == 10);
+}
+
+TEST_CASE("Changing the thread count does not wait for running tasks",
+	  "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 1);
+
+	std::promise<void> release;
+	auto blocked = release.get_future().share();
+	auto blockingTask = pool.Submit([&pool, blocked]() {
+		blocked.wait();
+		// Tasks must still be able to submit tasks after the pool
+		// was resized
+		pool.Submit([]() {}).wait();
+	});
+	while (pool.GetStats().running == 0) {
+		std::this_thread::yield();
+	}
+
+	pool.SetThreadCount(2);
+	REQUIRE(pool.GetThreadCount() == 2);
+	REQUIRE(blockingTask.wait_for(std::chrono::seconds(0)) ==
+		std::future_status::timeout);
+
+	// The new workers are available right away
+	pool.Submit([]() {}).wait();
+
+	pool.SetThreadCount(3);
+	release.set_value();
+	blockingTask.wait();
+	REQUIRE(pool.GetStats().queued == 0);
+}
+
+TEST_CASE("Tasks are rejected if the queue is full", "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 1, 1);
+
+	std::promise<void> release;
+	auto blocked = release.get_future().share();
+	auto blockingTask = pool.Submit([blocked]() { blocked.wait(); });
+	// Wait for the worker to pick up the blocking task
+	while (pool.GetStats().running == 0) {
+		std::this_thread::yield();
+	}
+
+	auto queuedTask = pool.Submit([]() {});
+	REQUIRE(queuedTask.valid());
+	auto rejectedTask = pool.Submit([]() {});
+	REQUIRE_FALSE(rejectedTask.valid());
+	REQUIRE(pool.GetStats().rejected == 1);
+
+	release.set_value();
+	blockingTask.wait();
+	queuedTask.wait();
+}
+
+TEST_CASE("Idle workers steal tasks", "[thread-pool]")
+{
+	advss::ThreadPool pool("test", 2);
+
+	// Block one of the workers so its queued tasks can only be completed
+	// by the other worker
+	std::promise<void> release;
+	auto blocked = release.get_future().share();
+	auto blockingTask = pool.Submit([blocked]() { blocked.wait(); });
+
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 10; i++) {
+		futures.emplace_back(pool.Submit([]() {}));
+	}
+	for (auto &future : futures) {
+		future.wait();
+	}
+	REQUIRE(pool.GetStats().stolen > 0);
+
+	release.set_value();
+	blockingTask.wait();
+}
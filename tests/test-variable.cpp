@@ -1,6 +1,9 @@
 #include "catch.hpp"
 
+#include <utility.hpp>
 #include <variable.hpp>
+#include <variable-string.hpp>
+#include <obs.hpp>
 #include <thread>
 
 TEST_CASE("Variable", "[variable]")
@@ -50,3 +53,233 @@ TEST_CASE("Variable", "[variable]")
 	variable.SetValue(123);
 	REQUIRE(*variable.GetSecondsSinceLastChange() > 0);
 }
+
+static std::shared_ptr<advss::Item> createVariable(const std::string &name)
+{
+	auto variable = advss::Variable::Create();
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "name", name.c_str());
+	variable->Load(data);
+	return variable;
+}
+
+TEST_CASE("Variable lookup by name", "[variable]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+	REQUIRE(advss::GetVariableByName("a") == nullptr);
+
+	auto a = createVariable("a");
+	auto b = createVariable("b");
+	variables.emplace_back(a);
+	variables.emplace_back(b);
+	REQUIRE(advss::GetVariableByName("a") == a.get());
+	REQUIRE(advss::GetWeakVariableByName("b").lock() == b);
+	REQUIRE(advss::GetVariableByName("c") == nullptr);
+
+	// Appended
+	auto c = createVariable("c");
+	variables.emplace_back(c);
+	REQUIRE(advss::GetVariableByName("c") == c.get());
+
+	// Renamed
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "name", "renamed");
+	b->Load(data);
+	advss::VariableSignalManager::Instance()->Rename("b", "renamed");
+	REQUIRE(advss::GetVariableByName("renamed") == b.get());
+	REQUIRE(advss::GetVariableByName("b") == nullptr);
+
+	// Removed
+	advss::RemoveItemsByName(variables, {"a"});
+	REQUIRE(advss::GetVariableByName("a") == nullptr);
+	REQUIRE(advss::GetVariableByName("renamed") == b.get());
+	REQUIRE(advss::GetVariableByName("c") == c.get());
+
+	// Replaced without changing the size of the list
+	variables.pop_back();
+	auto d = createVariable("d");
+	variables.emplace_back(d);
+	REQUIRE(advss::GetVariableByName("c") == nullptr);
+	REQUIRE(advss::GetVariableByName("d") == d.get());
+
+	variables.clear();
+	REQUIRE(advss::GetVariableByName("d") == nullptr);
+}
+
+TEST_CASE("Variable substitution", "[variable]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+
+	auto a = createVariable("a");
+	auto b = createVariable("b}c");
+	std::static_pointer_cast<advss::Variable>(a)->SetValue("1");
+	std::static_pointer_cast<advss::Variable>(b)->SetValue("${a}");
+	variables.emplace_back(a);
+	variables.emplace_back(b);
+
+	REQUIRE(advss::SubstitueVariables("") == "");
+	REQUIRE(advss::SubstitueVariables("no variables") == "no variables");
+	REQUIRE(advss::SubstitueVariables("${a}") == "1");
+	REQUIRE(advss::SubstitueVariables("x${a}y${a}z") == "x1y1z");
+	REQUIRE(advss::SubstitueVariables("${unknown} ${a}") ==
+		"${unknown} 1");
+	REQUIRE(advss::SubstitueVariables("${a ${a}") == "${a 1");
+	REQUIRE(advss::SubstitueVariables("{${a}}") == "{1}");
+
+	// Variable names can contain closing braces
+	REQUIRE(advss::SubstitueVariables("${b}c}") == "${a}");
+	REQUIRE(advss::SubstitueVariables("${b}c}${a}") == "${a}1");
+
+	advss::StringVariable str = "value: ${a}";
+	REQUIRE(std::string(str) == "value: 1");
+	std::static_pointer_cast<advss::Variable>(a)->SetValue("2");
+	REQUIRE(std::string(str) == "value: 2");
+	str = "${a}${a}";
+	REQUIRE(std::string(str) == "22");
+
+	variables.clear();
+}
+
+TEST_CASE("Variable dependency tracking", "[variable]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+
+	auto a = std::static_pointer_cast<advss::Variable>(createVariable("a"));
+	auto b = std::static_pointer_cast<advss::Variable>(createVariable("b"));
+	variables.emplace_back(a);
+	variables.emplace_back(b);
+	a->SetValue("1");
+	b->SetValue("1");
+
+	const auto version = a->GetVersion();
+	a->SetValue("1");
+	REQUIRE(a->GetVersion() == version);
+	a->SetValue("2");
+	REQUIRE(a->GetVersion() != version);
+
+	advss::StringVariable str = "${a} ${c}";
+	REQUIRE(std::string(str) == "2 ${c}");
+	b->SetValue("2");
+	REQUIRE(std::string(str) == "2 ${c}");
+	a->SetValue("3");
+	REQUIRE(std::string(str) == "3 ${c}");
+
+	// Adding a variable resolves previously unknown references
+	auto c = std::static_pointer_cast<advss::Variable>(createVariable("c"));
+	c->SetValue("4");
+	variables.emplace_back(c);
+	REQUIRE(std::string(str) == "3 4");
+
+	// Values of an active variable context are not cached
+	auto context = advss::CreateVariableContext();
+	context["a"] = "5";
+	advss::SetActiveVariableContext(&context);
+	REQUIRE(std::string(str) == "5 4");
+	advss::SetActiveVariableContext(nullptr);
+	REQUIRE(std::string(str) == "3 4");
+
+	variables.clear();
+}
+
+TEST_CASE("Variable dependency tracking benchmark", "[variable][.benchmark]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+
+	const int variableCount = 1000;
+	for (int i = 0; i < variableCount; i++) {
+		variables.emplace_back(
+			createVariable("var" + std::to_string(i)));
+	}
+	auto counter = std::static_pointer_cast<advss::Variable>(
+		createVariable("counter"));
+	variables.emplace_back(counter);
+
+	std::vector<advss::StringVariable> strings;
+	for (int i = 0; i < variableCount; i++) {
+		strings.emplace_back("value: ${var" + std::to_string(i) + "}");
+	}
+	strings.emplace_back("counter: ${counter}");
+
+	int count = 0;
+	BENCHMARK("Resolve strings while one variable changes")
+	{
+		counter->SetValue(++count);
+		size_t length = 0;
+		for (const auto &str : strings) {
+			length += std::string(str).size();
+		}
+		return length;
+	};
+
+	variables.clear();
+}
+
+// Previous implementation searching the text once for each variable, which
+// is kept as the baseline for the benchmark below
+static std::string substituteVariablesOneByOne(std::string str)
+{
+	for (const auto &v : advss::GetVariables()) {
+		const auto &variable =
+			std::dynamic_pointer_cast<advss::Variable>(v);
+		const std::string pattern = "${" + variable->Name() + "}";
+		if (advss::ReplaceAll(str, pattern, variable->Value(false))) {
+			variable->MarkAsUsed();
+		}
+	}
+	return str;
+}
+
+TEST_CASE("Variable substitution benchmark", "[variable][.benchmark]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+
+	const int variableCount = 10000;
+	for (int i = 0; i < variableCount; i++) {
+		auto variable = createVariable("var" + std::to_string(i));
+		std::static_pointer_cast<advss::Variable>(variable)->SetValue(
+			std::to_string(i));
+		variables.emplace_back(variable);
+	}
+
+	std::string text;
+	for (int i = 0; text.size() < 4096; i += 97) {
+		text += "some text ${var" + std::to_string(i % variableCount) +
+			"} ";
+	}
+	advss::StringVariable str = text;
+	REQUIRE(advss::SubstitueVariables(text) ==
+		substituteVariablesOneByOne(text));
+
+	BENCHMARK("Substitute each variable one by one")
+	{
+		return substituteVariablesOneByOne(text);
+	};
+
+	BENCHMARK("SubstitueVariables")
+	{
+		return advss::SubstitueVariables(text);
+	};
+
+	// Referenced by the text, so its version changes with each value change
+	auto var0 =
+		std::static_pointer_cast<advss::Variable>(variables.front());
+	int count = 0;
+	BENCHMARK("StringVariable with changing variable value")
+	{
+		// Force the value to be resolved again
+		var0->SetValue(++count % 2 ? "1" : "0");
+		return std::string(str);
+	};
+
+	BENCHMARK("StringVariable with unchanged variable values")
+	{
+		return std::string(str);
+	};
+
+	variables.clear();
+}
@@ -0,0 +1,201 @@
+#include "catch.hpp"
+#include "x11-window-tracker.hpp"
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+#include <algorithm>
+
+using advss::X11WindowTracker;
+
+static int ignoreXerror(Display *, XErrorEvent *)
+{
+	return 0;
+}
+
+// Emulates the parts of an EWMH compliant window manager relevant for the
+// window tracker, so the tests can run against a plain X server like Xvfb
+class FakeWindowManager {
+public:
+	FakeWindowManager() : _display(XOpenDisplay(nullptr))
+	{
+		if (!_display) {
+			return;
+		}
+		_root = DefaultRootWindow(_display);
+		const Atom wmCheck = Intern("_NET_SUPPORTING_WM_CHECK");
+		_wmCheckWindow = CreateWindow("");
+		SetWindowProperty(_root, wmCheck, _wmCheckWindow);
+		SetWindowProperty(_wmCheckWindow, wmCheck, _wmCheckWindow);
+		Sync();
+	}
+
+	~FakeWindowManager()
+	{
+		if (!_display) {
+			return;
+		}
+		XDeleteProperty(_display, _root,
+				Intern("_NET_SUPPORTING_WM_CHECK"));
+		XDeleteProperty(_display, _root, Intern("_NET_CLIENT_LIST"));
+		XDeleteProperty(_display, _root, Intern("_NET_ACTIVE_WINDOW"));
+		XCloseDisplay(_display);
+	}
+
+	bool IsValid() const { return _display != nullptr; }
+
+	Window CreateWindow(const char *title)
+	{
+		Window window = XCreateSimpleWindow(_display, _root, 10, 20,
+						    300, 200, 0, 0, 0);
+		XStoreName(_display, window, title);
+		return window;
+	}
+
+	void SetClients(const std::vector<Window> &clients)
+	{
+		XChangeProperty(_display, _root, Intern("_NET_CLIENT_LIST"),
+				XA_WINDOW, 32, PropModeReplace,
+				(const unsigned char *)clients.data(),
+				(int)clients.size());
+		Sync();
+	}
+
+	void SetActive(Window window)
+	{
+		SetWindowProperty(_root, Intern("_NET_ACTIVE_WINDOW"), window);
+		Sync();
+	}
+
+	void SetTitle(Window window, const char *title)
+	{
+		XStoreName(_display, window, title);
+		Sync();
+	}
+
+	void SetFullscreen(Window window)
+	{
+		Atom state = Intern("_NET_WM_STATE_FULLSCREEN");
+		XChangeProperty(_display, window, Intern("_NET_WM_STATE"),
+				XA_ATOM, 32, PropModeReplace,
+				(const unsigned char *)&state, 1);
+		Sync();
+	}
+
+	void Sync() { XSync(_display, false); }
+
+private:
+	Atom Intern(const char *name)
+	{
+		return XInternAtom(_display, name, false);
+	}
+
+	void SetWindowProperty(Window window, Atom property, Window value)
+	{
+		XChangeProperty(_display, window, property, XA_WINDOW, 32,
+				PropModeReplace, (const unsigned char *)&value,
+				1);
+	}
+
+	Display *_display = nullptr;
+	Window _root = 0;
+	Window _wmCheckWindow = 0;
+};
+
+static std::vector<std::string>
+getTitles(const std::vector<advss::WindowInfo> &windows)
+{
+	std::vector<std::string> titles;
+	for (const auto &window : windows) {
+		titles.emplace_back(window.title);
+	}
+	std::sort(titles.begin(), titles.end());
+	return titles;
+}
+
+TEST_CASE("Window list follows the client list", "[x11-window-tracker]")
+{
+	XSetErrorHandler(ignoreXerror);
+	FakeWindowManager wm;
+	if (!wm.IsValid()) {
+		WARN("No X server available - skipping");
+		return;
+	}
+
+	const auto first = wm.CreateWindow("first");
+	const auto second = wm.CreateWindow("second");
+	wm.SetClients({first, second});
+
+	X11WindowTracker tracker;
+	REQUIRE(tracker.IsValid());
+	REQUIRE(getTitles(tracker.GetWindows({})) ==
+		std::vector<std::string>{"first", "second"});
+
+	wm.SetClients({second});
+	REQUIRE(getTitles(tracker.GetWindows({})) ==
+		std::vector<std::string>{"second"});
+}
+
+TEST_CASE("Window changes are picked up", "[x11-window-tracker]")
+{
+	XSetErrorHandler(ignoreXerror);
+	FakeWindowManager wm;
+	if (!wm.IsValid()) {
+		WARN("No X server available - skipping");
+		return;
+	}
+
+	const auto window = wm.CreateWindow("title");
+	wm.SetClients({window});
+	wm.SetActive(window);
+
+	X11WindowTracker tracker;
+	advss::WindowQueryOptions options;
+	options.fullscreen = true;
+	options.geometry = true;
+
+	auto windows = tracker.GetWindows(options);
+	REQUIRE(windows.size() == 1);
+	REQUIRE_FALSE(windows[0].fullscreen);
+	REQUIRE(windows[0].width == 300);
+	REQUIRE(windows[0].height == 200);
+	REQUIRE(tracker.GetActiveWindowTitle() == "title");
+
+	wm.SetTitle(window, "new title");
+	wm.SetFullscreen(window);
+	windows = tracker.GetWindows(options);
+	REQUIRE(windows.size() == 1);
+	REQUIRE(windows[0].title == "new title");
+	REQUIRE(windows[0].fullscreen);
+	REQUIRE(tracker.GetActiveWindowTitle() == "new title");
+
+	wm.SetActive(0);
+	REQUIRE(tracker.GetActiveWindowTitle().empty());
+}
+
+TEST_CASE("No requests are sent if nothing changed", "[x11-window-tracker]")
+{
+	XSetErrorHandler(ignoreXerror);
+	FakeWindowManager wm;
+	if (!wm.IsValid()) {
+		WARN("No X server available - skipping");
+		return;
+	}
+
+	const auto window = wm.CreateWindow("title");
+	wm.SetClients({window});
+	wm.SetActive(window);
+
+	X11WindowTracker tracker;
+	advss::WindowQueryOptions options;
+	options.fullscreen = true;
+	options.maximized = true;
+	options.geometry = true;
+	tracker.GetWindows(options);
+	tracker.GetActiveWindowTitle();
+
+	const auto serial = tracker.GetRequestSerial();
+	tracker.GetWindows(options);
+	tracker.GetActiveWindowTitle();
+	REQUIRE(tracker.GetRequestSerial() == serial);
+}